@@ -25,8 +25,10 @@ in the source distribution for its full text.
 #include "IncSet.h"
 #include "InfoScreen.h"
 #include "ListItem.h"
+#include "Machine.h"
 #include "Macros.h"
 #include "MainPanel.h"
+#include "Meter.h"
 #include "OpenFilesScreen.h"
 #include "Process.h"
 #include "ProcessLocksScreen.h"
@@ -232,12 +234,62 @@ static Htop_Reaction actionSortByTime(State* st) {
    return Action_setSortKey(st->host->settings, TIME);
 }
 
+static Htop_Reaction actionSetGroupKey(State* st) {
+   Machine* host = st->host;
+   Table* table = host->activeTable;
+   ScreenSettings* ss = host->settings->ss;
+
+   /* offer the fields the rows of this table can be grouped by */
+   const Row* probe = Vector_size(table->rows) ? (const Row*) Vector_get(table->rows, 0) : NULL;
+   if (!probe || !As_Row(probe)->newGroup) {
+      beep();
+      return HTOP_OK;
+   }
+
+   Panel* groupPanel = Panel_new(0, 0, 0, 0, Class(ListItem), true, FunctionBar_newEnterEsc("Group  ", "Cancel "));
+   Panel_setHeader(groupPanel, "Group by");
+   Panel_add(groupPanel, (Object*) ListItem_new("(none)", NULL_FIELD));
+   for (RowField field = 1; field < LAST_PROCESSFIELD; field++) {
+      char key[256];
+      if (!Process_fields[field].name || !Row_groupKey(probe, field, key, sizeof(key)))
+         continue;
+
+      char* name = String_trim(Process_fields[field].name);
+      Panel_add(groupPanel, (Object*) ListItem_new(name, field));
+      if (field == ss->groupKey)
+         Panel_setSelected(groupPanel, Panel_size(groupPanel) - 1);
+      free(name);
+   }
+
+   Htop_Reaction reaction = HTOP_OK;
+   const ListItem* field = (const ListItem*) Action_pickFromVector(st, groupPanel, 14, false);
+   if (field) {
+      ss->groupKey = field->key;
+      if (ss->groupKey) {
+         ss->treeView = false;
+         if (ss->groupKey < LAST_PROCESSFIELD)
+            ss->flags |= Process_fields[ss->groupKey].flags;
+      }
+      table->needsSort = true;
+      reaction = HTOP_RECALCULATE | HTOP_SAVE_SETTINGS | HTOP_REDRAW_BAR;
+   }
+   Object_delete(groupPanel);
+
+   return reaction | HTOP_REFRESH | HTOP_UPDATE_PANELHDR | HTOP_KEEP_FOLLOWING;
+}
+
+static void Action_rescanTables(Machine* host) {
+   // a background scan may be halfway, the rescan requested by HTOP_RECALCULATE picks the change up
+   if (!host->scanThread)
+      Machine_scanTables(host);
+}
+
 static Htop_Reaction actionToggleKernelThreads(State* st) {
    Settings* settings = st->host->settings;
    settings->hideKernelThreads = !settings->hideKernelThreads;
    settings->lastUpdate++;
 
-   Machine_scanTables(st->host); // needed to not have a visible delay showing wrong data
+   Action_rescanTables(st->host); // needed to not have a visible delay showing wrong data
 
    return HTOP_RECALCULATE | HTOP_SAVE_SETTINGS | HTOP_KEEP_FOLLOWING;
 }
@@ -247,7 +299,7 @@ static Htop_Reaction actionToggleUserlandThreads(State* st) {
    settings->hideUserlandThreads = !settings->hideUserlandThreads;
    settings->lastUpdate++;
 
-   Machine_scanTables(st->host); // needed to not have a visible delay showing wrong data
+   Action_rescanTables(st->host); // needed to not have a visible delay showing wrong data
 
    return HTOP_RECALCULATE | HTOP_SAVE_SETTINGS | HTOP_KEEP_FOLLOWING;
 }
@@ -280,6 +332,8 @@ static Htop_Reaction actionToggleTreeView(State* st) {
    Machine* host = st->host;
    ScreenSettings* ss = host->settings->ss;
    ss->treeView = !ss->treeView;
+   if (ss->treeView)
+      ss->groupKey = NULL_FIELD;
 
    if (!ss->allBranchesCollapsed)
       Table_expandTree(host->activeTable);
@@ -294,6 +348,11 @@ static Htop_Reaction actionToggleHideMeters(State* st) {
    return HTOP_RESIZE | HTOP_KEEP_FOLLOWING;
 }
 
+static Htop_Reaction actionCycleGraphZoom(ATTR_UNUSED State* st) {
+   Meter_cycleGraphZoom();
+   return HTOP_REFRESH | HTOP_KEEP_FOLLOWING;
+}
+
 static Htop_Reaction actionExpandOrCollapseAllBranches(State* st) {
    Machine* host = st->host;
    ScreenSettings* ss = host->settings->ss;
@@ -346,7 +405,8 @@ static Htop_Reaction actionInvertSortOrder(State* st) {
 }
 
 static Htop_Reaction actionExpandOrCollapse(State* st) {
-   if (!st->host->settings->ss->treeView)
+   const ScreenSettings* ss = st->host->settings->ss;
+   if (!ss->treeView && !ss->groupKey)
       return HTOP_OK;
 
    bool changed = expandCollapse((Panel*)st->mainPanel);
@@ -362,7 +422,8 @@ static Htop_Reaction actionCollapseIntoParent(State* st) {
 }
 
 static Htop_Reaction actionExpandCollapseOrSortColumn(State* st) {
-   return st->host->settings->ss->treeView ? actionExpandOrCollapse(st) : actionSetSortColumn(st);
+   const ScreenSettings* ss = st->host->settings->ss;
+   return (ss->treeView || ss->groupKey) ? actionExpandOrCollapse(st) : actionSetSortColumn(st);
 }
 
 static inline void setActiveScreen(Settings* settings, State* st, unsigned int ssIdx) {
@@ -373,6 +434,13 @@ static inline void setActiveScreen(Settings* settings, State* st, unsigned int s
    if (!settings->ss->table)
       settings->ss->table = host->processTable;
    host->activeTable = settings->ss->table;
+   /* screens sharing a table may sort, nest or group its rows differently */
+   host->activeTable->needsSort = true;
+
+   /* screens added in Setup may bring a table not scanned so far */
+   if (!host->activeTable->panel)
+      Table_setPanel(host->activeTable, (Panel*) st->mainPanel);
+   Machine_addTable(host, host->activeTable);
 
    // set correct functionBar - readonly if requested, and/or with non-process screens
    bool readonly = Settings_isReadonly() || (host->activeTable != host->processTable);
@@ -433,7 +501,7 @@ static Htop_Reaction actionSetAffinity(State* st) {
 
 #if (defined(HAVE_LIBHWLOC) || defined(HAVE_AFFINITY))
    const Row* row = (const Row*) Panel_getSelected((Panel*)st->mainPanel);
-   if (!row)
+   if (!row || Row_isGroup(row))
       return HTOP_OK;
 
    Affinity* affinity1 = Affinity_rowGet(row, host);
@@ -564,7 +632,7 @@ static Htop_Reaction actionLsof(State* st) {
       return HTOP_OK;
 
    const Process* p = (Process*) Panel_getSelected((Panel*)st->mainPanel);
-   if (!p)
+   if (!p || Row_isGroup(&p->super))
       return HTOP_OK;
 
    assert(Object_isA((const Object*) p, (const ObjectClass*) &Process_class));
@@ -582,7 +650,7 @@ static Htop_Reaction actionShowLocks(State* st) {
       return HTOP_OK;
 
    const Process* p = (Process*) Panel_getSelected((Panel*)st->mainPanel);
-   if (!p)
+   if (!p || Row_isGroup(&p->super))
       return HTOP_OK;
 
    assert(Object_isA((const Object*) p, (const ObjectClass*) &Process_class));
@@ -600,7 +668,7 @@ static Htop_Reaction actionStrace(State* st) {
       return HTOP_OK;
 
    const Process* p = (Process*) Panel_getSelected((Panel*)st->mainPanel);
-   if (!p)
+   if (!p || Row_isGroup(&p->super))
       return HTOP_OK;
 
    assert(Object_isA((const Object*) p, (const ObjectClass*) &Process_class));
@@ -621,7 +689,9 @@ static Htop_Reaction actionTag(State* st) {
    if (!r)
       return HTOP_OK;
 
-   Row_toggleTag(r);
+   /* group rows are no processes to act on, their members are */
+   if (!Row_isGroup(r))
+      Row_toggleTag(r);
    Panel_onKey((Panel*)st->mainPanel, KEY_DOWN);
    return HTOP_OK;
 }
@@ -643,6 +713,7 @@ static const struct {
    const char* info;
 } helpLeft[] = {
    { .key = "      #: ",  .roInactive = false, .info = "hide/show header meters" },
+   { .key = "      g: ",  .roInactive = false, .info = "zoom graph meters: live/1s/10s/1m" },
    { .key = "    Tab: ",  .roInactive = false, .info = "switch to next screen tab" },
    { .key = " Arrows: ",  .roInactive = false, .info = "scroll process list" },
    { .key = " Digits: ",  .roInactive = false, .info = "incremental PID search" },
@@ -658,6 +729,7 @@ static const struct {
    { .key = "      O: ",  .roInactive = false, .info = "hide/show processes in containers" },
    { .key = "      F: ",  .roInactive = false, .info = "cursor follows process" },
    { .key = "  + - *: ",  .roInactive = false, .info = "expand/collapse tree/toggle all" },
+   { .key = "      G: ",  .roInactive = false, .info = "group by user, program, cgroup..." },
    { .key = "N P M T: ",  .roInactive = false, .info = "sort by PID, CPU%, MEM% or TIME" },
    { .key = "      I: ",  .roInactive = false, .info = "invert sort order" },
    { .key = " F6 > .: ",  .roInactive = false, .info = "select sort column" },
@@ -856,7 +928,7 @@ static Htop_Reaction actionShowEnvScreen(State* st) {
       return HTOP_OK;
 
    Process* p = (Process*) Panel_getSelected((Panel*)st->mainPanel);
-   if (!p)
+   if (!p || Row_isGroup(&p->super))
       return HTOP_OK;
 
    assert(Object_isA((const Object*) p, (const ObjectClass*) &Process_class));
@@ -874,7 +946,7 @@ static Htop_Reaction actionShowCommandScreen(State* st) {
       return HTOP_OK;
 
    Process* p = (Process*) Panel_getSelected((Panel*)st->mainPanel);
-   if (!p)
+   if (!p || Row_isGroup(&p->super))
       return HTOP_OK;
 
    assert(Object_isA((const Object*) p, (const ObjectClass*) &Process_class));
@@ -902,6 +974,7 @@ void Action_setBindings(Htop_Action* keys) {
    keys['?'] = actionHelp;
    keys['C'] = actionSetup;
    keys['F'] = Action_follow;
+   keys['G'] = actionSetGroupKey;
    keys['H'] = actionToggleUserlandThreads;
    keys['I'] = actionInvertSortOrder;
    keys['K'] = actionToggleKernelThreads;
@@ -924,6 +997,7 @@ void Action_setBindings(Htop_Action* keys) {
    keys['a'] = actionSetAffinity;
    keys['c'] = actionTagAllChildren;
    keys['e'] = actionShowEnvScreen;
+   keys['g'] = actionCycleGraphZoom;
    keys['h'] = actionHelp;
    keys['k'] = actionKill;
    keys['l'] = actionLsof;
@@ -10,6 +10,7 @@ in the source distribution for its full text.
 #include "CPUMeter.h"
 
 #include <assert.h>
+#include <math.h>
 #include <stdbool.h>
 #include <stddef.h>
 #include <stdlib.h>
@@ -231,8 +232,10 @@ static void AllCPUsMeter_updateValues(Meter* this) {
    Meter** meters = data->meters;
    int start, count;
    AllCPUsMeter_getRange(this, &start, &count);
-   for (int i = 0; i < count; i++)
+   for (int i = 0; i < count; i++) {
       Meter_updateValues(meters[i]);
+      Meter_recordHistory(meters[i]);
+   }
 }
 
 static void CPUMeterCommonInit(Meter* this) {
@@ -340,6 +343,166 @@ static void SingleColCPUsMeter_draw(Meter* this, int x, int y, int w) {
    }
 }
 
+/* CPUs per heatmap row; narrower meters fold neighbouring CPUs into one cell */
+#define CPUHEATMAP_ROW_CELLS 128
+
+typedef struct CPUHeatmapRow_ {
+   unsigned int start;       /* first index into the CPU order */
+   unsigned int count;
+   int group;                /* NUMA node labelling the row, -1 for none */
+} CPUHeatmapRow;
+
+typedef struct CPUHeatmapData_ {
+   unsigned int cpus;        /* CPU count the layout was computed for */
+   unsigned int* order;      /* CPU ids, grouped by NUMA node if known */
+   CPUHeatmapRow* rows;
+   unsigned int rowCount;
+   double* usage;            /* fallback when the platform provides no Machine.cpuUsage */
+   Meter* cpuMeter;          /* used to fill the fallback */
+} CPUHeatmapData;
+
+static void CPUHeatmapMeter_layout(Meter* this) {
+   CPUHeatmapData* data = this->meterData;
+   unsigned int cpus = this->host->existingCPUs;
+
+   data->cpus = cpus;
+   data->order = xReallocArray(data->order, MAXIMUM(cpus, 1U), sizeof(unsigned int));
+   data->rows = xReallocArray(data->rows, MAXIMUM(cpus, 1U), sizeof(CPUHeatmapRow));
+   data->rowCount = 0;
+
+   int* groups = xCalloc(MAXIMUM(cpus, 1U), sizeof(int));
+   int maxGroup = 0;
+
+#ifdef HAVE_LIBHWLOC
+   if (this->host->topologyOk) {
+      for (unsigned int i = 0; i < cpus; i++) {
+         hwloc_obj_t pu = hwloc_get_pu_obj_by_os_index(this->host->topology, i);
+         int node = pu && pu->nodeset ? hwloc_bitmap_first(pu->nodeset) : -1;
+         groups[i] = MAXIMUM(node, 0);
+         maxGroup = MAXIMUM(maxGroup, groups[i]);
+      }
+   }
+#endif
+
+   unsigned int n = 0;
+   for (int group = 0; group <= maxGroup; group++) {
+      unsigned int groupStart = n;
+      for (unsigned int i = 0; i < cpus; i++) {
+         if (groups[i] == group)
+            data->order[n++] = i;
+      }
+
+      for (unsigned int start = groupStart; start < n; start += CPUHEATMAP_ROW_CELLS) {
+         data->rows[data->rowCount++] = (CPUHeatmapRow) {
+            .start = start,
+            .count = MINIMUM(n - start, (unsigned int)CPUHEATMAP_ROW_CELLS),
+            .group = start == groupStart && maxGroup > 0 ? group : -1,
+         };
+      }
+   }
+
+   free(groups);
+
+   data->usage = xReallocArray(data->usage, (size_t)cpus + 1, sizeof(double));
+   for (unsigned int i = 0; i <= cpus; i++)
+      data->usage[i] = NAN;
+}
+
+static void CPUHeatmapMeter_init(Meter* this) {
+   if (!this->meterData) {
+      this->meterData = xCalloc(1, sizeof(CPUHeatmapData));
+      CPUHeatmapMeter_layout(this);
+   }
+}
+
+static void CPUHeatmapMeter_updateMode(Meter* this, MeterModeId mode) {
+   const CPUHeatmapData* data = this->meterData;
+   this->mode = mode;
+   this->h = MAXIMUM(data->rowCount, 1U);
+}
+
+static void CPUHeatmapMeter_updateValues(Meter* this) {
+   CPUHeatmapData* data = this->meterData;
+   const Machine* host = this->host;
+
+   if (data->cpus != host->existingCPUs) {
+      CPUHeatmapMeter_layout(this);
+      this->h = MAXIMUM(data->rowCount, 1U);
+   }
+
+   if (host->cpuUsage)
+      return;
+
+   if (!data->cpuMeter)
+      data->cpuMeter = Meter_new(host, 1, (const MeterClass*) Class(CPUMeter));
+
+   data->usage[0] = Platform_setCPUValues(data->cpuMeter, 0);
+   for (unsigned int i = 0; i < data->cpus; i++)
+      data->usage[i + 1] = Platform_setCPUValues(data->cpuMeter, i + 1);
+}
+
+static void CPUHeatmapMeter_draw(Meter* this, int x, int y, int w) {
+   const CPUHeatmapData* data = this->meterData;
+   const Machine* host = this->host;
+   const double* usage = host->cpuUsage ? host->cpuUsage : data->usage;
+
+   static const char* const asciiCells[] = { ".", ":", "+", "*", "#" };
+   const char* const* cells = asciiCells;
+#ifdef HAVE_LIBNCURSESW
+   static const char* const utf8Cells[] = { "\xc2\xb7", "\xe2\x96\x91", "\xe2\x96\x92", "\xe2\x96\x93", "\xe2\x96\x88" };
+   if (CRT_utf8)
+      cells = utf8Cells;
+#endif
+
+   const int captionLen = 4;
+   int width = w - captionLen;
+   unsigned int fold = width > 0 ? ((unsigned int)CPUHEATMAP_ROW_CELLS + (unsigned int)width - 1) / (unsigned int)width : 1;
+
+   for (unsigned int r = 0; r < data->rowCount && (int)r < this->h; r++) {
+      const CPUHeatmapRow* row = &data->rows[r];
+
+      char caption[8] = "";
+      if (row->group >= 0)
+         xSnprintf(caption, sizeof(caption), "N%d", row->group);
+      else if (r == 0)
+         String_safeStrncpy(caption, Meter_getCaption(this), sizeof(caption));
+
+      attrset(CRT_colors[METER_TEXT]);
+      mvaddnstr(y + (int)r, x, caption, MINIMUM(w, captionLen - 1));
+
+      for (unsigned int c = 0; width > 0 && c * fold < row->count && (int)c < width; c++) {
+         double value = NAN;
+         for (unsigned int k = c * fold; k < (c + 1) * fold && k < row->count; k++) {
+            unsigned int id = data->order[row->start + k];
+            double v = usage[id + 1];
+            if (Machine_isCPUonline(host, id) && !isnan(v) && !(v <= value))
+               value = v;
+         }
+
+         if (isnan(value)) {
+            attrset(CRT_colors[METER_SHADOW]);
+            mvaddstr(y + (int)r, x + captionLen + (int)c, "x");
+            continue;
+         }
+
+         int level = value < 2.0 ? 0 : 1 + MINIMUM((int)(value / 25.0), 3);
+         attrset(CRT_colors[level == 0 ? METER_SHADOW : value >= 90.0 ? CPU_SYSTEM : CPU_NORMAL]);
+         mvaddstr(y + (int)r, x + captionLen + (int)c, cells[level]);
+      }
+   }
+
+   attrset(CRT_colors[RESET_COLOR]);
+}
+
+static void CPUHeatmapMeter_done(Meter* this) {
+   CPUHeatmapData* data = this->meterData;
+   if (data->cpuMeter)
+      Meter_delete((Object*)data->cpuMeter);
+   free(data->usage);
+   free(data->rows);
+   free(data->order);
+   free(data);
+}
 
 const MeterClass CPUMeter_class = {
    .super = {
@@ -622,3 +785,22 @@ const MeterClass RightCPUs8Meter_class = {
    .updateMode = OctoColCPUsMeter_updateMode,
    .done = AllCPUsMeter_done
 };
+
+const MeterClass CPUHeatmapMeter_class = {
+   .super = {
+      .extends = Class(Meter),
+      .delete = Meter_delete
+   },
+   .updateValues = CPUHeatmapMeter_updateValues,
+   .defaultMode = BAR_METERMODE,
+   .supportedModes = (1 << BAR_METERMODE),
+   .total = 100.0,
+   .name = "CPUHeatmap",
+   .uiName = "CPUs (heatmap)",
+   .description = "CPUs (heatmap): one cell per CPU, shaded by its utilization",
+   .caption = "CPU",
+   .draw = CPUHeatmapMeter_draw,
+   .init = CPUHeatmapMeter_init,
+   .updateMode = CPUHeatmapMeter_updateMode,
+   .done = CPUHeatmapMeter_done
+};
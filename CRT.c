@@ -203,6 +203,7 @@ static int CRT_colorSchemes[LAST_COLORSCHEME][LAST_COLORELEMENT] = {
       [GPU_ENGINE_3] = ColorPair(Red, Black),
       [GPU_ENGINE_4] = A_BOLD | ColorPair(Blue, Black),
       [GPU_RESIDUE] = ColorPair(Magenta, Black),
+      [SPU_RESIDUE] = ColorPair(Magenta, Black),
       [PANEL_EDIT] = ColorPair(White, Blue),
       [SCREENS_OTH_BORDER] = ColorPair(Blue, Blue),
       [SCREENS_OTH_TEXT] = ColorPair(Black, Blue),
@@ -321,6 +322,7 @@ static int CRT_colorSchemes[LAST_COLORSCHEME][LAST_COLORELEMENT] = {
       [GPU_ENGINE_3] = A_REVERSE | A_BOLD,
       [GPU_ENGINE_4] = A_REVERSE,
       [GPU_RESIDUE] = A_BOLD,
+      [SPU_RESIDUE] = A_BOLD,
       [PANEL_EDIT] = A_BOLD,
       [SCREENS_OTH_BORDER] = A_DIM,
       [SCREENS_OTH_TEXT] = A_DIM,
@@ -439,6 +441,7 @@ static int CRT_colorSchemes[LAST_COLORSCHEME][LAST_COLORELEMENT] = {
       [GPU_ENGINE_3] = ColorPair(Red, White),
       [GPU_ENGINE_4] = ColorPair(Blue, White),
       [GPU_RESIDUE] = ColorPair(Magenta, White),
+      [SPU_RESIDUE] = ColorPair(Magenta, White),
       [PANEL_EDIT] = ColorPair(White, Blue),
       [SCREENS_OTH_BORDER] = A_BOLD | ColorPair(Black, White),
       [SCREENS_OTH_TEXT] = A_BOLD | ColorPair(Black, White),
@@ -557,6 +560,7 @@ static int CRT_colorSchemes[LAST_COLORSCHEME][LAST_COLORELEMENT] = {
       [GPU_ENGINE_3] = ColorPair(Red, Black),
       [GPU_ENGINE_4] = ColorPair(Blue, Black),
       [GPU_RESIDUE] = ColorPair(Magenta, Black),
+      [SPU_RESIDUE] = ColorPair(Magenta, Black),
       [PANEL_EDIT] = ColorPair(White, Blue),
       [SCREENS_OTH_BORDER] = ColorPair(Blue, Black),
       [SCREENS_OTH_TEXT] = ColorPair(Blue, Black),
@@ -675,6 +679,7 @@ static int CRT_colorSchemes[LAST_COLORSCHEME][LAST_COLORELEMENT] = {
       [GPU_ENGINE_3] = A_BOLD | ColorPair(Red, Blue),
       [GPU_ENGINE_4] = A_BOLD | ColorPair(White, Blue),
       [GPU_RESIDUE] = A_BOLD | ColorPair(Magenta, Blue),
+      [SPU_RESIDUE] = A_BOLD | ColorPair(Magenta, Blue),
       [PANEL_EDIT] = ColorPair(White, Blue),
       [SCREENS_OTH_BORDER] = A_BOLD | ColorPair(Yellow, Blue),
       [SCREENS_OTH_TEXT] = ColorPair(Cyan, Blue),
@@ -791,6 +796,7 @@ static int CRT_colorSchemes[LAST_COLORSCHEME][LAST_COLORELEMENT] = {
       [GPU_ENGINE_3] = ColorPair(Red, Black),
       [GPU_ENGINE_4] = ColorPair(Blue, Black),
       [GPU_RESIDUE] = ColorPair(Magenta, Black),
+      [SPU_RESIDUE] = ColorPair(Magenta, Black),
       [PANEL_EDIT] = ColorPair(White, Cyan),
       [SCREENS_OTH_BORDER] = ColorPair(White, Black),
       [SCREENS_OTH_TEXT] = ColorPair(Cyan, Black),
@@ -906,6 +912,7 @@ static int CRT_colorSchemes[LAST_COLORSCHEME][LAST_COLORELEMENT] = {
       [GPU_ENGINE_3] = A_BOLD | ColorPair(Cyan, Black),
       [GPU_ENGINE_4] = A_BOLD | ColorPair(Cyan, Black),
       [GPU_RESIDUE] = A_BOLD,
+      [SPU_RESIDUE] = A_BOLD,
       [PANEL_EDIT] = A_BOLD,
       [SCREENS_OTH_BORDER] = A_BOLD | ColorPairGrayBlack,
       [SCREENS_OTH_TEXT]  = A_BOLD | ColorPairGrayBlack,
@@ -1306,6 +1313,12 @@ void CRT_enableDelay(void) {
    halfdelay(CRT_settings->delay);
 }
 
+void CRT_pollDelay(int msec) {
+   nocbreak();
+   cbreak();
+   timeout(msec);
+}
+
 void CRT_setColors(int colorScheme) {
    CRT_colorScheme = colorScheme;
 
@@ -130,6 +130,7 @@ typedef enum ColorElements_ {
    GPU_ENGINE_3,
    GPU_ENGINE_4,
    GPU_RESIDUE,
+   SPU_RESIDUE,
    PANEL_EDIT,
    SCREENS_OTH_BORDER,
    SCREENS_OTH_TEXT,
@@ -219,6 +220,9 @@ void CRT_disableDelay(void);
 
 void CRT_enableDelay(void);
 
+/* Waits at most 'msec' milliseconds for input, until CRT_enableDelay */
+void CRT_pollDelay(int msec);
+
 static inline void CRT_updateDelay(void) {
    CRT_enableDelay(); // pushes new delay setting into halfdelay(3X)
 }
@@ -162,5 +162,7 @@ void ColumnsPanel_update(Panel* super) {
       if (key < LAST_PROCESSFIELD)
          this->ss->flags |= Process_fields[key].flags;
    }
+   if (this->ss->groupKey && this->ss->groupKey < LAST_PROCESSFIELD)
+      this->ss->flags |= Process_fields[this->ss->groupKey].flags;
    this->ss->fields[size] = 0;
 }
@@ -36,6 +36,7 @@ in the source distribution for its full text.
 #include "Platform.h"
 #include "Process.h"
 #include "ProcessTable.h"
+#include "ScanThread.h"
 #include "ScreenManager.h"
 #include "Settings.h"
 #include "Table.h"
@@ -404,8 +405,16 @@ int CommandLine_run(int argc, char** argv) {
    if (settings->ss->allBranchesCollapsed)
       Table_collapseAllBranches(&pt->super);
 
+   // the scan thread delivers its first results only after the screen is drawn
+   Header_updateData(header);
+
+   host->scanThread = ScanThread_new(host, header);
+
    ScreenManager_run(scr, NULL, NULL, NULL);
 
+   ScanThread_delete(host->scanThread);
+   host->scanThread = NULL;
+
    Platform_done();
 
    CRT_done();
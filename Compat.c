@@ -37,6 +37,7 @@ int Compat_faccessat(int dirfd,
 
    errno = 0;
 
+   PROFILE_COUNT_CALLS(1);
    ret = faccessat(dirfd, pathname, mode, flags);
    if (!ret || errno != EINVAL)
       return ret;
@@ -70,6 +71,7 @@ int Compat_fstatat(int dirfd,
 
    (void)dirpath;
 
+   PROFILE_COUNT_CALLS(1);
    return fstatat(dirfd, pathname, statbuf, flags);
 
 #else
@@ -96,6 +98,7 @@ int Compat_openat(const char* dirpath,
    char path[4096];
    xSnprintf(path, sizeof(path), "%s/%s", dirpath, pathname);
 
+   PROFILE_COUNT_CALLS(1);
    return open(path, flags);
 }
 
@@ -111,6 +114,7 @@ ssize_t Compat_readlinkat(int dirfd,
 
    (void)dirpath;
 
+   PROFILE_COUNT_CALLS(1);
    return readlinkat(dirfd, pathname, buf, bufsize);
 
 #else
@@ -13,6 +13,8 @@ in the source distribution for its full text.
 #include <unistd.h>
 #include <sys/stat.h> // IWYU pragma: keep
 
+#include "Profile.h"
+
 
 int Compat_faccessat(int dirfd,
                      const char* pathname,
@@ -30,10 +32,12 @@ int Compat_fstatat(int dirfd,
 typedef int openat_arg_t;
 
 static inline void Compat_openatArgClose(openat_arg_t dirfd) {
+   PROFILE_COUNT_CALLS(1);
    close(dirfd);
 }
 
 static inline int Compat_openat(openat_arg_t dirfd, const char* pathname, int flags) {
+   PROFILE_COUNT_CALLS(1);
    return openat(dirfd, pathname, flags);
 }
 
@@ -177,12 +177,13 @@ DisplayOptionsPanel* DisplayOptionsPanel_new(Settings* settings, ScreenManager*
    Panel_add(super, (Object*) CheckItem_newByRef("Add guest time in SPU meter percentage", &(settings->accountGuestInSPUMeter)));
    Panel_add(super, (Object*) CheckItem_newByRef("Also show SPU percentage numerically", &(settings->showSPUUsage)));
    Panel_add(super, (Object*) CheckItem_newByRef("Also show SPU frequency", &(settings->showSPUFrequency)));
+   #ifdef BUILD_WITH_SPU_TEMP
+   Panel_add(super, (Object*) CheckItem_newByRef("Also show SPU temperature", &(settings->showSPUTemperature)));
+   #endif
 
    #ifdef BUILD_WITH_CPU_TEMP
    Panel_add(super, (Object*) CheckItem_newByRef(
-   #if defined(HTOP_LINUX)
-                                                 "Also show CPU temperature (requires libsensors)",
-   #elif defined(HTOP_FREEBSD)
+   #if defined(HTOP_LINUX) || defined(HTOP_FREEBSD)
                                                  "Also show CPU temperature",
    #else
    #error Unknown temperature implementation!
@@ -191,10 +192,14 @@ DisplayOptionsPanel* DisplayOptionsPanel_new(Settings* settings, ScreenManager*
    Panel_add(super, (Object*) CheckItem_newByRef("- Show temperature in degree Fahrenheit instead of Celsius", &(settings->degreeFahrenheit)));
    #endif
    Panel_add(super, (Object*) CheckItem_newByRef("Show cached memory in graph and bar modes", &(settings->showCachedMemory)));
+   #ifndef HTOP_PCP
+   Panel_add(super, (Object*) CheckItem_newByRef("Keep the meter history across restarts (in ~/.cache/htop/history)", &(settings->persistMeterHistory)));
+   #endif
    #ifdef HAVE_GETMOUSE
    Panel_add(super, (Object*) CheckItem_newByRef("Enable the mouse", &(settings->enableMouse)));
    #endif
    Panel_add(super, (Object*) NumberItem_newByRef("Update interval (in seconds)", &(settings->delay), -1, 1, 255));
+   Panel_add(super, (Object*) NumberItem_newByRef("- Adapt it to a CPU budget for htop (in % of one CPU, 0 - off)", &(settings->refreshBudget), 0, 0, 50));
    Panel_add(super, (Object*) CheckItem_newByRef("Highlight new and old processes", &(settings->highlightChanges)));
    Panel_add(super, (Object*) NumberItem_newByRef("- Highlight time (in seconds)", &(settings->highlightDelaySecs), 0, 1, 24 * 60 * 60));
    Panel_add(super, (Object*) NumberItem_newByRef("Hide main function bar (0 - off, 1 - on ESC until next input, 2 - permanently)", &(settings->hideFunctionBar), 0, 0, 2));
@@ -23,6 +23,7 @@ in the source distribution for its full text.
 #include "Macros.h"
 #include "Object.h"
 #include "Platform.h"
+#include "Profile.h"
 #include "ProvideCurses.h"
 #include "Settings.h"
 #include "XUtils.h"
@@ -192,6 +193,8 @@ void Header_reinit(Header* this) {
 }
 
 void Header_draw(const Header* this) {
+   PROFILE_BEGIN(PROFILE_HEADER_DRAW);
+
    const int height = this->height;
    const int pad = this->pad;
    attrset(CRT_colors[RESET_COLOR]);
@@ -235,6 +238,8 @@ void Header_draw(const Header* this) {
       x += floorf(colWidth);
       x++; /* separator column */
    }
+
+   PROFILE_END(PROFILE_HEADER_DRAW);
 }
 
 void Header_updateData(Header* this) {
@@ -244,6 +249,7 @@ void Header_updateData(Header* this) {
       for (int i = 0; i < items; i++) {
          Meter* meter = (Meter*) Vector_get(meters, i);
          Meter_updateValues(meter);
+         Meter_recordHistory(meter);
       }
    }
 }
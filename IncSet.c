@@ -77,24 +77,64 @@ void IncSet_delete(IncSet* this) {
    free(this);
 }
 
-static void updateWeakPanel(const IncSet* this, Panel* panel, Vector* lines) {
+static bool IncSet_matchesNeedles(const char* value, char* const* needles, size_t nNeedles) {
+   for (size_t i = 0; i < nNeedles; i++) {
+      if (strcasestr(value, needles[i]) != NULL)
+         return true;
+   }
+
+   return false;
+}
+
+/*
+ * The filter is split into its alternatives once instead of per line.
+ * When the filter only got longer, the result is a subset of what is shown,
+ * thus only the shown lines need to be checked again.
+ */
+static void updateWeakPanel(const IncSet* this, Panel* panel, Vector* lines, bool narrowing) {
    const Object* selected = Panel_getSelected(panel);
-   Panel_prune(panel);
    if (this->filtering) {
-      int n = 0;
-      const char* incFilter = this->modes[INC_FILTER].buffer;
-      for (int i = 0; i < Vector_size(lines); i++) {
-         ListItem* line = (ListItem*)Vector_get(lines, i);
-         if (String_contains_i(line->value, incFilter, true)) {
-            Panel_add(panel, (Object*)line);
-            if (selected == (Object*)line) {
-               Panel_setSelected(panel, n);
+      size_t nNeedles;
+      char** needles = String_split(this->modes[INC_FILTER].buffer, '|', &nNeedles);
+
+      if (narrowing) {
+         Vector* items = panel->items;
+         int n = 0;
+         int newSelected = 0;
+         for (int i = 0; i < Vector_size(items); i++) {
+            const ListItem* line = (const ListItem*)Vector_get(items, i);
+            if (!IncSet_matchesNeedles(line->value, needles, nNeedles)) {
+               Vector_softRemove(items, i);
+               continue;
             }
 
+            if (selected == (const Object*)line)
+               newSelected = n;
+
             n++;
          }
+         Vector_compact(items);
+         Panel_setSelected(panel, newSelected);
+         panel->needsRedraw = true;
+      } else {
+         Panel_prune(panel);
+         int n = 0;
+         for (int i = 0; i < Vector_size(lines); i++) {
+            ListItem* line = (ListItem*)Vector_get(lines, i);
+            if (IncSet_matchesNeedles(line->value, needles, nNeedles)) {
+               Panel_add(panel, (Object*)line);
+               if (selected == (Object*)line) {
+                  Panel_setSelected(panel, n);
+               }
+
+               n++;
+            }
+         }
       }
+
+      String_freeArray(needles);
    } else {
+      Panel_prune(panel);
       for (int i = 0; i < Vector_size(lines); i++) {
          Object* line = Vector_get(lines, i);
          Panel_add(panel, line);
@@ -162,6 +202,7 @@ bool IncSet_handleKey(IncSet* this, int ch, Panel* panel, IncMode_GetPanelValue
    IncMode* mode = this->active;
    int size = Panel_size(panel);
    bool filterChanged = false;
+   bool filterNarrowed = false;
    bool doSearch = true;
    if (ch == KEY_F(3) || ch == KEY_F(15)) {
       if (size == 0)
@@ -178,6 +219,10 @@ bool IncSet_handleKey(IncSet* this, int ch, Panel* panel, IncMode_GetPanelValue
             filterChanged = true;
             if (mode->index == 1) {
                this->filtering = true;
+            } else {
+               /* Starting another alternative widens the filter, anything
+                * else narrows it; "foo|" only matches what "foo" does */
+               filterNarrowed = (ch != '|' && mode->buffer[mode->index - 2] != '|');
             }
          }
       }
@@ -216,7 +261,7 @@ bool IncSet_handleKey(IncSet* this, int ch, Panel* panel, IncMode_GetPanelValue
       this->found = search(this, panel, getPanelValue);
    }
    if (filterChanged && lines) {
-      updateWeakPanel(this, panel, lines);
+      updateWeakPanel(this, panel, lines, filterNarrowed);
    }
    return filterChanged;
 }
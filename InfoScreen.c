@@ -36,6 +36,7 @@ InfoScreen* InfoScreen_init(InfoScreen* this, const Process* process, FunctionBa
    this->display = Panel_new(0, 1, COLS, height, Class(ListItem), false, bar);
    this->inc = IncSet_new(bar);
    this->lines = Vector_new(Vector_type(this->display->items), true, DEFAULT_SIZE);
+   this->maxLines = 0;
    Panel_setHeader(this->display, panelHeader);
    return this;
 }
@@ -68,12 +69,48 @@ void InfoScreen_drawTitled(InfoScreen* this, const char* fmt, ...) {
    IncSet_drawBar(this->inc, CRT_colors[FUNCTION_BAR]);
 }
 
+void InfoScreen_setMaxLines(InfoScreen* this, int maxLines) {
+   this->maxLines = maxLines;
+}
+
+/*
+ * Drops the oldest lines once the limit is exceeded. This is done for an
+ * eighth of the limit at once, so each line is moved only a few times.
+ * The shown lines are expected to be in the same order as all lines.
+ */
+static void InfoScreen_dropOldestLines(InfoScreen* this) {
+   Panel* panel = this->display;
+   int drop = Vector_size(this->lines) - this->maxLines + this->maxLines / 8;
+   drop = MINIMUM(drop, Vector_size(this->lines));
+
+   int shown = 0;
+   for (int i = 0; i < drop && shown < Panel_size(panel); i++) {
+      if (Panel_get(panel, shown) == Vector_get(this->lines, i))
+         shown++;
+   }
+
+   for (int i = 0; i < shown; i++)
+      Vector_softRemove(panel->items, i);
+   Vector_compact(panel->items);
+
+   for (int i = 0; i < drop; i++)
+      Vector_softRemove(this->lines, i);
+   Vector_compact(this->lines);
+
+   panel->scrollV = MAXIMUM(panel->scrollV - shown, 0);
+   Panel_setSelected(panel, MAXIMUM(Panel_getSelectedIndex(panel) - shown, 0));
+   panel->needsRedraw = true;
+}
+
 void InfoScreen_addLine(InfoScreen* this, const char* line) {
    Vector_add(this->lines, (Object*) ListItem_new(line, 0));
    const char* incFilter = IncSet_filter(this->inc);
    if (!incFilter || String_contains_i(line, incFilter, true)) {
       Panel_add(this->display, Vector_get(this->lines, Vector_size(this->lines) - 1));
    }
+
+   if (this->maxLines > 0 && Vector_size(this->lines) > this->maxLines)
+      InfoScreen_dropOldestLines(this);
 }
 
 void InfoScreen_appendLine(InfoScreen* this, const char* line) {
@@ -25,6 +25,7 @@ typedef struct InfoScreen_ {
    Panel* display;
    IncSet* inc;
    Vector* lines;
+   int maxLines;         /* 0 for no limit, otherwise the oldest lines are dropped */
 } InfoScreen;
 
 typedef void(*InfoScreen_Scan)(InfoScreen*);
@@ -53,6 +54,8 @@ InfoScreen* InfoScreen_done(InfoScreen* this);
 ATTR_FORMAT(printf, 2, 3)
 void InfoScreen_drawTitled(InfoScreen* this, const char* fmt, ...);
 
+void InfoScreen_setMaxLines(InfoScreen* this, int maxLines);
+
 void InfoScreen_addLine(InfoScreen* this, const char* line);
 
 void InfoScreen_appendLine(InfoScreen* this, const char* line);
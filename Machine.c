@@ -10,15 +10,35 @@ in the source distribution for its full text.
 
 #include "Machine.h"
 
+#include <math.h>
 #include <stdlib.h>
 #include <unistd.h>
+#include <sys/resource.h>
 
+#include "Macros.h"
 #include "Object.h"
 #include "Platform.h"
 #include "Row.h"
+#include "ScanThread.h"
 #include "XUtils.h"
 
 
+/* Quiet systems are sampled up to this many times less often */
+#define REFRESH_MAX_STRETCH 4
+
+/* Scans without notable change after which the interval is stretched once more */
+#define REFRESH_QUIET_SCANS 10
+
+/* Scans at the configured interval once a watched metric changed sharply */
+#define REFRESH_SPIKE_SCANS 5
+
+/* Changes of CPU or memory usage, in percentage points */
+#define REFRESH_QUIET_CHANGE 5.0
+#define REFRESH_SPIKE_CHANGE 20.0
+
+/* Upper bound of adapted intervals, in tenths of seconds */
+#define REFRESH_MAX_DELAY 300
+
 void Machine_init(Machine* this, UsersTable* usersTable, uid_t userId) {
    this->usersTable = usersTable;
    this->userId = userId;
@@ -57,10 +77,11 @@ void Machine_done(Machine* this) {
    }
 #endif
    Object_delete(this->processTable);
+   free(this->cpuUsage);
    free(this->tables);
 }
 
-static void Machine_addTable(Machine* this, Table* table) {
+void Machine_addTable(Machine* this, Table* table) {
    /* check that this table has not been seen previously */
    for (size_t i = 0; i < this->tableCount; i++)
       if (this->tables[i] == table)
@@ -114,6 +135,8 @@ void Machine_scanTables(Machine* this) {
    this->maxUserId = 0;
    Row_resetFieldWidths();
 
+   UsersTable_update(this->usersTable);
+
    for (size_t i = 0; i < this->tableCount; i++) {
       Table* table = this->tables[i];
 
@@ -127,5 +150,70 @@ void Machine_scanTables(Machine* this) {
       Table_scanCleanup(table);
    }
 
+   Row_commitFieldWidths();
    Row_setUidColumnWidth(this->maxUserId);
 }
+
+void Machine_yield(const Machine* this) {
+   ScanThread_yield(this->scanThread);
+}
+
+static double Machine_watchedCPU(const Machine* this) {
+   if (this->cpuUsage)
+      return this->cpuUsage[0];
+
+   double one, five, fifteen;
+   Platform_getLoadAverage(&one, &five, &fifteen);
+   return 100.0 * one / MAXIMUM(this->activeCPUs, 1U);
+}
+
+void Machine_updateRefreshDelay(Machine* this) {
+   const Settings* settings = this->settings;
+
+   uint64_t now;
+   Platform_gettime_monotonic(&now);
+
+   uint64_t cpuUs = this->selfCPUUs;
+   struct rusage usage;
+   if (getrusage(RUSAGE_SELF, &usage) == 0) {
+      cpuUs = (uint64_t)usage.ru_utime.tv_sec * 1000000 + (uint64_t)usage.ru_utime.tv_usec +
+              (uint64_t)usage.ru_stime.tv_sec * 1000000 + (uint64_t)usage.ru_stime.tv_usec;
+   }
+
+   if (this->selfSampleMs && now > this->selfSampleMs && cpuUs >= this->selfCPUUs) {
+      double usedMs = (cpuUs - this->selfCPUUs) / 1000.0;
+      this->selfCPU = 100.0 * usedMs / (double)(now - this->selfSampleMs);
+      this->refreshCost = this->refreshCost > 0.0 ? 0.7 * this->refreshCost + 0.3 * usedMs : usedMs;
+   }
+   this->selfSampleMs = now;
+   this->selfCPUUs = cpuUs;
+
+   double cpu = Machine_watchedCPU(this);
+   double mem = this->totalMem ? 100.0 * (double)this->usedMem / (double)this->totalMem : 0.0;
+   double change = MAXIMUM(fabs(cpu - this->watchedCPU), fabs(mem - this->watchedMem));
+   this->watchedCPU = cpu;
+   this->watchedMem = mem;
+
+   if (change >= REFRESH_SPIKE_CHANGE) {
+      this->spikeScans = REFRESH_SPIKE_SCANS;
+      this->quietScans = 0;
+   } else if (change < REFRESH_QUIET_CHANGE) {
+      this->quietScans = MINIMUM(this->quietScans + 1, REFRESH_QUIET_SCANS * (REFRESH_MAX_STRETCH - 1));
+   } else {
+      this->quietScans = 0;
+   }
+
+   unsigned int delay = (unsigned int)settings->delay;
+   if (settings->refreshBudget <= 0 || this->spikeScans > 0) {
+      if (this->spikeScans > 0)
+         this->spikeScans--;
+      this->refreshDelay = delay;
+      return;
+   }
+
+   /* Shortest interval, in tenths of seconds, whose cost stays within the budget */
+   double costDelay = ceil(this->refreshCost / settings->refreshBudget);
+   unsigned int stretch = 1 + this->quietScans / REFRESH_QUIET_SCANS;
+   double adapted = MAXIMUM((double)delay, costDelay) * stretch;
+   this->refreshDelay = (unsigned int)MINIMUM(adapted, (double)MAXIMUM(delay, REFRESH_MAX_DELAY));
+}
@@ -45,6 +45,22 @@ typedef struct Machine_ {
 
    int64_t iterationsRemaining;
 
+   struct ScanThread_* scanThread;   /* NULL if scans run on the UI thread */
+   uint64_t scanMs;                  /* duration of the last scan */
+   uint64_t inputLatencyMs;          /* from the last key press to the screen update handling it */
+   uint64_t maxInputLatencyMs;
+
+   /* Adaptive update interval, see Machine_updateRefreshDelay */
+   unsigned int refreshDelay;        /* tenths of seconds between two scans */
+   double selfCPU;                   /* CPU used by htop since the previous scan, in percent of one CPU */
+   double refreshCost;               /* smoothed CPU time of one update interval, in milliseconds */
+   uint64_t selfSampleMs;
+   uint64_t selfCPUUs;
+   double watchedCPU;
+   double watchedMem;
+   unsigned int quietScans;
+   unsigned int spikeScans;
+
    #ifdef HAVE_LIBHWLOC
    hwloc_topology_t topology;
    bool topologyOk;
@@ -63,9 +79,11 @@ typedef struct Machine_ {
 
    unsigned int activeCPUs;
    unsigned int existingCPUs;
+   double* cpuUsage;  /* busy percentage per CPU, index 0 is the average; NULL unless provided by the platform */
 
    unsigned int activeSPUs;
    unsigned int existingSPUs;
+   unsigned int existingSPUNodes;  /* Cell chips, exposed as NUMA nodes */
 
    UsersTable* usersTable;
    uid_t htopUserId;
@@ -89,6 +107,9 @@ void Machine_done(Machine* this);
 
 bool Machine_isCPUonline(const Machine* this, unsigned int id);
 
+/* Registers a table for scanning, once */
+void Machine_addTable(Machine* this, Table* table);
+
 void Machine_populateTablesFromSettings(Machine* this, Settings* settings, Table* processTable);
 
 void Machine_setTablesPanel(Machine* this, Panel* panel);
@@ -97,4 +118,15 @@ void Machine_scan(Machine* this);
 
 void Machine_scanTables(Machine* this);
 
+/* Called by scans between two rows, lets a waiting UI thread in */
+void Machine_yield(const Machine* this);
+
+/* Measures the CPU used by htop and adapts refreshDelay to settings->refreshBudget */
+void Machine_updateRefreshDelay(Machine* this);
+
+/* Tenths of seconds from one scan to the next */
+static inline int Machine_refreshDelay(const Machine* this) {
+   return this->settings->refreshBudget > 0 && this->refreshDelay > 0 ? (int)this->refreshDelay : this->settings->delay;
+}
+
 #endif
@@ -172,8 +172,9 @@ bool MainPanel_foreachRow(MainPanel* this, MainPanel_foreachRowFn fn, Arg arg, b
       }
    }
    if (!anyTagged) {
+      /* a synthetic group row stands for several rows, act on none of them */
       Row* row = (Row*) Panel_getSelected(super);
-      if (row) {
+      if (row && !Row_isGroup(row)) {
          ok &= fn(row, arg);
       }
    }
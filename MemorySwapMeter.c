@@ -30,7 +30,9 @@ static void MemorySwapMeter_updateValues(Meter* this) {
    MemorySwapMeterData* data = this->meterData;
 
    Meter_updateValues(data->memoryMeter);
+   Meter_recordHistory(data->memoryMeter);
    Meter_updateValues(data->swapMeter);
+   Meter_recordHistory(data->swapMeter);
 }
 
 static void MemorySwapMeter_draw(Meter* this, int x, int y, int w) {
@@ -202,6 +202,128 @@ static const char* const GraphMeterMode_dotsAscii[] = {
    /*20*/":", /*21*/":", /*22*/":"
 };
 
+/* 0 shows the live samples, otherwise the history at resolution Meter_graphZoom - 1 */
+static unsigned int Meter_graphZoom = 0;
+
+void Meter_cycleGraphZoom(void) {
+   Meter_graphZoom = (Meter_graphZoom + 1) % (LAST_METERHISTORY_RESOLUTION + 1);
+}
+
+double GraphData_reduce(const GraphData* this, size_t age, size_t span, GraphData_Reduce reduce) {
+   double result = 0.0;
+   size_t n = 0;
+
+   for (size_t i = 0; i < span && age + i < this->count; i++) {
+      size_t idx = (this->head + this->nValues - 1 - (age + i)) % this->nValues;
+      double value = this->values[idx];
+
+      if (n == 0) {
+         result = value;
+      } else if (reduce == GRAPHDATA_REDUCE_MIN) {
+         result = MINIMUM(result, value);
+      } else if (reduce == GRAPHDATA_REDUCE_MAX) {
+         result = MAXIMUM(result, value);
+      } else {
+         result += value;
+      }
+      n++;
+   }
+
+   if (reduce == GRAPHDATA_REDUCE_AVG && n > 1)
+      result /= n;
+
+   return result;
+}
+
+static void GraphData_resize(GraphData* this, int delay) {
+   size_t nValues = (size_t)METER_GRAPHDATA_SECONDS * 10 / (size_t)MAXIMUM(delay, 1);
+   nValues = MAXIMUM(nValues, this->minValues);
+   nValues = CLAMP(nValues, 2, MAX_METER_GRAPHDATA_VALUES);
+
+   double* values = xCalloc(nValues, sizeof(*values));
+
+   // Keep the newest samples, oldest first
+   size_t keep = MINIMUM(this->count, nValues);
+   for (size_t i = 0; i < keep; i++)
+      values[i] = this->values[(this->head + this->nValues - keep + i) % this->nValues];
+
+   free(this->values);
+   this->values = values;
+   this->nValues = nValues;
+   this->head = keep % nValues;
+   this->count = keep;
+   this->delay = delay;
+}
+
+void Meter_recordHistory(Meter* this) {
+   const Machine* host = this->host;
+
+   double value = 0.0;
+   if (this->curItems > 0) {
+      assert(this->values);
+      value = sumPositiveValues(this->values, this->curItems);
+   }
+
+   if (As_Meter(this)->maxItems > 0) {
+#ifdef HTOP_PCP
+      /* The values belong to the monitored host, not to this one */
+      bool persist = false;
+#else
+      bool persist = host->settings->persistMeterHistory;
+#endif
+
+      if (this->history && this->history->persist != persist) {
+         /* The setting changed, continue in the file or in memory */
+         MeterHistory_delete(this->history);
+         this->history = NULL;
+      }
+
+      if (!this->history) {
+         char key[64];
+         if (this->param)
+            xSnprintf(key, sizeof(key), "%s-%u", Meter_name(this), this->param);
+         else
+            xSnprintf(key, sizeof(key), "%s", Meter_name(this));
+
+         this->history = MeterHistory_new(key, persist);
+      }
+
+      MeterHistory_record(this->history, host->realtime.tv_sec, value);
+   }
+
+   if (this->mode != GRAPH_METERMODE)
+      return;
+
+   GraphData* data = &this->drawData;
+   if (timercmp(&host->realtime, &data->time, <))
+      return;
+
+   int globalDelay = host->settings->delay;
+   struct timeval delay = { .tv_sec = globalDelay / 10, .tv_usec = (globalDelay % 10) * 100000L };
+   timeradd(&host->realtime, &delay, &data->time);
+
+   if (!data->values || data->delay != globalDelay || data->nValues < MINIMUM(data->minValues, MAX_METER_GRAPHDATA_VALUES))
+      GraphData_resize(data, globalDelay);
+
+   data->values[data->head] = value;
+   data->head = (data->head + 1) % data->nValues;
+   if (data->count < data->nValues)
+      data->count++;
+}
+
+/* Point 'age' of 'nPoints' spread over the whole graph data, the peak of its samples */
+static double GraphMeterMode_value(const Meter* this, const MeterHistory* history, size_t age, size_t nPoints) {
+   if (history) {
+      double value = MeterHistory_get(history, Meter_graphZoom - 1, age);
+      return isnan(value) ? 0.0 : value;
+   }
+
+   const GraphData* data = &this->drawData;
+   size_t first = age * data->nValues / nPoints;
+   size_t last = (age + 1) * data->nValues / nPoints;
+   return GraphData_reduce(data, first, MAXIMUM(last - first, 1), GRAPHDATA_REDUCE_MAX);
+}
+
 static void GraphMeterMode_draw(Meter* this, int x, int y, int w) {
    assert(x >= 0);
    assert(w <= INT_MAX - x);
@@ -218,37 +340,14 @@ static void GraphMeterMode_draw(Meter* this, int x, int y, int w) {
    assert(this->h >= 1);
    int h = this->h;
 
-   GraphData* data = &this->drawData;
-
-   // Expand the graph data buffer if necessary
-   assert(data->nValues / 2 <= INT_MAX);
-   if (w > (int)(data->nValues / 2) && MAX_METER_GRAPHDATA_VALUES > data->nValues) {
-      size_t oldNValues = data->nValues;
-      data->nValues = MAXIMUM(oldNValues + oldNValues / 2, (size_t)w * 2);
-      data->nValues = MINIMUM(data->nValues, MAX_METER_GRAPHDATA_VALUES);
-      data->values = xReallocArray(data->values, data->nValues, sizeof(*data->values));
-      memmove(data->values + (data->nValues - oldNValues), data->values, oldNValues * sizeof(*data->values));
-      memset(data->values, 0, (data->nValues - oldNValues) * sizeof(*data->values));
-   }
-
-   const size_t nValues = data->nValues;
-   if (nValues < 1)
+   const MeterHistory* history = Meter_graphZoom > 0 ? this->history : NULL;
+   const GraphData* data = &this->drawData;
+   if (!history && !data->values)
       goto end;
 
-   // Record new value if necessary
-   const Machine* host = this->host;
-   if (!timercmp(&host->realtime, &(data->time), <)) {
-      int globalDelay = host->settings->delay;
-      struct timeval delay = { .tv_sec = globalDelay / 10, .tv_usec = (globalDelay % 10) * 100000L };
-      timeradd(&host->realtime, &delay, &(data->time));
-
-      memmove(&data->values[0], &data->values[1], (nValues - 1) * sizeof(*data->values));
-
-      data->values[nValues - 1] = 0.0;
-      if (this->curItems > 0) {
-         assert(this->values);
-         data->values[nValues - 1] = sumPositiveValues(this->values, this->curItems);
-      }
+   if (history && h > 1 && w >= 0) {
+      attrset(CRT_colors[METER_SHADOW]);
+      mvaddnstr(y + 1, x, MeterHistory_resolutionName(Meter_graphZoom - 1), captionLen);
    }
 
    if (w < 1) {
@@ -270,19 +369,27 @@ static void GraphMeterMode_draw(Meter* this, int x, int y, int w) {
       GraphMeterMode_pixPerRow = PIXPERROW_ASCII;
    }
 
-   // Starting positions of graph data and terminal column
-   if ((size_t)w > nValues / 2) {
-      x += w - nValues / 2;
-      w = (int)(nValues / 2);
+   // Each column shows two points, the newest one at the right edge. Live samples
+   // are downsampled to the width; a wider graph grows the buffer with the next sample.
+   size_t nPoints = history ? MeterHistory_count(history, Meter_graphZoom - 1) : data->nValues;
+   if (!history) {
+      this->drawData.minValues = MAXIMUM(data->minValues, (size_t)w * 2);
+      nPoints = MINIMUM(nPoints, (size_t)w * 2);
+   }
+   if ((size_t)w > nPoints / 2) {
+      x += w - (int)(nPoints / 2);
+      w = (int)(nPoints / 2);
    }
-   size_t i = nValues - (size_t)w * 2;
 
    // Draw the actual graph
-   for (int col = 0; i < nValues - 1; i += 2, col++) {
+   for (int col = 0; col < w; col++) {
+      size_t age = (size_t)(w - col) * 2 - 1;
       int pix = GraphMeterMode_pixPerRow * h;
       double total = MAXIMUM(this->total, 1);
-      int v1 = (int) lround(CLAMP(data->values[i] / total * pix, 1.0, pix));
-      int v2 = (int) lround(CLAMP(data->values[i + 1] / total * pix, 1.0, pix));
+      double value1 = GraphMeterMode_value(this, history, age, nPoints);
+      double value2 = GraphMeterMode_value(this, history, age - 1, nPoints);
+      int v1 = (int) lround(CLAMP(value1 / total * pix, 1.0, pix));
+      int v2 = (int) lround(CLAMP(value2 / total * pix, 1.0, pix));
 
       int colorIdx = GRAPH_1;
       for (int line = 0; line < h; line++) {
@@ -484,6 +591,7 @@ void Meter_delete(Object* cast) {
       Meter_done(this);
    }
    free(this->drawData.values);
+   MeterHistory_delete(this->history);
    free(this->caption);
    free(this->values);
    free(this);
@@ -514,8 +622,7 @@ void Meter_setMode(Meter* this, MeterModeId modeIndex) {
       Meter_updateMode(this, modeIndex);
    } else {
       free(this->drawData.values);
-      this->drawData.values = NULL;
-      this->drawData.nValues = 0;
+      this->drawData = (GraphData) { .values = NULL };
 
       const MeterMode* mode = &Meter_modes[modeIndex];
       this->draw = mode->draw;
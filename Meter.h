@@ -15,12 +15,14 @@ in the source distribution for its full text.
 #include "ListItem.h"
 #include "Machine.h"
 #include "Macros.h"
+#include "MeterHistory.h"
 #include "MeterMode.h"
 #include "Object.h"
 
 
 #define METER_TXTBUFFER_LEN 256
 #define MAX_METER_GRAPHDATA_VALUES 32768
+#define METER_GRAPHDATA_SECONDS 600
 
 #define METER_BUFFER_CHECK(buffer, size, written)          \
    do {                                                    \
@@ -96,9 +98,21 @@ typedef struct MeterClass_ {
 #define Meter_uiName(this_)            As_Meter(this_)->uiName
 #define Meter_isMultiColumn(this_)     As_Meter(this_)->isMultiColumn
 
+typedef enum GraphData_Reduce_ {
+   GRAPHDATA_REDUCE_AVG,
+   GRAPHDATA_REDUCE_MIN,
+   GRAPHDATA_REDUCE_MAX
+} GraphData_Reduce;
+
+/* Ring buffer holding the last METER_GRAPHDATA_SECONDS worth of samples,
+ * or more if the graph is wider than that */
 typedef struct GraphData_ {
-   struct timeval time;
-   size_t nValues;
+   struct timeval time;    /* when the next sample is due */
+   size_t nValues;         /* capacity */
+   size_t head;            /* slot the next sample is written to */
+   size_t count;           /* samples recorded, at most nValues */
+   size_t minValues;       /* points of the widest graph drawn, two per column */
+   int delay;              /* refresh delay the capacity was sized for */
    double* values;
 } GraphData;
 
@@ -111,6 +125,7 @@ struct Meter_ {
    MeterModeId mode;
    unsigned int param;
    GraphData drawData;
+   MeterHistory* history;
    int h;
    int columnWidthCount;      /**< only used internally by the Header */
    uint8_t curItems;
@@ -144,6 +159,15 @@ void Meter_setMode(Meter* this, MeterModeId modeIndex);
 
 MeterModeId Meter_nextSupportedMode(const Meter* this);
 
+/* Appends the current value to the long-term history and, if a sample is due, to the graph */
+void Meter_recordHistory(Meter* this);
+
+/* Switches graphs between live samples and the 1s, 10s and 1m history */
+void Meter_cycleGraphZoom(void);
+
+/* Reduces the 'span' samples starting 'age' samples before the newest one */
+double GraphData_reduce(const GraphData* this, size_t age, size_t span, GraphData_Reduce reduce);
+
 ListItem* Meter_toListItem(const Meter* this, bool moving);
 
 extern const MeterClass BlankMeter_class;
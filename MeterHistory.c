@@ -0,0 +1,226 @@
+/*
+htop - MeterHistory.c
+(C) 2024 htop dev team
+Released under the GNU GPLv2+, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "config.h" // IWYU pragma: keep
+
+#include "MeterHistory.h"
+
+#include <fcntl.h>
+#include <math.h>
+#include <pwd.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "Macros.h"
+#include "XUtils.h"
+
+
+#define METERHISTORY_MAGIC   0x48747048U   /* "Hpth" */
+#define METERHISTORY_VERSION 1
+
+/* Buckets without samples repeat the previous value, unless htop was not running for longer */
+#define METERHISTORY_MAX_FILL 10
+
+static const struct {
+   unsigned int interval;
+   uint32_t capacity;
+   const char* name;
+} MeterHistory_levels[LAST_METERHISTORY_RESOLUTION] = {
+   [METERHISTORY_1S]  = { .interval = 1,  .capacity = 600,   .name = "1s" },
+   [METERHISTORY_10S] = { .interval = 10, .capacity = 2160,  .name = "10s" },
+   [METERHISTORY_1M]  = { .interval = 60, .capacity = 10080, .name = "1m" },
+};
+
+static size_t MeterHistory_offset(MeterHistory_Resolution resolution) {
+   size_t offset = 0;
+   for (unsigned int i = 0; i < resolution; i++)
+      offset += MeterHistory_levels[i].capacity;
+   return offset;
+}
+
+static size_t MeterHistory_dataSize(void) {
+   return sizeof(MeterHistory_Data) + MeterHistory_offset(LAST_METERHISTORY_RESOLUTION) * sizeof(double);
+}
+
+static void MeterHistory_initData(MeterHistory_Data* data) {
+   memset(data, 0, MeterHistory_dataSize());
+   data->magic = METERHISTORY_MAGIC;
+   data->version = METERHISTORY_VERSION;
+}
+
+static char* MeterHistory_path(const char* key) {
+   const char* cacheHome = getenv("XDG_CACHE_HOME");
+   char* cacheDir;
+   if (cacheHome && cacheHome[0] == '/') {
+      cacheDir = xStrdup(cacheHome);
+   } else {
+      const char* home = getenv("HOME");
+      if (!home || home[0] != '/') {
+         const struct passwd* pw = getpwuid(getuid());
+         home = (pw && pw->pw_dir && pw->pw_dir[0] == '/') ? pw->pw_dir : NULL;
+      }
+      if (!home)
+         return NULL;
+
+      cacheDir = String_cat(home, "/.cache");
+   }
+
+   char* htopDir = String_cat(cacheDir, "/htop");
+   char* historyDir = String_cat(htopDir, "/history");
+   (void) mkdir(cacheDir, 0700);
+   (void) mkdir(htopDir, 0700);
+   (void) mkdir(historyDir, 0700);
+
+   char* path;
+   xAsprintf(&path, "%s/%s", historyDir, key);
+   for (char* c = path + strlen(historyDir) + 1; *c; c++) {
+      if (*c == '/' || *c == ' ')
+         *c = '_';
+   }
+
+   free(historyDir);
+   free(htopDir);
+   free(cacheDir);
+   return path;
+}
+
+static bool MeterHistory_map(MeterHistory* this, const char* key) {
+   char* path = MeterHistory_path(key);
+   if (!path)
+      return false;
+
+   int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC | O_NOFOLLOW, 0600);
+   free(path);
+   if (fd < 0)
+      return false;
+
+   /* Another htop instance (or meter) owns this history already */
+   if (flock(fd, LOCK_EX | LOCK_NB) != 0)
+      goto err;
+
+   struct stat sb;
+   if (fstat(fd, &sb) != 0)
+      goto err;
+
+   bool fresh = (size_t)sb.st_size != this->size;
+   if (fresh && ftruncate(fd, (off_t)this->size) != 0)
+      goto err;
+
+   void* data = mmap(NULL, this->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+   if (data == MAP_FAILED)
+      goto err;
+
+   this->data = data;
+   this->fd = fd;
+
+   if (fresh || this->data->magic != METERHISTORY_MAGIC || this->data->version != METERHISTORY_VERSION)
+      MeterHistory_initData(this->data);
+
+   return true;
+
+err:
+   close(fd);
+   return false;
+}
+
+MeterHistory* MeterHistory_new(const char* key, bool persist) {
+   MeterHistory* this = xMalloc(sizeof(MeterHistory));
+   this->size = MeterHistory_dataSize();
+   this->data = NULL;
+   this->fd = -1;
+   this->persist = persist;
+
+   if (!persist || !MeterHistory_map(this, key)) {
+      this->data = xMalloc(this->size);
+      MeterHistory_initData(this->data);
+   }
+
+   return this;
+}
+
+void MeterHistory_delete(MeterHistory* this) {
+   if (!this)
+      return;
+
+   if (this->fd >= 0) {
+      munmap(this->data, this->size);
+      close(this->fd);
+   } else {
+      free(this->data);
+   }
+
+   free(this);
+}
+
+static void MeterHistory_push(MeterHistory* this, MeterHistory_Resolution resolution, double value) {
+   MeterHistory_Level* level = &this->data->levels[resolution];
+   uint32_t capacity = MeterHistory_levels[resolution].capacity;
+   double* values = this->data->values + MeterHistory_offset(resolution);
+
+   values[level->head] = value;
+   level->head = (level->head + 1) % capacity;
+   if (level->count < capacity)
+      level->count++;
+}
+
+void MeterHistory_record(MeterHistory* this, time_t now, double value) {
+   for (unsigned int r = 0; r < LAST_METERHISTORY_RESOLUTION; r++) {
+      MeterHistory_Level* level = &this->data->levels[r];
+      int64_t bucket = (int64_t)now / MeterHistory_levels[r].interval;
+
+      if (level->bucket == 0)
+         level->bucket = bucket;
+
+      /* A clock stepping backwards keeps accumulating into the current bucket */
+      if (bucket > level->bucket) {
+         double completed = level->samples ? level->sum / level->samples : NAN;
+         MeterHistory_push(this, r, completed);
+
+         int64_t gap = bucket - level->bucket - 1;
+         double fill = gap <= METERHISTORY_MAX_FILL ? completed : NAN;
+         gap = MINIMUM(gap, (int64_t)MeterHistory_levels[r].capacity);
+         for (int64_t i = 0; i < gap; i++)
+            MeterHistory_push(this, r, fill);
+
+         level->bucket = bucket;
+         level->sum = 0.0;
+         level->samples = 0;
+      }
+
+      if (!isnan(value)) {
+         level->sum += value;
+         level->samples++;
+      }
+   }
+}
+
+size_t MeterHistory_count(const MeterHistory* this, MeterHistory_Resolution resolution) {
+   return this->data->levels[resolution].count + 1;
+}
+
+double MeterHistory_get(const MeterHistory* this, MeterHistory_Resolution resolution, size_t age) {
+   const MeterHistory_Level* level = &this->data->levels[resolution];
+
+   if (age == 0)
+      return level->samples ? level->sum / level->samples : NAN;
+
+   age--;
+   if (age >= level->count)
+      return NAN;
+
+   uint32_t capacity = MeterHistory_levels[resolution].capacity;
+   const double* values = this->data->values + MeterHistory_offset(resolution);
+   return values[(level->head + capacity - 1 - age) % capacity];
+}
+
+const char* MeterHistory_resolutionName(MeterHistory_Resolution resolution) {
+   return MeterHistory_levels[resolution].name;
+}
@@ -0,0 +1,66 @@
+#ifndef HEADER_MeterHistory
+#define HEADER_MeterHistory
+/*
+htop - MeterHistory.h
+(C) 2024 htop dev team
+Released under the GNU GPLv2+, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+
+/*
+ * Long-horizon history of a meter's value, kept at decreasing resolutions:
+ * 1s for 10 minutes, 10s for 6 hours and 1m for 7 days.
+ */
+typedef enum MeterHistory_Resolution_ {
+   METERHISTORY_1S,
+   METERHISTORY_10S,
+   METERHISTORY_1M,
+   LAST_METERHISTORY_RESOLUTION
+} MeterHistory_Resolution;
+
+typedef struct MeterHistory_Level_ {
+   int64_t bucket;         /* time / interval of the bucket being accumulated */
+   double sum;             /* accumulated values of that bucket */
+   uint32_t samples;
+   uint32_t head;          /* slot the next completed bucket is written to */
+   uint32_t count;         /* completed buckets stored */
+   uint32_t reserved;
+} MeterHistory_Level;
+
+typedef struct MeterHistory_Data_ {
+   uint32_t magic;
+   uint32_t version;
+   MeterHistory_Level levels[LAST_METERHISTORY_RESOLUTION];
+   double values[];        /* the rings of all levels, one after another */
+} MeterHistory_Data;
+
+typedef struct MeterHistory_ {
+   MeterHistory_Data* data;
+   size_t size;
+   int fd;                 /* backing file, or -1 for memory only */
+   bool persist;           /* as requested, the file may still be unavailable */
+} MeterHistory;
+
+/* Opens the history stored under 'key', falling back to memory if it cannot be persisted */
+MeterHistory* MeterHistory_new(const char* key, bool persist);
+
+void MeterHistory_delete(MeterHistory* this);
+
+void MeterHistory_record(MeterHistory* this, time_t now, double value);
+
+/* Number of buckets available, including the one in progress */
+size_t MeterHistory_count(const MeterHistory* this, MeterHistory_Resolution resolution);
+
+/* Value of the bucket 'age' steps before the one in progress (age 0), NAN for gaps */
+double MeterHistory_get(const MeterHistory* this, MeterHistory_Resolution resolution, size_t age);
+
+/* Short label such as "10s" */
+const char* MeterHistory_resolutionName(MeterHistory_Resolution resolution);
+
+#endif
@@ -22,6 +22,7 @@ in the source distribution for its full text.
 
 #include "Macros.h"
 #include "Panel.h"
+#include "Platform.h"
 #include "ProvideCurses.h"
 #include "Vector.h"
 #include "XUtils.h"
@@ -30,6 +31,15 @@ in the source distribution for its full text.
 // cf. getIndexForType; must be larger than the maximum value returned.
 #define LSOF_DATACOL_COUNT 8
 
+// Entries of native backends arrive incrementally, so the columns can not be fitted to their content.
+#define OPENFILES_NATIVE_COLWIDTH 10
+
+// Fits the descriptors allowed by the default fs.nr_open limit of 1048576.
+#define OPENFILES_NATIVE_FDWIDTH 7
+
+// Number of entries read by native backends between intermediate redraws.
+#define OPENFILES_REDRAW_INTERVAL 256
+
 typedef struct OpenFiles_Data_ {
    char* data[LSOF_DATACOL_COUNT];
 } OpenFiles_Data;
@@ -254,10 +264,8 @@ static void OpenFiles_Data_clear(OpenFiles_Data* data) {
       free(data->data[i]);
 }
 
-static void OpenFilesScreen_scan(InfoScreen* super) {
+static void OpenFilesScreen_scanLsof(InfoScreen* super) {
    Panel* panel = super->display;
-   int idx = Panel_getSelectedIndex(panel);
-   Panel_prune(panel);
    OpenFiles_ProcessData* pdata = OpenFilesScreen_getProcessData(((OpenFilesScreen*)super)->pid);
    if (pdata->error == 127) {
       InfoScreen_addLine(super, "Could not execute 'lsof'. Please make sure it is available in your $PATH.");
@@ -300,8 +308,63 @@ static void OpenFilesScreen_scan(InfoScreen* super) {
       OpenFiles_Data_clear(&pdata->data);
    }
    free(pdata);
-   Vector_insertionSort(super->lines);
-   Vector_insertionSort(panel->items);
+}
+
+static inline const char* OpenFiles_Entry_field(const char* field) {
+   return field ? field : "";
+}
+
+static void OpenFilesScreen_addEntry(const OpenFiles_Entry* entry, void* context) {
+   OpenFilesScreen* this = (OpenFilesScreen*) context;
+   InfoScreen* super = &this->super;
+
+   char* line = NULL;
+   xAsprintf(&line, "%*s %-7.7s %-4.4s %6.6s %*s %*s %*s  %s",
+             OPENFILES_NATIVE_FDWIDTH, OpenFiles_Entry_field(entry->fd),
+             OpenFiles_Entry_field(entry->type),
+             OpenFiles_Entry_field(entry->mode),
+             OpenFiles_Entry_field(entry->device),
+             OPENFILES_NATIVE_COLWIDTH, OpenFiles_Entry_field(entry->size),
+             OPENFILES_NATIVE_COLWIDTH, OpenFiles_Entry_field(entry->offset),
+             OPENFILES_NATIVE_COLWIDTH, OpenFiles_Entry_field(entry->node),
+             OpenFiles_Entry_field(entry->name));
+   InfoScreen_addLine(super, line);
+   free(line);
+
+   /* Show the first entries while the remaining ones are still being read */
+   if (++this->shown % OPENFILES_REDRAW_INTERVAL == 0) {
+      InfoScreen_draw(super);
+      refresh();
+   }
+}
+
+static void OpenFilesScreen_scan(InfoScreen* super) {
+   OpenFilesScreen* this = (OpenFilesScreen*) super;
+   Panel* panel = super->display;
+   int idx = Panel_getSelectedIndex(panel);
+   Panel_prune(panel);
+
+   char hdrbuf[128] = {0};
+   snprintf(hdrbuf, sizeof(hdrbuf), "%*s %-7.7s %-4.4s %6.6s %*s %*s %*s  %s",
+      OPENFILES_NATIVE_FDWIDTH, "FD", "TYPE", "MODE", "DEVICE",
+      OPENFILES_NATIVE_COLWIDTH, "SIZE",
+      OPENFILES_NATIVE_COLWIDTH, "OFFSET",
+      OPENFILES_NATIVE_COLWIDTH, "NODE",
+      "NAME"
+   );
+   Panel_setHeader(panel, hdrbuf);
+
+   this->shown = 0;
+   int err = Platform_getOpenFiles(this->pid, OpenFilesScreen_addEntry, this);
+   if (err == -1) {
+      OpenFilesScreen_scanLsof(super);
+   } else if (err != 0) {
+      InfoScreen_addLine(super, "Failed listing open files.");
+   }
+
+   /* Native backends deliver thousands of unordered entries */
+   Vector_quickSort(super->lines);
+   Vector_quickSort(panel->items);
    Panel_setSelected(panel, idx);
 }
 
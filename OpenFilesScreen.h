@@ -17,8 +17,23 @@ in the source distribution for its full text.
 typedef struct OpenFilesScreen_ {
    InfoScreen super;
    pid_t pid;
+   unsigned int shown;   /* entries added during the current scan */
 } OpenFilesScreen;
 
+/* One open file as reported by a native platform backend; NULL fields are shown empty */
+typedef struct OpenFiles_Entry_ {
+   const char* fd;
+   const char* type;
+   const char* mode;
+   const char* device;
+   const char* size;
+   const char* offset;
+   const char* node;
+   const char* name;
+} OpenFiles_Entry;
+
+typedef void(*OpenFiles_EntryCallback)(const OpenFiles_Entry* entry, void* context);
+
 extern const InfoScreenClass OpenFilesScreen_class;
 
 OpenFilesScreen* OpenFilesScreen_new(const Process* process);
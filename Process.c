@@ -541,6 +541,43 @@ static void Process_rowWriteField(const Row* super, RichString* str, RowField fi
    Process_writeField(this, str, field);
 }
 
+/* Group rows show their key and the fields summed up by Process_rowAccumulate,
+ * the other fields are left blank */
+static bool Process_writeGroupField(const Process* this, RichString* str, RowField field) {
+   const Settings* settings = this->super.host->settings;
+
+   switch (field) {
+   case COMM: {
+      char count[32];
+      xSnprintf(count, sizeof(count), " (%u)", this->super.groupMembers);
+      RichString_appendWide(str, CRT_colors[PROCESS_TREE], CRT_treeStr[this->super.showChildren ? TREE_STR_SHUT : TREE_STR_OPEN]);
+      RichString_appendAscii(str, CRT_colors[PROCESS_TREE], " ");
+      RichString_appendWide(str, CRT_colors[PROCESS_BASENAME], this->cmdline);
+      RichString_appendAscii(str, CRT_colors[PROCESS_SHADOW], count);
+      return true;
+   }
+   case MAJFLT:
+   case MINFLT:
+   case M_RESIDENT:
+   case M_VIRT:
+   case NLWP:
+   case PERCENT_CPU:
+   case PERCENT_NORM_CPU:
+   case PERCENT_MEM:
+   case TIME:
+      return false;
+   default:
+      break;
+   }
+
+   size_t width = strlen(RowField_alignedTitle(settings, field));
+   if (field == settings->ss->groupKey && width > 0)
+      Row_printLeftAlignedField(str, CRT_colors[PROCESS_BASENAME], this->cmdline, width - 1);
+   else
+      RichString_appendChr(str, CRT_colors[DEFAULT_COLOR], ' ', width);
+   return true;
+}
+
 void Process_writeField(const Process* this, RichString* str, RowField field) {
    const Row* super = (const Row*) &this->super;
    const Machine* host = super->host;
@@ -551,6 +588,9 @@ void Process_writeField(const Process* this, RichString* str, RowField field) {
    int attr = CRT_colors[DEFAULT_COLOR];
    size_t n = sizeof(buffer) - 1;
 
+   if (Row_isGroup(super) && Process_writeGroupField(this, str, field))
+      return;
+
    switch (field) {
    case COMM: {
       int baseattr = CRT_colors[PROCESS_BASENAME];
@@ -558,33 +598,7 @@ void Process_writeField(const Process* this, RichString* str, RowField field) {
          attr = CRT_colors[PROCESS_THREAD];
          baseattr = CRT_colors[PROCESS_THREAD_BASENAME];
       }
-      const ScreenSettings* ss = settings->ss;
-      if (!ss->treeView || super->indent == 0) {
-         Process_writeCommand(this, attr, baseattr, str);
-         return;
-      }
-
-      char* buf = buffer;
-      const bool lastItem = (super->indent < 0);
-
-      for (uint32_t indent = (super->indent < 0 ? -super->indent : super->indent); indent > 1; indent >>= 1) {
-         if (!n)
-            break;
-
-         int ret;
-         if (indent & 1U) {
-            ret = xSnprintf(buf, n, "%s  ", CRT_treeStr[TREE_STR_VERT]);
-         } else {
-            ret = xSnprintf(buf, n, "   ");
-         }
-         assert(ret > 0 && (size_t)ret < n);
-         buf += ret;
-         n -= ret;
-      }
-
-      const char* draw = CRT_treeStr[lastItem ? TREE_STR_BEND : TREE_STR_RTEE];
-      xSnprintf(buf, n, "%s%s ", draw, super->showChildren ? CRT_treeStr[TREE_STR_SHUT] : CRT_treeStr[TREE_STR_OPEN] );
-      RichString_appendWide(str, CRT_colors[PROCESS_TREE], buffer);
+      Row_printTreeBranch(super, str);
       Process_writeCommand(this, attr, baseattr, str);
       return;
    }
@@ -853,6 +867,73 @@ void Process_init(Process* this, const Machine* host) {
    this->st_uid = (uid_t)-1;
 }
 
+Row* Process_newGroup(const Row* member, const char* key, Process_New constructor) {
+   Process* this = constructor(member->host);
+   free_and_xStrdup(&this->cmdline, key);
+   As_Row(&this->super)->resetGroup(&this->super);
+   return &this->super;
+}
+
+bool Process_rowGroupKey(const Row* super, RowField field, char* buffer, size_t size) {
+   const Process* this = (const Process*) super;
+   assert(Object_isA((const Object*) this, (const ObjectClass*) &Process_class));
+
+   switch (field) {
+   case PGRP:
+      xSnprintf(buffer, size, "%d", this->pgrp);
+      return true;
+   case PROC_EXE:
+      String_safeStrncpy(buffer, this->procExe ? this->procExe : Process_isKernelThread(this) ? kthreadID : "N/A", size);
+      return true;
+   case SESSION:
+      xSnprintf(buffer, size, "%d", this->session);
+      return true;
+   case USER:
+      if (this->user)
+         String_safeStrncpy(buffer, this->user, size);
+      else
+         xSnprintf(buffer, size, "%d", this->st_uid);
+      return true;
+   default:
+      return false;
+   }
+}
+
+void Process_rowAccumulate(Row* super, const Row* memberRow) {
+   Process* this = (Process*) super;
+   const Process* member = (const Process*) memberRow;
+   assert(Object_isA((const Object*) member, (const ObjectClass*) &Process_class));
+
+   /* threads are accounted for in their process already */
+   if (Process_isUserlandThread(member))
+      return;
+
+   if (isNonnegative(member->percent_cpu))
+      this->percent_cpu += member->percent_cpu;
+   if (isNonnegative(member->percent_mem))
+      this->percent_mem += member->percent_mem;
+   this->m_virt += member->m_virt;
+   this->m_resident += member->m_resident;
+   this->nlwp += member->nlwp;
+   this->time += member->time;
+   this->minflt += member->minflt;
+   this->majflt += member->majflt;
+}
+
+void Process_rowResetGroup(Row* super) {
+   Process* this = (Process*) super;
+   assert(Object_isA((const Object*) this, (const ObjectClass*) &Process_class));
+
+   this->percent_cpu = 0.0F;
+   this->percent_mem = 0.0F;
+   this->m_virt = 0;
+   this->m_resident = 0;
+   this->nlwp = 0;
+   this->time = 0;
+   this->minflt = 0;
+   this->majflt = 0;
+}
+
 static bool Process_setPriority(Process* this, int priority) {
    if (Settings_isReadonly())
       return false;
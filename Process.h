@@ -305,6 +305,18 @@ extern const ProcessClass Process_class;
 
 void Process_init(Process* this, const struct Machine_* host);
 
+/* Creates the synthetic row of a group with the platform's constructor, see Row_NewGroup */
+Row* Process_newGroup(const Row* member, const char* key, Process_New constructor);
+
+/* Groups by the fields common to all platforms, see Row_GroupKey */
+bool Process_rowGroupKey(const Row* super, RowField field, char* buffer, size_t size);
+
+/* Sums up the fields common to all platforms, see Row_Accumulate */
+void Process_rowAccumulate(Row* super, const Row* member);
+
+/* Clears the fields summed up by Process_rowAccumulate, see Row_ResetGroup */
+void Process_rowResetGroup(Row* super);
+
 const char* Process_rowGetSortKey(Row* super);
 
 bool Process_rowChangePriorityBy(Row* super, Arg delta);
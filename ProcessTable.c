@@ -13,6 +13,7 @@ in the source distribution for its full text.
 #include <stdlib.h>
 
 #include "Hashtable.h"
+#include "Profile.h"
 #include "Row.h"
 #include "Settings.h"
 #include "Vector.h"
@@ -56,19 +57,25 @@ static void ProcessTable_prepareEntries(Table* super) {
 static void ProcessTable_iterateEntries(Table* super) {
    ProcessTable* this = (ProcessTable*) super;
    // calling into platform-specific code
+   PROFILE_BEGIN(PROFILE_SCAN_ENTRIES);
    ProcessTable_goThroughEntries(this);
+   PROFILE_END(PROFILE_SCAN_ENTRIES);
 }
 
 static void ProcessTable_cleanupEntries(Table* super) {
    Machine* host = super->host;
    const Settings* settings = host->settings;
 
+   PROFILE_BEGIN(PROFILE_CLEANUP);
+
    // Finish process table update, culling any exit'd processes
    for (int i = Vector_size(super->rows) - 1; i >= 0; i--) {
       Process* p = (Process*) Vector_get(super->rows, i);
 
       // tidy up Process state after refreshing the ProcessTable table
+      PROFILE_BEGIN(PROFILE_COMMAND_STR);
       Process_makeCommandStr(p, settings);
+      PROFILE_END(PROFILE_COMMAND_STR);
 
       // keep track of the highest UID for column scaling
       if (p->st_uid > host->maxUserId)
@@ -79,6 +86,8 @@ static void ProcessTable_cleanupEntries(Table* super) {
 
    // compact the table in case of deletions
    Table_compact(super);
+
+   PROFILE_END(PROFILE_CLEANUP);
 }
 
 const TableClass ProcessTable_class = {
@@ -0,0 +1,140 @@
+/*
+htop - Profile.c
+(C) 2024 htop dev team
+Released under the GNU GPLv2+, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "config.h" // IWYU pragma: keep
+
+#include "Profile.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+
+typedef struct ProfileData_ {
+   /* phase entered, but not yet left */
+   uint64_t startNs;
+   uint64_t startCalls;
+
+   /* current tick */
+   uint64_t ns;
+   uint64_t calls;
+   uint32_t entries;
+
+   /* last closed tick */
+   uint64_t lastNs;
+   uint64_t lastCalls;
+   uint32_t lastEntries;
+
+   uint64_t history[PROFILE_HISTORY];
+} ProfileData;
+
+static ProfileData Profile_data[LAST_PROFILE_PHASE];
+static size_t Profile_head;
+static size_t Profile_count;
+
+/* Phases are entered and left on the same thread, so each thread counts on its own */
+static __thread uint64_t Profile_calls;
+
+static const char* const Profile_names[LAST_PROFILE_PHASE] = {
+   [PROFILE_MACHINE_SCAN]     = "Machine_scan",
+   [PROFILE_SCAN_MEMORY]      = "  memory",
+   [PROFILE_SCAN_CPU]         = "  CPU time",
+   [PROFILE_SCAN_FREQUENCY]   = "  frequency",
+   [PROFILE_SCAN_TEMPERATURE] = "  temperature",
+   [PROFILE_SCAN_ENTRIES]     = "goThroughEntries",
+   [PROFILE_READ_STAT]        = "  stat",
+   [PROFILE_READ_STATM]       = "  statm",
+   [PROFILE_READ_STATUS]      = "  status",
+   [PROFILE_READ_CMDLINE]     = "  cmdline",
+   [PROFILE_READ_IO]          = "  io",
+   [PROFILE_READ_SMAPS]       = "  smaps",
+   [PROFILE_READ_CGROUP]      = "  cgroup",
+   [PROFILE_READ_MAPS]        = "  maps",
+   [PROFILE_READ_GPU]         = "  GPU",
+   [PROFILE_READ_DELAYACCT]   = "  delayacct",
+   [PROFILE_CLEANUP]          = "cleanupEntries",
+   [PROFILE_COMMAND_STR]      = "  makeCommandStr",
+   [PROFILE_HEADER_UPDATE]    = "Header_updateData",
+   [PROFILE_SORT]             = "sort",
+   [PROFILE_TREE]             = "tree build",
+   [PROFILE_REBUILD_PANEL]    = "Table_rebuildPanel",
+   [PROFILE_HEADER_DRAW]      = "Header_draw",
+   [PROFILE_PANEL_DRAW]       = "Panel_draw",
+};
+
+static uint64_t Profile_now(void) {
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+void Profile_begin(ProfilePhase phase) {
+   ProfileData* data = &Profile_data[phase];
+   data->startCalls = Profile_calls;
+   data->startNs = Profile_now();
+}
+
+void Profile_end(ProfilePhase phase) {
+   uint64_t now = Profile_now();
+   ProfileData* data = &Profile_data[phase];
+   data->ns += now - data->startNs;
+   data->calls += Profile_calls - data->startCalls;
+   data->entries++;
+}
+
+void Profile_countCalls(unsigned int n) {
+   Profile_calls += n;
+}
+
+void Profile_tick(void) {
+   for (size_t i = 0; i < LAST_PROFILE_PHASE; i++) {
+      ProfileData* data = &Profile_data[i];
+      data->lastNs = data->ns;
+      data->lastCalls = data->calls;
+      data->lastEntries = data->entries;
+      data->history[Profile_head] = data->ns;
+      data->ns = 0;
+      data->calls = 0;
+      data->entries = 0;
+   }
+
+   Profile_head = (Profile_head + 1) % PROFILE_HISTORY;
+   if (Profile_count < PROFILE_HISTORY)
+      Profile_count++;
+}
+
+const char* Profile_phaseName(ProfilePhase phase) {
+   return Profile_names[phase];
+}
+
+static int Profile_compare(const void* a, const void* b) {
+   uint64_t x = *(const uint64_t*)a;
+   uint64_t y = *(const uint64_t*)b;
+   return (x > y) - (x < y);
+}
+
+void Profile_getStats(ProfilePhase phase, ProfileStats* stats) {
+   const ProfileData* data = &Profile_data[phase];
+   stats->lastNs = data->lastNs;
+   stats->lastCalls = data->lastCalls;
+   stats->lastEntries = data->lastEntries;
+
+   if (Profile_count == 0) {
+      stats->p50Ns = stats->p95Ns = stats->p99Ns = 0;
+      return;
+   }
+
+   /* history is filled from slot 0 on, so the first Profile_count slots are used */
+   uint64_t sorted[PROFILE_HISTORY];
+   memcpy(sorted, data->history, Profile_count * sizeof(uint64_t));
+   qsort(sorted, Profile_count, sizeof(uint64_t), Profile_compare);
+
+   /* nearest rank */
+   stats->p50Ns = sorted[(Profile_count * 50 + 99) / 100 - 1];
+   stats->p95Ns = sorted[(Profile_count * 95 + 99) / 100 - 1];
+   stats->p99Ns = sorted[(Profile_count * 99 + 99) / 100 - 1];
+}
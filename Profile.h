@@ -0,0 +1,94 @@
+#ifndef HEADER_Profile
+#define HEADER_Profile
+/*
+htop - Profile.h
+(C) 2024 htop dev team
+Released under the GNU GPLv2+, see the COPYING file
+in the source distribution for its full text.
+*/
+
+/*
+ * Self-profiling of the phases of an update, built with --enable-profiling
+ * and shown by the Profile meter. Otherwise the PROFILE_* macros expand to
+ * nothing.
+ *
+ * Phases are timed on whichever thread runs them; all of them run with the
+ * model lock held (see ScanThread.h), so the counters need no lock of their
+ * own. A tick spans one scan and the screen updates following it.
+ */
+
+#ifdef BUILD_WITH_PROFILING
+
+#include <stddef.h>
+#include <stdint.h>
+
+
+typedef enum ProfilePhase_ {
+   PROFILE_MACHINE_SCAN,
+   PROFILE_SCAN_MEMORY,
+   PROFILE_SCAN_CPU,
+   PROFILE_SCAN_FREQUENCY,
+   PROFILE_SCAN_TEMPERATURE,
+   PROFILE_SCAN_ENTRIES,
+   PROFILE_READ_STAT,
+   PROFILE_READ_STATM,
+   PROFILE_READ_STATUS,
+   PROFILE_READ_CMDLINE,
+   PROFILE_READ_IO,
+   PROFILE_READ_SMAPS,
+   PROFILE_READ_CGROUP,
+   PROFILE_READ_MAPS,
+   PROFILE_READ_GPU,
+   PROFILE_READ_DELAYACCT,
+   PROFILE_CLEANUP,
+   PROFILE_COMMAND_STR,
+   PROFILE_HEADER_UPDATE,
+   PROFILE_SORT,
+   PROFILE_TREE,
+   PROFILE_REBUILD_PANEL,
+   PROFILE_HEADER_DRAW,
+   PROFILE_PANEL_DRAW,
+   LAST_PROFILE_PHASE
+} ProfilePhase;
+
+/* Ticks kept for the percentiles */
+#define PROFILE_HISTORY 128
+
+typedef struct ProfileStats_ {
+   uint64_t lastNs;        /* time spent in the phase during the last tick */
+   uint64_t lastCalls;     /* system calls made through htop's file helpers meanwhile */
+   uint32_t lastEntries;   /* times the phase was entered */
+   uint64_t p50Ns;
+   uint64_t p95Ns;
+   uint64_t p99Ns;
+} ProfileStats;
+
+void Profile_begin(ProfilePhase phase);
+
+void Profile_end(ProfilePhase phase);
+
+/* Counts 'n' system calls of the calling thread */
+void Profile_countCalls(unsigned int n);
+
+/* Closes the current tick */
+void Profile_tick(void);
+
+const char* Profile_phaseName(ProfilePhase phase);
+
+void Profile_getStats(ProfilePhase phase, ProfileStats* stats);
+
+#define PROFILE_BEGIN(phase_)      Profile_begin(phase_)
+#define PROFILE_END(phase_)        Profile_end(phase_)
+#define PROFILE_COUNT_CALLS(n_)    Profile_countCalls(n_)
+#define PROFILE_TICK()             Profile_tick()
+
+#else /* BUILD_WITH_PROFILING */
+
+#define PROFILE_BEGIN(phase_)      ((void)0)
+#define PROFILE_END(phase_)        ((void)0)
+#define PROFILE_COUNT_CALLS(n_)    ((void)0)
+#define PROFILE_TICK()             ((void)0)
+
+#endif /* BUILD_WITH_PROFILING */
+
+#endif
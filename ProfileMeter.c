@@ -0,0 +1,67 @@
+/*
+htop - ProfileMeter.c
+(C) 2024 htop dev team
+Released under the GNU GPLv2+, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "config.h" // IWYU pragma: keep
+
+#include "ProfileMeter.h"
+
+#include "CRT.h"
+#include "Macros.h"
+#include "Object.h"
+#include "Profile.h"
+#include "ProvideCurses.h"
+#include "XUtils.h"
+
+
+static void ProfileMeter_updateMode(Meter* this, MeterModeId mode) {
+   this->mode = mode;
+   this->h = 1 + LAST_PROFILE_PHASE;
+}
+
+static void ProfileMeter_updateValues(ATTR_UNUSED Meter* this) {
+   /* the phases are counted as they run */
+}
+
+static void ProfileMeter_draw(Meter* this, int x, int y, int w) {
+   char line[128];
+
+   xSnprintf(line, sizeof(line), "%-20s %8s %8s %8s %8s %6s %8s",
+             Meter_getCaption(this), "last ms", "p50", "p95", "p99", "count", "syscalls");
+   attrset(CRT_colors[METER_TEXT]);
+   mvaddnstr(y, x, line, w);
+
+   for (int i = 0; i < LAST_PROFILE_PHASE && i + 1 < this->h; i++) {
+      ProfileStats stats;
+      Profile_getStats((ProfilePhase)i, &stats);
+
+      xSnprintf(line, sizeof(line), "%-20s %8.2f %8.2f %8.2f %8.2f %6u %8llu",
+                Profile_phaseName((ProfilePhase)i),
+                stats.lastNs / 1e6, stats.p50Ns / 1e6, stats.p95Ns / 1e6, stats.p99Ns / 1e6,
+                (unsigned int)stats.lastEntries, (unsigned long long)stats.lastCalls);
+      attrset(CRT_colors[stats.lastEntries ? METER_VALUE : METER_SHADOW]);
+      mvaddnstr(y + 1 + i, x, line, w);
+   }
+
+   attrset(CRT_colors[RESET_COLOR]);
+}
+
+const MeterClass ProfileMeter_class = {
+   .super = {
+      .extends = Class(Meter),
+      .delete = Meter_delete
+   },
+   .updateValues = ProfileMeter_updateValues,
+   .defaultMode = TEXT_METERMODE,
+   .supportedModes = (1 << TEXT_METERMODE),
+   .total = 0.0,
+   .name = "Profile",
+   .uiName = "htop self-profile",
+   .description = "htop self-profile: time and system calls per update phase",
+   .caption = "phase",
+   .draw = ProfileMeter_draw,
+   .updateMode = ProfileMeter_updateMode
+};
@@ -105,6 +105,9 @@ void Row_setUidColumnWidth(uid_t maxUid) {
 
 uint8_t Row_fieldWidths[LAST_PROCESSFIELD] = { 0 };
 
+/* Widths seen during the current scan, which may also shrink the shown ones */
+static uint8_t Row_scanFieldWidths[LAST_PROCESSFIELD] = { 0 };
+
 void Row_resetFieldWidths(void) {
    for (size_t i = 0; i < LAST_PROCESSFIELD; i++) {
       if (!Process_fields[i].autoWidth)
@@ -112,15 +115,26 @@ void Row_resetFieldWidths(void) {
 
       size_t len = strlen(Process_fields[i].title);
       assert(len <= UINT8_MAX);
-      Row_fieldWidths[i] = (uint8_t)len;
+      Row_scanFieldWidths[i] = (uint8_t)len;
    }
 }
 
 void Row_updateFieldWidth(RowField key, size_t width) {
-   if (width > UINT8_MAX)
-      Row_fieldWidths[key] = UINT8_MAX;
-   else if (width > Row_fieldWidths[key])
-      Row_fieldWidths[key] = (uint8_t)width;
+   uint8_t clamped = width > UINT8_MAX ? UINT8_MAX : (uint8_t)width;
+
+   if (clamped > Row_scanFieldWidths[key])
+      Row_scanFieldWidths[key] = clamped;
+
+   /* Grow right away, rows drawn while the scan is still running must fit */
+   if (clamped > Row_fieldWidths[key])
+      Row_fieldWidths[key] = clamped;
+}
+
+void Row_commitFieldWidths(void) {
+   for (size_t i = 0; i < LAST_PROCESSFIELD; i++) {
+      if (Process_fields[i].autoWidth)
+         Row_fieldWidths[i] = Row_scanFieldWidths[i];
+   }
 }
 
 // helper function to fill an aligned title string for a dynamic column
@@ -499,6 +513,36 @@ void Row_printLeftAlignedField(RichString* str, int attr, const char* content, u
    RichString_appendChr(str, attr, ' ', width + 1 - columns);
 }
 
+void Row_printTreeBranch(const Row* this, RichString* str) {
+   const ScreenSettings* ss = this->host->settings->ss;
+   if (!(ss->treeView || ss->groupKey) || this->indent == 0)
+      return;
+
+   char buffer[256];
+   char* buf = buffer;
+   size_t n = sizeof(buffer) - 1;
+   const bool lastItem = (this->indent < 0);
+
+   for (uint32_t indent = (this->indent < 0 ? -this->indent : this->indent); indent > 1; indent >>= 1) {
+      if (!n)
+         break;
+
+      int ret;
+      if (indent & 1U) {
+         ret = xSnprintf(buf, n, "%s  ", CRT_treeStr[TREE_STR_VERT]);
+      } else {
+         ret = xSnprintf(buf, n, "   ");
+      }
+      assert(ret > 0 && (size_t)ret < n);
+      buf += ret;
+      n -= ret;
+   }
+
+   const char* draw = CRT_treeStr[lastItem ? TREE_STR_BEND : TREE_STR_RTEE];
+   xSnprintf(buf, n, "%s%s ", draw, this->showChildren ? CRT_treeStr[TREE_STR_SHUT] : CRT_treeStr[TREE_STR_OPEN] );
+   RichString_appendWide(str, CRT_colors[PROCESS_TREE], buffer);
+}
+
 int Row_printPercentage(float val, char* buffer, size_t n, uint8_t width, int* attr) {
    assert(n >= 6 && width >= 4 && "Invalid width in Row_printPercentage()");
    // truncate in favour of abort in xSnprintf()
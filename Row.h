@@ -63,6 +63,9 @@ typedef struct Row_ {
    /* Whether the row was updated during the last scan */
    bool updated;
 
+   /* Number of rows summed up by this synthetic group row, 0 for other rows */
+   unsigned int groupMembers;
+
    /*
     * Internal state for tree-mode.
     */
@@ -83,6 +86,10 @@ typedef bool (*Row_IsVisible)(const Row*, const struct Table_*);
 typedef bool (*Row_MatchesFilter)(const Row*, const struct Table_*);
 typedef const char* (*Row_SortKeyString)(Row*);
 typedef int (*Row_CompareByParent)(const Row*, const Row*);
+typedef bool (*Row_GroupKey)(const Row*, RowField, char*, size_t);
+typedef Row* (*Row_NewGroup)(const Row*, const char*);
+typedef void (*Row_Accumulate)(Row*, const Row*);
+typedef void (*Row_ResetGroup)(Row*);
 
 int Row_compare(const void* v1, const void* v2);
 
@@ -94,6 +101,14 @@ typedef struct RowClass_ {
    const Row_MatchesFilter matchesFilter;
    const Row_SortKeyString sortKeyString;
    const Row_CompareByParent compareByParent;
+   /* Optional grouping support, see Table_updateDisplayList:
+    * groupKey writes the key of a row for a field, false if rows cannot be grouped by it;
+    * newGroup creates an empty synthetic row for a key; accumulate sums a member up into it;
+    * resetGroup empties a synthetic row again, so it can be reused by the next build */
+   const Row_GroupKey groupKey;
+   const Row_NewGroup newGroup;
+   const Row_Accumulate accumulate;
+   const Row_ResetGroup resetGroup;
 } RowClass;
 
 #define As_Row(this_)  ((const RowClass*)((this_)->super.klass))
@@ -102,6 +117,7 @@ typedef struct RowClass_ {
 #define Row_isVisible(r_, t_)  (As_Row(r_)->isVisible ? (As_Row(r_)->isVisible(r_, t_)) : true)
 #define Row_matchesFilter(r_, t_)  (As_Row(r_)->matchesFilter ? (As_Row(r_)->matchesFilter(r_, t_)) : false)
 #define Row_sortKeyString(r_)  (As_Row(r_)->sortKeyString ? (As_Row(r_)->sortKeyString(r_)) : "")
+#define Row_groupKey(r_, f_, b_, n_)  (As_Row(r_)->groupKey ? (As_Row(r_)->groupKey(r_, f_, b_, n_)) : false)
 #define Row_compareByParent(r1_, r2_)  (As_Row(r1_)->compareByParent ? (As_Row(r1_)->compareByParent(r1_, r2_)) : Row_compareByParent_Base(r1_, r2_))
 
 #define ONE_K 1024UL
@@ -130,6 +146,9 @@ void Row_resetFieldWidths(void);
 
 void Row_updateFieldWidth(RowField key, size_t width);
 
+/* Makes the widths seen during the scan the shown ones */
+void Row_commitFieldWidths(void);
+
 void Row_printLeftAlignedField(RichString* str, int attr, const char* content, unsigned int width);
 
 const char* RowField_alignedTitle(const struct Settings_* settings, RowField field);
@@ -160,6 +179,9 @@ void Row_printNanoseconds(RichString* str, unsigned long long totalNanoseconds,
 /* Takes rate in bare unit (base 1024) per second. Prints 12 columns. */
 void Row_printRate(RichString* str, double rate, bool coloring);
 
+/* Draws the tree-view branch in front of the row's name, if in tree view or a group member */
+void Row_printTreeBranch(const Row* this, RichString* str);
+
 int Row_printPercentage(float val, char* buffer, size_t n, uint8_t width, int* attr);
 
 static inline int Row_idEqualCompare(const void* v1, const void* v2) {
@@ -168,6 +190,10 @@ static inline int Row_idEqualCompare(const void* v1, const void* v2) {
    return p1 != p2; /* return zero when equal */
 }
 
+static inline bool Row_isGroup(const Row* this) {
+   return this->groupMembers > 0;
+}
+
 /* Routines used primarily with the tree view */
 static inline int Row_getGroupOrParent(const Row* this) {
    return this->group == this->id ? this->parent : this->group;
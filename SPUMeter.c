@@ -33,19 +33,33 @@ static const int SPUMeter_attributes[] = {
    CPU_SOFTIRQ,
    CPU_STEAL,
    CPU_GUEST,
-   CPU_IOWAIT
+   CPU_IOWAIT,
+   SPU_RESIDUE
 };
 
+/* Number of rows of the TopSPUs meter */
+#define SPU_TOP_COUNT 4
+
 typedef struct SPUMeterData_ {
-   unsigned int spus;
+   int count;             /* number of sub meters, fixed at initialization */
+   int shown;             /* number of sub meters drawn */
    Meter** meters;
+   unsigned int* order;   /* sub meters ranked by usage, NULL if not ranked */
 } SPUMeterData;
 
+/* Number of average meters, which show the SPU time not attributed to any process */
+static size_t activeMeters;
+
+bool SPUMeter_active(void) {
+   return activeMeters > 0;
+}
+
 static void SPUMeter_init(Meter* this) {
    unsigned int spu = this->param;
    const Machine* host = this->host;
    if (spu == 0) {
       Meter_setCaption(this, "Avg");
+      activeMeters++;
    } else if (host->activeSPUs > 1) {
       char caption[10];
       xSnprintf(caption, sizeof(caption), "%3u", Settings_spuId(host->settings, spu - 1));
@@ -53,6 +67,13 @@ static void SPUMeter_init(Meter* this) {
    }
 }
 
+static void SPUMeter_done(Meter* this) {
+   if (this->param == 0) {
+      assert(activeMeters > 0);
+      activeMeters--;
+   }
+}
+
 // Custom uiName runtime logic to include the param (processor)
 static void SPUMeter_getUiName(const Meter* this, char* buffer, size_t length) {
    assert(length > 0);
@@ -63,19 +84,9 @@ static void SPUMeter_getUiName(const Meter* this, char* buffer, size_t length) {
       xSnprintf(buffer, length, "%s", Meter_uiName(this));
 }
 
-static void SPUMeter_updateValues(Meter* this) {
-   memset(this->values, 0, sizeof(double) * SPU_METER_ITEMCOUNT);
-
-   const Machine* host = this->host;
-   const Settings* settings = host->settings;
-
-   unsigned int spu = this->param;
-   if (spu > host->existingSPUs) {
-      xSnprintf(this->txtBuffer, sizeof(this->txtBuffer), "absent");
-      return;
-   }
+static void SPUMeter_formatText(Meter* this, double percent) {
+   const Settings* settings = this->host->settings;
 
-   double percent = Platform_setSPUValues(this, spu);
    if (!isNonnegative(percent)) {
       xSnprintf(this->txtBuffer, sizeof(this->txtBuffer), "offline");
       return;
@@ -118,6 +129,34 @@ static void SPUMeter_updateValues(Meter* this) {
              spuTemperatureBuffer);
 }
 
+static void SPUMeter_updateValues(Meter* this) {
+   memset(this->values, 0, sizeof(double) * SPU_METER_ITEMCOUNT);
+
+   const Machine* host = this->host;
+
+   unsigned int spu = this->param;
+   if (spu > host->existingSPUs) {
+      xSnprintf(this->txtBuffer, sizeof(this->txtBuffer), "absent");
+      return;
+   }
+
+   double percent = Platform_setSPUValues(this, spu);
+   SPUMeter_formatText(this, percent);
+}
+
+static void SPUNodeMeter_init(Meter* this) {
+   char caption[10];
+   xSnprintf(caption, sizeof(caption), "N%u", this->param - 1);
+   Meter_setCaption(this, caption);
+}
+
+static void SPUNodeMeter_updateValues(Meter* this) {
+   memset(this->values, 0, sizeof(double) * SPU_METER_ITEMCOUNT);
+
+   double percent = Platform_setSPUNodeValues(this, this->param - 1);
+   SPUMeter_formatText(this, percent);
+}
+
 static void SPUMeter_display(const Object* cast, RichString* out) {
    char buffer[50];
    int len;
@@ -178,6 +217,12 @@ static void SPUMeter_display(const Object* cast, RichString* out) {
       }
    }
 
+   if (isNonnegative(this->values[SPU_METER_RESIDUE])) {
+      len = xSnprintf(buffer, sizeof(buffer), "%5.1f%% ", this->values[SPU_METER_RESIDUE]);
+      RichString_appendAscii(out, CRT_colors[METER_TEXT], "res:");
+      RichString_appendnAscii(out, CRT_colors[SPU_RESIDUE], buffer, len);
+   }
+
    if (settings->showSPUFrequency) {
       char spuFrequencyBuffer[10];
       double spuFrequency = this->values[SPU_METER_FREQUENCY];
@@ -212,6 +257,7 @@ static void AllSPUsMeter_getRange(const Meter* this, int* start, int* count) {
    switch (Meter_name(this)[0]) {
       default:
       case 'A': // All
+      case 'T': // Top
          *start = 0;
          *count = spus;
          break;
@@ -226,60 +272,66 @@ static void AllSPUsMeter_getRange(const Meter* this, int* start, int* count) {
    }
 }
 
+static Meter* SPUMeterData_get(const SPUMeterData* data, int i) {
+   return data->meters[data->order ? data->order[i] : (unsigned int)i];
+}
+
 static void AllSPUsMeter_updateValues(Meter* this) {
    SPUMeterData* data = this->meterData;
-   Meter** meters = data->meters;
-   int start, count;
-   AllSPUsMeter_getRange(this, &start, &count);
-   for (int i = 0; i < count; i++)
-      Meter_updateValues(meters[i]);
+   for (int i = 0; i < data->count; i++) {
+      Meter_updateValues(data->meters[i]);
+      Meter_recordHistory(data->meters[i]);
+   }
 }
 
-static void SPUMeterCommonInit(Meter* this) {
-   int start, count;
-   AllSPUsMeter_getRange(this, &start, &count);
-
+/* Sub meters are created once, SPUs added later by hotplug are not shown */
+static void SPUMeterCommonInitRange(Meter* this, const MeterClass* type, int start, int count, int shown) {
    SPUMeterData* data = this->meterData;
    if (!data) {
       data = this->meterData = xMalloc(sizeof(SPUMeterData));
-      data->spus = this->host->existingSPUs;
+      data->count = count;
+      data->shown = shown;
       data->meters = count ? xCalloc(count, sizeof(Meter*)) : NULL;
+      data->order = NULL;
    }
 
    Meter** meters = data->meters;
-   for (int i = 0; i < count; i++) {
+   for (int i = 0; i < data->count; i++) {
       if (!meters[i])
-         meters[i] = Meter_new(this->host, start + i + 1, (const MeterClass*) Class(SPUMeter));
+         meters[i] = Meter_new(this->host, start + i + 1, type);
 
       Meter_init(meters[i]);
    }
 }
 
+static void SPUMeterCommonInit(Meter* this) {
+   int start, count;
+   AllSPUsMeter_getRange(this, &start, &count);
+   SPUMeterCommonInitRange(this, (const MeterClass*) Class(SPUMeter), start, count, count);
+}
+
 static void SPUMeterCommonUpdateMode(Meter* this, MeterModeId mode, int ncol) {
    SPUMeterData* data = this->meterData;
    Meter** meters = data->meters;
    this->mode = mode;
-   int start, count;
-   AllSPUsMeter_getRange(this, &start, &count);
-   if (!count) {
+   if (!data->shown) {
       this->h = 1;
       return;
    }
-   for (int i = 0; i < count; i++) {
+   for (int i = 0; i < data->count; i++) {
       Meter_setMode(meters[i], mode);
    }
    int h = meters[0]->h;
    assert(h > 0);
-   this->h = h * ((count + ncol - 1) / ncol);
+   this->h = h * ((data->shown + ncol - 1) / ncol);
 }
 
 static void AllSPUsMeter_done(Meter* this) {
    SPUMeterData* data = this->meterData;
    Meter** meters = data->meters;
-   int start, count;
-   AllSPUsMeter_getRange(this, &start, &count);
-   for (int i = 0; i < count; i++)
+   for (int i = 0; i < data->count; i++)
       Meter_delete((Object*)meters[i]);
+   free(data->order);
    free(data->meters);
    free(data);
 }
@@ -302,17 +354,16 @@ static void OctoColSPUsMeter_updateMode(Meter* this, MeterModeId mode) {
 
 static void SPUMeterCommonDraw(Meter* this, int x, int y, int w, int ncol) {
    SPUMeterData* data = this->meterData;
-   Meter** meters = data->meters;
-   int start, count;
-   AllSPUsMeter_getRange(this, &start, &count);
+   int count = data->shown;
    int colwidth = w / ncol;
    int diff = w % ncol;
    int nrows = (count + ncol - 1) / ncol;
    for (int i = 0; i < count; i++) {
+      Meter* meter = SPUMeterData_get(data, i);
       int d = (i / nrows) > diff ? diff : (i / nrows); // dynamic spacer
       int xpos = x + ((i / nrows) * colwidth) + d;
-      int ypos = y + ((i % nrows) * meters[0]->h);
-      meters[i]->draw(meters[i], xpos, ypos, colwidth);
+      int ypos = y + ((i % nrows) * meter->h);
+      meter->draw(meter, xpos, ypos, colwidth);
    }
 }
 
@@ -331,15 +382,76 @@ static void OctoColSPUsMeter_draw(Meter* this, int x, int y, int w) {
 
 static void SingleColSPUsMeter_draw(Meter* this, int x, int y, int w) {
    SPUMeterData* data = this->meterData;
-   Meter** meters = data->meters;
+   for (int i = 0; i < data->shown; i++) {
+      Meter* meter = SPUMeterData_get(data, i);
+      meter->draw(meter, x, y, w);
+      y += meter->h;
+   }
+}
+
+static const MeterClass SPUNodeMeter_class = {
+   .super = {
+      .extends = Class(Meter),
+      .delete = Meter_delete,
+      .display = SPUMeter_display
+   },
+   .updateValues = SPUNodeMeter_updateValues,
+   .defaultMode = BAR_METERMODE,
+   .supportedModes = METERMODE_DEFAULT_SUPPORTED,
+   .maxItems = SPU_METER_ITEMCOUNT,
+   .total = 100.0,
+   .attributes = SPUMeter_attributes,
+   .name = "SPUNode",
+   .uiName = "SPU node",
+   .caption = "N",
+   .init = SPUNodeMeter_init
+};
+
+static void SPUNodesMeter_init(Meter* this) {
+   int count = this->host->existingSPUNodes;
+   SPUMeterCommonInitRange(this, (const MeterClass*) Class(SPUNodeMeter), 0, count, count);
+}
+
+static void TopSPUsMeter_init(Meter* this) {
    int start, count;
    AllSPUsMeter_getRange(this, &start, &count);
-   for (int i = 0; i < count; i++) {
-      meters[i]->draw(meters[i], x, y, w);
-      y += meters[i]->h;
+   SPUMeterCommonInitRange(this, (const MeterClass*) Class(SPUMeter), start, count, MINIMUM(count, SPU_TOP_COUNT));
+
+   SPUMeterData* data = this->meterData;
+   if (!data->order && data->count) {
+      data->order = xMallocArray(data->count, sizeof(unsigned int));
+      for (int i = 0; i < data->count; i++)
+         data->order[i] = i;
    }
 }
 
+static double SPUMeter_busy(const Meter* meter) {
+   if (meter->curItems == 0)
+      return -1.0;
+
+   return meter->values[SPU_METER_NORMAL] + meter->values[SPU_METER_KERNEL];
+}
+
+/* Re-rank the SPUs on every update; ties keep the SPU order */
+static void TopSPUsMeter_updateValues(Meter* this) {
+   SPUMeterData* data = this->meterData;
+   AllSPUsMeter_updateValues(this);
+
+   for (int i = 0; i < data->count; i++)
+      data->order[i] = i;
+
+   for (int i = 0; i < data->shown; i++) {
+      int best = i;
+      for (int j = i + 1; j < data->count; j++) {
+         if (SPUMeter_busy(data->meters[data->order[j]]) > SPUMeter_busy(data->meters[data->order[best]]))
+            best = j;
+      }
+
+      unsigned int tmp = data->order[best];
+      memmove(&data->order[i + 1], &data->order[i], (best - i) * sizeof(unsigned int));
+      data->order[i] = tmp;
+   }
+}
 
 const MeterClass SPUMeter_class = {
    .super = {
@@ -357,7 +469,8 @@ const MeterClass SPUMeter_class = {
    .name = "SPU",
    .uiName = "SPU",
    .caption = "SPU",
-   .init = SPUMeter_init
+   .init = SPUMeter_init,
+   .done = SPUMeter_done
 };
 
 const MeterClass AllSPUsMeter_class = {
@@ -622,3 +735,45 @@ const MeterClass RightSPUs8Meter_class = {
    .updateMode = OctoColSPUsMeter_updateMode,
    .done = AllSPUsMeter_done
 };
+
+const MeterClass SPUNodesMeter_class = {
+   .super = {
+      .extends = Class(Meter),
+      .delete = Meter_delete,
+      .display = SPUMeter_display
+   },
+   .updateValues = AllSPUsMeter_updateValues,
+   .defaultMode = BAR_METERMODE,
+   .supportedModes = METERMODE_DEFAULT_SUPPORTED,
+   .total = 100.0,
+   .attributes = SPUMeter_attributes,
+   .name = "SPUNodes",
+   .uiName = "SPU chips",
+   .description = "SPU chips: average of the SPUs of each Cell chip (NUMA node)",
+   .caption = "SPU",
+   .draw = SingleColSPUsMeter_draw,
+   .init = SPUNodesMeter_init,
+   .updateMode = SingleColSPUsMeter_updateMode,
+   .done = AllSPUsMeter_done
+};
+
+const MeterClass TopSPUsMeter_class = {
+   .super = {
+      .extends = Class(Meter),
+      .delete = Meter_delete,
+      .display = SPUMeter_display
+   },
+   .updateValues = TopSPUsMeter_updateValues,
+   .defaultMode = BAR_METERMODE,
+   .supportedModes = METERMODE_DEFAULT_SUPPORTED,
+   .total = 100.0,
+   .attributes = SPUMeter_attributes,
+   .name = "TopSPUs",
+   .uiName = "SPUs (top 4)",
+   .description = "SPUs (top 4): the four busiest SPUs",
+   .caption = "SPU",
+   .draw = SingleColSPUsMeter_draw,
+   .init = TopSPUsMeter_init,
+   .updateMode = SingleColSPUsMeter_updateMode,
+   .done = AllSPUsMeter_done
+};
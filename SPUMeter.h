@@ -3,6 +3,8 @@
 
 #define FAKE_SPU
 
+#include <stdbool.h>
+
 #include "Meter.h"
 
 typedef enum {
@@ -14,13 +16,16 @@ typedef enum {
    SPU_METER_STEAL = 5,
    SPU_METER_GUEST = 6,
    SPU_METER_IOWAIT = 7,
-   SPU_METER_FREQUENCY = 8,
-   SPU_METER_TEMPERATURE = 9,
-   SPU_METER_ITEMCOUNT = 10, // number of entries in this enum
+   SPU_METER_RESIDUE = 8,
+   SPU_METER_FREQUENCY = 9,
+   SPU_METER_TEMPERATURE = 10,
+   SPU_METER_ITEMCOUNT = 11, // number of entries in this enum
 } SPUMeterValues;
 
 extern const MeterClass SPUMeter_class;
 
+bool SPUMeter_active(void);
+
 extern const MeterClass AllSPUsMeter_class;
 
 extern const MeterClass AllSPUs2Meter_class;
@@ -45,4 +50,8 @@ extern const MeterClass LeftSPUs8Meter_class;
 
 extern const MeterClass RightSPUs8Meter_class;
 
+extern const MeterClass SPUNodesMeter_class;
+
+extern const MeterClass TopSPUsMeter_class;
+
 #endif
\ No newline at end of file
@@ -0,0 +1,291 @@
+/*
+htop - ScanThread.c
+(C) 2024 htop dev team
+Released under the GNU GPLv2+, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "config.h" // IWYU pragma: keep
+
+#include "ScanThread.h"
+
+#include <signal.h>
+#include <stdlib.h>
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#include "Header.h"
+#include "Machine.h"
+#include "Macros.h"
+#include "Platform.h"
+#include "Profile.h"
+#include "XUtils.h"
+
+
+void ScanThread_scan(Machine* host, Header* header, bool scanTables) {
+   PROFILE_TICK();
+
+   uint64_t start;
+   Platform_gettime_monotonic(&start);
+
+   PROFILE_BEGIN(PROFILE_MACHINE_SCAN);
+   Machine_scan(host);
+   PROFILE_END(PROFILE_MACHINE_SCAN);
+
+   /* The phases leave the model consistent, let a waiting UI in between them too */
+   Machine_yield(host);
+
+   if (scanTables) {
+      Machine_scanTables(host);
+      Machine_yield(host);
+   }
+
+   // always update header, especially to avoid gaps in graph meters
+   if (header) {
+      PROFILE_BEGIN(PROFILE_HEADER_UPDATE);
+      Header_updateData(header);
+      PROFILE_END(PROFILE_HEADER_UPDATE);
+   }
+
+   uint64_t end;
+   Platform_gettime_monotonic(&end);
+   host->scanMs = end > start ? end - start : 0;
+
+   Machine_updateRefreshDelay(host);
+}
+
+#ifdef HAVE_PTHREAD
+
+struct ScanThread_ {
+   Machine* host;
+   Header* header;
+   pthread_t thread;
+
+   pthread_mutex_t modelLock;
+   unsigned int uiDepth;         /* levels of the model lock held by the UI thread */
+
+   pthread_mutex_t lock;         /* guards the state below */
+   pthread_cond_t wakeup;        /* a scan was requested, or the thread is to stop */
+   pthread_cond_t handover;      /* the UI thread got the model lock */
+   unsigned int uiWaiting;
+   bool requested;
+   bool requestTables;
+   bool scanning;
+   bool completed;
+   bool stop;
+};
+
+static void* ScanThread_run(void* arg) {
+   ScanThread* this = arg;
+
+   pthread_mutex_lock(&this->lock);
+   for (;;) {
+      while (!this->requested && !this->stop)
+         pthread_cond_wait(&this->wakeup, &this->lock);
+
+      if (this->stop)
+         break;
+
+      bool scanTables = this->requestTables;
+      this->requested = false;
+      this->requestTables = false;
+      this->scanning = true;
+      pthread_mutex_unlock(&this->lock);
+
+      pthread_mutex_lock(&this->modelLock);
+      ScanThread_scan(this->host, this->header, scanTables);
+
+      /* Flag completion before releasing the model, so the UI never sees stale rows */
+      pthread_mutex_lock(&this->lock);
+      this->scanning = false;
+      this->completed = true;
+      pthread_mutex_unlock(&this->modelLock);
+   }
+   pthread_mutex_unlock(&this->lock);
+
+   return NULL;
+}
+
+ScanThread* ScanThread_new(Machine* host, Header* header) {
+   ScanThread* this = xCalloc(1, sizeof(ScanThread));
+   this->host = host;
+   this->header = header;
+   pthread_mutex_init(&this->modelLock, NULL);
+   pthread_mutex_init(&this->lock, NULL);
+   pthread_cond_init(&this->wakeup, NULL);
+   pthread_cond_init(&this->handover, NULL);
+
+   /* Leave signals to the UI thread, whose handlers restore the terminal */
+   sigset_t all;
+   sigset_t previous;
+   sigfillset(&all);
+   pthread_sigmask(SIG_BLOCK, &all, &previous);
+   int r = pthread_create(&this->thread, NULL, ScanThread_run, this);
+   pthread_sigmask(SIG_SETMASK, &previous, NULL);
+
+   if (r != 0) {
+      pthread_cond_destroy(&this->handover);
+      pthread_cond_destroy(&this->wakeup);
+      pthread_mutex_destroy(&this->lock);
+      pthread_mutex_destroy(&this->modelLock);
+      free(this);
+      return NULL;
+   }
+
+   return this;
+}
+
+void ScanThread_delete(ScanThread* this) {
+   if (!this)
+      return;
+
+   pthread_mutex_lock(&this->lock);
+   this->stop = true;
+   pthread_cond_signal(&this->wakeup);
+   pthread_mutex_unlock(&this->lock);
+
+   (void) ScanThread_release(this);
+   pthread_join(this->thread, NULL);
+
+   pthread_cond_destroy(&this->handover);
+   pthread_cond_destroy(&this->wakeup);
+   pthread_mutex_destroy(&this->lock);
+   pthread_mutex_destroy(&this->modelLock);
+   free(this);
+}
+
+void ScanThread_request(ScanThread* this, bool scanTables) {
+   if (!this)
+      return;
+
+   pthread_mutex_lock(&this->lock);
+   this->requested = true;
+   this->requestTables |= scanTables;
+   pthread_cond_signal(&this->wakeup);
+   pthread_mutex_unlock(&this->lock);
+}
+
+bool ScanThread_isBusy(ScanThread* this) {
+   if (!this)
+      return false;
+
+   pthread_mutex_lock(&this->lock);
+   bool busy = this->requested || this->scanning;
+   pthread_mutex_unlock(&this->lock);
+   return busy;
+}
+
+bool ScanThread_takeCompleted(ScanThread* this) {
+   if (!this)
+      return false;
+
+   pthread_mutex_lock(&this->lock);
+   bool completed = this->completed;
+   this->completed = false;
+   pthread_mutex_unlock(&this->lock);
+   return completed;
+}
+
+void ScanThread_lock(ScanThread* this) {
+   if (!this)
+      return;
+
+   if (this->uiDepth++ > 0)
+      return;
+
+   pthread_mutex_lock(&this->lock);
+   this->uiWaiting++;
+   pthread_mutex_unlock(&this->lock);
+
+   pthread_mutex_lock(&this->modelLock);
+
+   pthread_mutex_lock(&this->lock);
+   this->uiWaiting--;
+   pthread_cond_broadcast(&this->handover);
+   pthread_mutex_unlock(&this->lock);
+}
+
+void ScanThread_unlock(ScanThread* this) {
+   if (!this)
+      return;
+
+   if (--this->uiDepth > 0)
+      return;
+
+   pthread_mutex_unlock(&this->modelLock);
+}
+
+unsigned int ScanThread_release(ScanThread* this) {
+   if (!this)
+      return 0;
+
+   unsigned int depth = this->uiDepth;
+   if (depth > 0) {
+      this->uiDepth = 1;
+      ScanThread_unlock(this);
+   }
+   return depth;
+}
+
+void ScanThread_reacquire(ScanThread* this, unsigned int depth) {
+   if (!this || depth == 0)
+      return;
+
+   ScanThread_lock(this);
+   this->uiDepth = depth;
+}
+
+void ScanThread_yield(ScanThread* this) {
+   if (!this || !pthread_equal(pthread_self(), this->thread))
+      return;
+
+   pthread_mutex_lock(&this->lock);
+   bool waiting = this->uiWaiting > 0;
+   pthread_mutex_unlock(&this->lock);
+   if (!waiting)
+      return;
+
+   pthread_mutex_unlock(&this->modelLock);
+
+   /* Relocking right away could win the mutex again, wait for the UI to have it */
+   pthread_mutex_lock(&this->lock);
+   while (this->uiWaiting > 0)
+      pthread_cond_wait(&this->handover, &this->lock);
+   pthread_mutex_unlock(&this->lock);
+
+   pthread_mutex_lock(&this->modelLock);
+}
+
+#else /* HAVE_PTHREAD */
+
+ScanThread* ScanThread_new(ATTR_UNUSED Machine* host, ATTR_UNUSED Header* header) {
+   return NULL;
+}
+
+void ScanThread_delete(ATTR_UNUSED ScanThread* this) { }
+
+void ScanThread_request(ATTR_UNUSED ScanThread* this, ATTR_UNUSED bool scanTables) { }
+
+bool ScanThread_isBusy(ATTR_UNUSED ScanThread* this) {
+   return false;
+}
+
+bool ScanThread_takeCompleted(ATTR_UNUSED ScanThread* this) {
+   return false;
+}
+
+void ScanThread_lock(ATTR_UNUSED ScanThread* this) { }
+
+void ScanThread_unlock(ATTR_UNUSED ScanThread* this) { }
+
+unsigned int ScanThread_release(ATTR_UNUSED ScanThread* this) {
+   return 0;
+}
+
+void ScanThread_reacquire(ATTR_UNUSED ScanThread* this, ATTR_UNUSED unsigned int depth) { }
+
+void ScanThread_yield(ATTR_UNUSED ScanThread* this) { }
+
+#endif /* HAVE_PTHREAD */
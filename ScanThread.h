@@ -0,0 +1,61 @@
+#ifndef HEADER_ScanThread
+#define HEADER_ScanThread
+/*
+htop - ScanThread.h
+(C) 2024 htop dev team
+Released under the GNU GPLv2+, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+
+struct Header_;
+struct Machine_;
+
+/*
+ * Runs Machine_scan, Machine_scanTables and Header_updateData in the
+ * background, so input is handled while a scan is in progress.
+ *
+ * Machine, tables and header are only touched with the model lock held.
+ * The UI thread holds it except while waiting for input; the scan thread
+ * holds it while scanning, but hands it over between two processes
+ * (ScanThread_yield) whenever the UI thread asks for it.
+ *
+ * All functions accept NULL, for builds without threads, where the scan
+ * runs synchronously as before.
+ */
+typedef struct ScanThread_ ScanThread;
+
+/* Runs one scan in the calling thread */
+void ScanThread_scan(struct Machine_* host, struct Header_* header, bool scanTables);
+
+ScanThread* ScanThread_new(struct Machine_* host, struct Header_* header);
+
+/* Stops the thread after an ongoing scan */
+void ScanThread_delete(ScanThread* this);
+
+/* Asks for a scan; requests while one is running are merged into the next */
+void ScanThread_request(ScanThread* this, bool scanTables);
+
+/* Whether a scan is requested or running */
+bool ScanThread_isBusy(ScanThread* this);
+
+/* Whether a scan finished since the last call; the model lock must be held */
+bool ScanThread_takeCompleted(ScanThread* this);
+
+/* Model lock of the UI thread; nested calls are counted */
+void ScanThread_lock(ScanThread* this);
+
+void ScanThread_unlock(ScanThread* this);
+
+/* Releases all levels of the model lock while waiting for input */
+unsigned int ScanThread_release(ScanThread* this);
+
+void ScanThread_reacquire(ScanThread* this, unsigned int depth);
+
+/* Called by the scan between two rows, hands the model lock to a waiting UI thread */
+void ScanThread_yield(ScanThread* this);
+
+#endif
@@ -11,6 +11,7 @@ in the source distribution for its full text.
 
 #include <assert.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include <sys/time.h>
@@ -22,12 +23,17 @@ in the source distribution for its full text.
 #include "Object.h"
 #include "Platform.h"
 #include "Process.h"
+#include "Profile.h"
 #include "ProvideCurses.h"
+#include "ScanThread.h"
 #include "Settings.h"
 #include "Table.h"
 #include "XUtils.h"
 
 
+/* Milliseconds between two checks for a finished scan, while one is running in the background */
+#define SCREENMANAGER_SCAN_POLL 20
+
 ScreenManager* ScreenManager_new(Header* header, Machine* host, State* state, bool owner) {
    ScreenManager* this;
    this = xMalloc(sizeof(ScreenManager));
@@ -41,6 +47,7 @@ ScreenManager* ScreenManager_new(Header* header, Machine* host, State* state, bo
    this->host = host;
    this->state = state;
    this->allowFocusChange = true;
+   this->uidDigits = Process_uidDigits;
    return this;
 }
 
@@ -119,14 +126,37 @@ void ScreenManager_resize(ScreenManager* this) {
    Panel_move(panel, lastX, y1_header);
 }
 
+static void ScreenManager_scanDone(ScreenManager* this, bool* force_redraw) {
+   // force redraw if the number of UID digits was changed
+   if (Process_uidDigits != this->uidDigits) {
+      this->uidDigits = Process_uidDigits;
+      *force_redraw = true;
+   }
+}
+
+/*
+ * Takes over the rows of a scan finished in the background. This happens
+ * right after the model lock was reacquired, as the cleanup of the scan may
+ * have freed rows still listed in the panel.
+ */
+static bool ScreenManager_takeScan(ScreenManager* this, bool* force_redraw) {
+   if (!ScanThread_takeCompleted(this->host->scanThread))
+      return false;
+
+   ScreenManager_scanDone(this, force_redraw);
+   Table_rebuildPanel(this->host->activeTable);
+   return true;
+}
+
 static void checkRecalculation(ScreenManager* this, double* oldTime, int* sortTimeout, bool* redraw, bool* rescan, bool* timedOut, bool* force_redraw) {
    Machine* host = this->host;
 
    Platform_gettime_realtime(&host->realtime, &host->realtimeMs);
    double newTime = ((double)host->realtime.tv_sec * 10) + ((double)host->realtime.tv_usec / 100000);
 
+   // the input delay expired; the interval between scans may be longer, see Machine_updateRefreshDelay
    *timedOut = (newTime - *oldTime > host->settings->delay);
-   *rescan |= *timedOut;
+   *rescan |= (newTime - *oldTime > Machine_refreshDelay(host));
 
    if (newTime < *oldTime) {
       *rescan = true; // clock was adjusted?
@@ -134,23 +164,19 @@ static void checkRecalculation(ScreenManager* this, double* oldTime, int* sortTi
 
    if (*rescan) {
       *oldTime = newTime;
-      int oldUidDigits = Process_uidDigits;
       if (!this->state->pauseUpdate && (*sortTimeout == 0 || host->settings->ss->treeView)) {
          host->activeTable->needsSort = true;
          *sortTimeout = 1;
       }
       // sample current values for system metrics and processes if not paused
-      Machine_scan(host);
-      if (!this->state->pauseUpdate)
-         Machine_scanTables(host);
-
-      // always update header, especially to avoid gaps in graph meters
-      Header_updateData(this->header);
-      // force redraw if the number of UID digits was changed
-      if (Process_uidDigits != oldUidDigits) {
-         *force_redraw = true;
+      if (host->scanThread) {
+         // the result is taken over once the scan completed, see ScreenManager_takeScan
+         ScanThread_request(host->scanThread, !this->state->pauseUpdate);
+      } else {
+         ScanThread_scan(host, this->header, !this->state->pauseUpdate);
+         ScreenManager_scanDone(this, force_redraw);
+         *redraw = true;
       }
-      *redraw = true;
    }
    if (*redraw) {
       Table_rebuildPanel(host->activeTable);
@@ -209,6 +235,7 @@ static void ScreenManager_drawPanels(ScreenManager* this, int focus, bool force_
    if (settings->screenTabs) {
       ScreenManager_drawScreenTabs(this);
    }
+   PROFILE_BEGIN(PROFILE_PANEL_DRAW);
    const int nPanels = this->panelCount;
    for (int i = 0; i < nPanels; i++) {
       Panel* panel = (Panel*) Vector_get(this->panels, i);
@@ -219,6 +246,7 @@ static void ScreenManager_drawPanels(ScreenManager* this, int focus, bool force_
                  State_hideFunctionBar(this->state));
       mvvline(panel->y, panel->x + panel->w, ' ', panel->h + (State_hideFunctionBar(this->state) ? 1 : 0));
    }
+   PROFILE_END(PROFILE_PANEL_DRAW);
 }
 
 void ScreenManager_run(ScreenManager* this, Panel** lastFocus, int* lastKey, const char* name) {
@@ -237,8 +265,13 @@ void ScreenManager_run(ScreenManager* this, Panel** lastFocus, int* lastKey, con
    bool redraw = true;
    bool force_redraw = true;
    bool rescan = false;
+   bool scanned = false;
    int sortTimeout = 0;
    int resetSortTimeout = 5;
+   uint64_t keyTime = 0;
+
+   ScanThread* scanThread = this->host->scanThread;
+   ScanThread_lock(scanThread);
 
    this->name = name;
 
@@ -247,9 +280,10 @@ void ScreenManager_run(ScreenManager* this, Panel** lastFocus, int* lastKey, con
          checkRecalculation(this, &oldTime, &sortTimeout, &redraw, &rescan, &timedOut, &force_redraw);
       }
 
-      if (redraw || force_redraw) {
+      if (redraw || force_redraw || scanned) {
          ScreenManager_drawPanels(this, focus, force_redraw);
          force_redraw = false;
+         scanned = false;
          if (this->host->iterationsRemaining != -1) {
             if (!--this->host->iterationsRemaining) {
                quit = true;
@@ -258,8 +292,36 @@ void ScreenManager_run(ScreenManager* this, Panel** lastFocus, int* lastKey, con
          }
       }
 
+      if (keyTime) {
+         // input-to-paint latency of the last key
+         refresh();
+         uint64_t now;
+         Platform_gettime_monotonic(&now);
+         this->host->inputLatencyMs = now > keyTime ? now - keyTime : 0;
+         this->host->maxInputLatencyMs = MAXIMUM(this->host->maxInputLatencyMs, this->host->inputLatencyMs);
+         keyTime = 0;
+      }
+
+      // check back frequently while a scan is running in the background
+      bool polling = ScanThread_isBusy(scanThread);
+      if (polling)
+         CRT_pollDelay(SCREENMANAGER_SCAN_POLL);
+
       int prevCh = ch;
+      unsigned int depth = ScanThread_release(scanThread);
       ch = Panel_getCh(panelFocus);
+      if (ch != ERR)
+         Platform_gettime_monotonic(&keyTime);
+      ScanThread_reacquire(scanThread, depth);
+
+      if (polling)
+         CRT_enableDelay();
+
+      if (ScreenManager_takeScan(this, &force_redraw)) {
+         scanned = true;
+         if (this->header && !this->state->hideMeters)
+            Header_draw(this->header);
+      }
 
       HandlerResult result = IGNORED;
 #ifdef HAVE_GETMOUSE
@@ -308,9 +370,9 @@ void ScreenManager_run(ScreenManager* this, Panel** lastFocus, int* lastKey, con
       }
 #endif
       if (ch == ERR) {
-         if (sortTimeout > 0)
+         if (sortTimeout > 0 && !polling)
             sortTimeout--;
-         if (prevCh == ch && !timedOut) {
+         if (prevCh == ch && !timedOut && !polling) {
             closeTimeout++;
             if (closeTimeout == 100) {
                break;
@@ -426,6 +488,8 @@ defaultHandler:
       }
    }
 
+   ScanThread_unlock(scanThread);
+
    if (lastFocus) {
       *lastFocus = panelFocus;
    }
@@ -28,6 +28,7 @@ typedef struct ScreenManager_ {
    Machine* host;
    State* state;
    bool allowFocusChange;
+   int uidDigits;
 } ScreenManager;
 
 ScreenManager* ScreenManager_new(Header* header, Machine* host, State* state, bool owner);
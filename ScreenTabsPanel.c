@@ -19,11 +19,13 @@ in the source distribution for its full text.
 #include "FunctionBar.h"
 #include "Hashtable.h"
 #include "Macros.h"
+#include "Platform.h"
 #include "ProvideCurses.h"
 #include "Settings.h"
 #include "XUtils.h"
 
 
+static HandlerResult ScreenNamesPanel_eventHandler(Panel* super, int ch);
 static HandlerResult ScreenNamesPanel_eventHandlerNormal(Panel* super, int ch);
 
 ObjectClass ScreenTabListItem_class = {
@@ -36,10 +38,17 @@ ObjectClass ScreenTabListItem_class = {
 static void ScreenNamesPanel_fill(ScreenNamesPanel* this, DynamicScreen* ds) {
    const Settings* settings = this->settings;
    Panel* super = &this->super;
+
+   /* during renaming the ListItem's value points to our static buffer */
+   if (this->renamingItem) {
+      this->renamingItem->value = this->saved;
+      this->renamingItem = NULL;
+      super->cursorOn = false;
+   }
    Panel_prune(super);
 
    for (unsigned int i = 0; i < settings->nScreens; i++) {
-      const ScreenSettings* ss = settings->screens[i];
+      ScreenSettings* ss = settings->screens[i];
 
       if (ds == NULL) {
          if (ss->dynamic != NULL)
@@ -52,7 +61,7 @@ static void ScreenNamesPanel_fill(ScreenNamesPanel* this, DynamicScreen* ds) {
             continue;
          /* matching dynamic screen found, add it into the Panel */
       }
-      Panel_add(super, (Object*) ListItem_new(ss->heading, i));
+      Panel_add(super, (Object*) ScreenNameListItem_new(ss->heading, ss));
    }
 
    this->ds = ds;
@@ -67,6 +76,10 @@ static void ScreenTabsPanel_delete(Object* object) {
 static HandlerResult ScreenTabsPanel_eventHandler(Panel* super, int ch) {
    ScreenTabsPanel* const this = (ScreenTabsPanel* const) super;
 
+   /* a screen created from here is named before anything else */
+   if (this->names->renamingItem)
+      return ScreenNamesPanel_eventHandler(&this->names->super, ch);
+
    HandlerResult result = IGNORED;
 
    int selected = Panel_getSelectedIndex(super);
@@ -281,6 +294,8 @@ static void addNewScreen(Panel* super, DynamicScreen* ds) {
    ScreenNamesPanel* const this = (ScreenNamesPanel*) super;
    const char* name = "New";
    ScreenSettings* ss = (ds != NULL) ? Settings_newDynamicScreen(this->settings, name, ds, NULL) : Settings_newScreen(this->settings, &(const ScreenDefaults) { .name = name, .columns = "PID Command", .sortKey = "PID" });
+   if (ds != NULL)
+      Platform_addDynamicScreen(ss);
    ScreenNameListItem* item = ScreenNameListItem_new(name, ss);
    int idx = Panel_getSelectedIndex(super);
    Panel_insert(super, idx + 1, (Object*) item);
@@ -0,0 +1,79 @@
+/*
+htop - SelfMeter.c
+(C) 2024 htop dev team
+Released under the GNU GPLv2+, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "config.h" // IWYU pragma: keep
+
+#include "SelfMeter.h"
+
+#include "CRT.h"
+#include "Machine.h"
+#include "Object.h"
+#include "RichString.h"
+#include "XUtils.h"
+
+
+static const int SelfMeter_attributes[] = {
+   METER_VALUE
+};
+
+static void SelfMeter_updateValues(Meter* this) {
+   const Machine* host = this->host;
+
+   int delay = Machine_refreshDelay(host);
+   xSnprintf(this->txtBuffer, sizeof(this->txtBuffer), "every %d.%ds, %.1f%% CPU, scan %ums, input %ums (max %ums)",
+             delay / 10, delay % 10,
+             host->selfCPU,
+             (unsigned int)host->scanMs,
+             (unsigned int)host->inputLatencyMs,
+             (unsigned int)host->maxInputLatencyMs);
+}
+
+static void SelfMeter_display(const Object* cast, RichString* out) {
+   const Meter* this = (const Meter*)cast;
+   const Machine* host = this->host;
+   char buffer[32];
+   int len;
+
+   int delay = Machine_refreshDelay(host);
+   RichString_writeAscii(out, CRT_colors[METER_TEXT], "every ");
+   len = xSnprintf(buffer, sizeof(buffer), "%d.%ds", delay / 10, delay % 10);
+   RichString_appendnAscii(out, CRT_colors[host->settings->refreshBudget > 0 ? METER_VALUE_NOTICE : METER_VALUE], buffer, len);
+
+   RichString_appendAscii(out, CRT_colors[METER_TEXT], ", ");
+   len = xSnprintf(buffer, sizeof(buffer), "%.1f%%", host->selfCPU);
+   RichString_appendnAscii(out, CRT_colors[METER_VALUE], buffer, len);
+
+   RichString_appendAscii(out, CRT_colors[METER_TEXT], " CPU, scan ");
+   len = xSnprintf(buffer, sizeof(buffer), "%ums", (unsigned int)host->scanMs);
+   RichString_appendnAscii(out, CRT_colors[METER_VALUE], buffer, len);
+
+   RichString_appendAscii(out, CRT_colors[METER_TEXT], ", input ");
+   len = xSnprintf(buffer, sizeof(buffer), "%ums", (unsigned int)host->inputLatencyMs);
+   RichString_appendnAscii(out, CRT_colors[METER_VALUE], buffer, len);
+
+   RichString_appendAscii(out, CRT_colors[METER_TEXT], " (max ");
+   len = xSnprintf(buffer, sizeof(buffer), "%ums", (unsigned int)host->maxInputLatencyMs);
+   RichString_appendnAscii(out, CRT_colors[METER_VALUE], buffer, len);
+   RichString_appendAscii(out, CRT_colors[METER_TEXT], ")");
+}
+
+const MeterClass SelfMeter_class = {
+   .super = {
+      .extends = Class(Meter),
+      .delete = Meter_delete,
+      .display = SelfMeter_display,
+   },
+   .updateValues = SelfMeter_updateValues,
+   .defaultMode = TEXT_METERMODE,
+   .supportedModes = (1 << TEXT_METERMODE) | (1 << LED_METERMODE),
+   .maxItems = 0,
+   .total = 0.0,
+   .attributes = SelfMeter_attributes,
+   .name = "Self",
+   .uiName = "htop responsiveness",
+   .caption = "htop: "
+};
@@ -276,6 +276,7 @@ ScreenSettings* Settings_newScreen(Settings* this, const ScreenDefaults* default
       .treeDirection = 1,
       .sortKey = sortKey,
       .treeSortKey = treeSortKey,
+      .groupKey = NULL_FIELD,
       .treeView = false,
       .treeViewAlwaysByPID = false,
       .allBranchesCollapsed = false,
@@ -478,8 +479,14 @@ static bool Settings_read(Settings* this, const char* fileName, const Machine* h
          this->showSPUUsage = atoi(option[1]);
       } else if (String_eq(option[0], "show_spu_frequency")) {
          this->showSPUFrequency = atoi(option[1]);
+      #ifdef BUILD_WITH_SPU_TEMP
+      } else if (String_eq(option[0], "show_spu_temperature")) {
+         this->showSPUTemperature = atoi(option[1]);
+      #endif
       } else if (String_eq(option[0], "show_cached_memory")) {
          this->showCachedMemory = atoi(option[1]);
+      } else if (String_eq(option[0], "persist_meter_history")) {
+         this->persistMeterHistory = atoi(option[1]);
       #ifdef BUILD_WITH_CPU_TEMP
       } else if (String_eq(option[0], "show_cpu_temperature")) {
          this->showCPUTemperature = atoi(option[1]);
@@ -492,6 +499,8 @@ static bool Settings_read(Settings* this, const char* fileName, const Machine* h
          this->accountGuestInCPUMeter = atoi(option[1]);
       } else if (String_eq(option[0], "delay")) {
          this->delay = CLAMP(atoi(option[1]), 1, 255);
+      } else if (String_eq(option[0], "refresh_cpu_budget")) {
+         this->refreshBudget = CLAMP(atoi(option[1]), 0, 50);
       } else if (String_eq(option[0], "color_scheme")) {
          this->colorScheme = atoi(option[1]);
          if (this->colorScheme < 0 || this->colorScheme >= LAST_COLORSCHEME) {
@@ -543,6 +552,13 @@ static bool Settings_read(Settings* this, const char* fileName, const Machine* h
             int key = toFieldIndex(this->dynamicColumns, option[1]);
             screen->treeSortKey = key > 0 ? key : PID;
          }
+      } else if (String_eq(option[0], ".group_key")) {
+         if (screen) {
+            int key = toFieldIndex(this->dynamicColumns, option[1]);
+            screen->groupKey = key > 0 ? key : NULL_FIELD;
+            if (key > 0 && key < LAST_PROCESSFIELD)
+               screen->flags |= Process_fields[key].flags;
+         }
       } else if (String_eq(option[0], ".sort_direction")) {
          if (screen)
             screen->direction = atoi(option[1]);
@@ -716,11 +732,15 @@ int Settings_write(const Settings* this, bool onCrash) {
    printSettingInteger("spu_count_from_one", this->countSPUsFromOne);
    printSettingInteger("show_spu_usage", this->showSPUUsage);
    printSettingInteger("show_spu_frequency", this->showSPUFrequency);
+   #ifdef BUILD_WITH_SPU_TEMP
+   printSettingInteger("show_spu_temperature", this->showSPUTemperature);
+   #endif
    #ifdef BUILD_WITH_CPU_TEMP
    printSettingInteger("show_cpu_temperature", this->showCPUTemperature);
    printSettingInteger("degree_fahrenheit", this->degreeFahrenheit);
    #endif
    printSettingInteger("show_cached_memory", this->showCachedMemory);
+   printSettingInteger("persist_meter_history", this->persistMeterHistory);
    printSettingInteger("update_process_names", this->updateProcessNames);
    printSettingInteger("account_guest_in_cpu_meter", this->accountGuestInCPUMeter);
    printSettingInteger("color_scheme", this->colorScheme);
@@ -728,6 +748,7 @@ int Settings_write(const Settings* this, bool onCrash) {
    printSettingInteger("enable_mouse", this->enableMouse);
    #endif
    printSettingInteger("delay", (int) this->delay);
+   printSettingInteger("refresh_cpu_budget", this->refreshBudget);
    printSettingInteger("hide_function_bar", (int) this->hideFunctionBar);
    #ifdef HAVE_LIBHWLOC
    printSettingInteger("topology_affinity", this->topologyAffinity);
@@ -768,6 +789,8 @@ int Settings_write(const Settings* this, bool onCrash) {
          printSettingString(".sort_key", sortKey);
          printSettingString(".tree_sort_key", treeSortKey);
          printSettingInteger(".tree_view_always_by_pid", ss->treeViewAlwaysByPID);
+         if (ss->groupKey)
+            printSettingString(".group_key", toFieldName(this->dynamicColumns, ss->groupKey, NULL));
       }
       printSettingInteger(".tree_view", ss->treeView);
       printSettingInteger(".sort_direction", ss->direction);
@@ -825,6 +848,9 @@ Settings* Settings_new(const Machine* host, Hashtable* dynamicMeters, Hashtable*
    this->countSPUsFromOne = false;
    this->showSPUUsage = true;
    this->showSPUFrequency = false;
+   #ifdef BUILD_WITH_SPU_TEMP
+   this->showSPUTemperature = false;
+   #endif
    #ifdef BUILD_WITH_CPU_TEMP
    this->showCPUTemperature = false;
    this->degreeFahrenheit = false;
@@ -49,6 +49,7 @@ typedef struct ScreenSettings_ {
    int treeDirection;
    RowField sortKey;
    RowField treeSortKey;
+   RowField groupKey;  /* rows are summed up by this field's value, NULL_FIELD for none */
    bool treeView;
    bool treeViewAlwaysByPID;
    bool allBranchesCollapsed;
@@ -72,6 +73,7 @@ typedef struct Settings_ {
 
    int colorScheme;
    int delay;
+   int refreshBudget;  /* percent of one CPU htop may use, adapting the update interval; 0 for a fixed one */
 
    bool countCPUsFromOne;
    bool detailedCPUTime;
@@ -102,6 +104,7 @@ typedef struct Settings_ {
    bool headerMargin;
    bool screenTabs;
    bool showCachedMemory;
+   bool persistMeterHistory;
    #ifdef HAVE_GETMOUSE
    bool enableMouse;
    #endif
@@ -114,6 +117,9 @@ typedef struct Settings_ {
    bool detailedSPUTime;
    bool showSPUUsage;
    bool showSPUFrequency;
+   #ifdef BUILD_WITH_SPU_TEMP
+   bool showSPUTemperature;
+   #endif
    bool accountGuestInSPUMeter;
 
    bool changed;
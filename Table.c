@@ -13,15 +13,57 @@ in the source distribution for its full text.
 #include <assert.h>
 #include <stdint.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "CRT.h"
 #include "Hashtable.h"
 #include "Machine.h"
 #include "Macros.h"
 #include "Panel.h"
+#include "Profile.h"
 #include "RowField.h"
 #include "Vector.h"
+#include "XUtils.h"
+
+
+/* A synthetic group row, with its members in this->rows linked through an index array */
+typedef struct TableGroup_ {
+   Row* row;
+   int first;
+   int last;
+   char key[];
+} TableGroup;
+
+static ht_key_t Table_hashGroupKey(const char* key) {
+   /* FNV-1a */
+   uint32_t hash = 2166136261U;
+   for (const unsigned char* c = (const unsigned char*) key; *c; c++)
+      hash = (hash ^ *c) * 16777619U;
+   return hash;
+}
+
+/* Colliding keys take the next hash value not used by another key */
+static TableGroup* Table_findGroup(Hashtable* groups, const char* key, ht_key_t* hash) {
+   for (*hash = Table_hashGroupKey(key); ; (*hash)++) {
+      TableGroup* group = Hashtable_get(groups, *hash);
+      if (!group || String_eq(group->key, key))
+         return group;
+   }
+}
+
+static void Table_deleteGroupRow(ATTR_UNUSED ht_key_t key, void* value, ATTR_UNUSED void* data) {
+   const TableGroup* group = value;
+   if (group->row)
+      Object_delete(group->row);
+}
 
+static void Table_deleteGroups(Hashtable* groups) {
+   if (!groups)
+      return;
+
+   Hashtable_foreach(groups, Table_deleteGroupRow, NULL);
+   Hashtable_delete(groups);
+}
 
 Table* Table_init(Table* this, const ObjectClass* klass, Machine* host) {
    this->rows = Vector_new(klass, true, DEFAULT_SIZE);
@@ -29,11 +71,13 @@ Table* Table_init(Table* this, const ObjectClass* klass, Machine* host) {
    this->table = Hashtable_new(200, false);
    this->needsSort = true;
    this->following = -1;
+   this->nextGroupId = -2;  /* -1 means "not following" */
    this->host = host;
    return this;
 }
 
 void Table_done(Table* this) {
+   Table_deleteGroups(this->groups);
    Hashtable_delete(this->table);
    Vector_delete(this->displayList);
    Vector_delete(this->rows);
@@ -191,19 +235,132 @@ static void Table_buildTree(Table* this) {
    assert(Vector_size(this->displayList) == vsize); (void)vsize;
 }
 
+static int Table_compareGroups(const void* v1, const void* v2) {
+   const TableGroup* g1 = *(const TableGroup* const*) v1;
+   const TableGroup* g2 = *(const TableGroup* const*) v2;
+   return Object_compare(g1->row, g2->row);
+}
+
+static bool Table_canGroup(const Table* this) {
+   const RowClass* klass = (const RowClass*) Vector_type(this->rows);
+   return klass->groupKey && klass->newGroup && klass->accumulate && klass->resetGroup;
+}
+
+// Sums the shown rows up into one synthetic row per value of the group key, in a
+// single hashing pass over the scanned rows, and lists each group followed by its
+// members if expanded. The group rows of keys still present are taken over from
+// the previous build with their identifier and expansion, and emptied again.
+static void Table_buildGroups(Table* this, RowField key) {
+   Hashtable* previous = this->groups;
+   this->groups = NULL;
+   Vector_prune(this->displayList);
+
+   int size = Vector_size(this->rows);
+   if (!size) {
+      Table_deleteGroups(previous);
+      return;
+   }
+
+   Hashtable* groups = Hashtable_new(64, true);
+   TableGroup** sorted = xMallocArray(size, sizeof(TableGroup*));
+   int* next = xMallocArray(size, sizeof(int));
+   size_t count = 0;
+
+   for (int i = 0; i < size; i++) {
+      Row* row = (Row*) Vector_get(this->rows, i);
+      if (!row->show || Row_matchesFilter(row, this))
+         continue;
+
+      char label[256];
+      if (!Row_groupKey(row, key, label, sizeof(label)))
+         continue;
+
+      ht_key_t hash;
+      TableGroup* group = Table_findGroup(groups, label, &hash);
+      if (!group) {
+         size_t len = strlen(label);
+         group = xMalloc(sizeof(TableGroup) + len + 1);
+         memcpy(group->key, label, len + 1);
+         group->first = -1;
+         group->last = -1;
+
+         ht_key_t previousHash;
+         TableGroup* old = previous ? Table_findGroup(previous, label, &previousHash) : NULL;
+         if (old) {
+            /* Left in place, so colliding keys are still found past it */
+            group->row = old->row;
+            old->row = NULL;
+            As_Row(group->row)->resetGroup(group->row);
+            group->row->groupMembers = 0;
+         } else {
+            group->row = As_Row(row)->newGroup(row, label);
+            group->row->id = this->nextGroupId--;
+            group->row->showChildren = false;
+         }
+
+         Hashtable_put(groups, hash, group);
+         sorted[count++] = group;
+      }
+
+      As_Row(row)->accumulate(group->row, row);
+      group->row->groupMembers++;
+
+      next[i] = -1;
+      if (group->last < 0)
+         group->first = i;
+      else
+         next[group->last] = i;
+      group->last = i;
+   }
+
+   qsort(sorted, count, sizeof(TableGroup*), Table_compareGroups);
+
+   for (size_t g = 0; g < count; g++) {
+      Row* row = sorted[g]->row;
+      row->indent = 0;
+      row->tree_depth = 0;
+      Vector_add(this->displayList, row);
+
+      if (!row->showChildren)
+         continue;
+
+      for (int i = sorted[g]->first; i >= 0; i = next[i]) {
+         Row* member = (Row*) Vector_get(this->rows, i);
+         member->indent = next[i] >= 0 ? 1 : -1;
+         member->tree_depth = 1;
+         Vector_add(this->displayList, member);
+      }
+   }
+
+   free(next);
+   free(sorted);
+   Table_deleteGroups(previous);
+   this->groups = groups;
+}
+
 void Table_updateDisplayList(Table* this) {
    const Settings* settings = this->host->settings;
 
    if (settings->ss->treeView) {
-      if (this->needsSort)
+      if (this->needsSort) {
+         PROFILE_BEGIN(PROFILE_TREE);
          Table_buildTree(this);
+         PROFILE_END(PROFILE_TREE);
+      }
    } else {
-      if (this->needsSort)
+      if (this->needsSort) {
+         PROFILE_BEGIN(PROFILE_SORT);
          Vector_insertionSort(this->rows);
-      Vector_prune(this->displayList);
-      int size = Vector_size(this->rows);
-      for (int i = 0; i < size; i++)
-         Vector_add(this->displayList, Vector_get(this->rows, i));
+         PROFILE_END(PROFILE_SORT);
+      }
+      if (settings->ss->groupKey && Table_canGroup(this)) {
+         Table_buildGroups(this, settings->ss->groupKey);
+      } else {
+         Vector_prune(this->displayList);
+         int size = Vector_size(this->rows);
+         for (int i = 0; i < size; i++)
+            Vector_add(this->displayList, Vector_get(this->rows, i));
+      }
    }
    this->needsSort = false;
 }
@@ -230,6 +387,8 @@ void Table_collapseAllBranches(Table* this) {
 }
 
 void Table_rebuildPanel(Table* this) {
+   PROFILE_BEGIN(PROFILE_REBUILD_PANEL);
+
    Table_updateDisplayList(this);
 
    const int currPos = Panel_getSelectedIndex(this->panel);
@@ -255,7 +414,8 @@ void Table_rebuildPanel(Table* this) {
    for (int i = 0; i < rowCount; i++) {
       Row* row = (Row*) Vector_get(this->displayList, i);
 
-      if ( !row->show || (Row_matchesFilter(row, this) == true) )
+      /* group rows only sum up the rows that passed the filter */
+      if ( !row->show || (!Row_isGroup(row) && Row_matchesFilter(row, this) == true) )
          continue;
 
       Panel_set(this->panel, idx, (Object*)row);
@@ -284,6 +444,8 @@ void Table_rebuildPanel(Table* this) {
 
       this->panel->scrollV = currScrollV;
    }
+
+   PROFILE_END(PROFILE_REBUILD_PANEL);
 }
 
 void Table_printHeader(const Settings* settings, RichString* header) {
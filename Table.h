@@ -29,6 +29,9 @@ typedef struct Table_ {
    Vector* displayList;   /* row tree flattened in display order (borrowed);
                              updated in Table_updateDisplayList when rebuilding panel */
    Hashtable* table;      /* fast known row lookup by identifier */
+   Hashtable* groups;     /* synthetic rows summing up the rows by the screen's group key,
+                             by key hash; rebuilt with the display list */
+   int nextGroupId;       /* group rows get negative identifiers, unlike the rows they sum up */
 
    struct Machine_* host;
    const char* incFilter;
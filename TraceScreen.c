@@ -23,16 +23,33 @@ in the source distribution for its full text.
 
 #include "CRT.h"
 #include "FunctionBar.h"
+#include "Macros.h"
 #include "Panel.h"
+#include "Platform.h"
 #include "ProvideCurses.h"
 #include "XUtils.h"
 
 
-static const char* const TraceScreenFunctions[] = {"Search ", "Filter ", "AutoScroll ", "Stop Tracing   ", "Done   ", NULL};
+/* Keep memory bounded when tracing busy processes for a long time */
+#define TRACESCREEN_MAX_LINES 100000
 
-static const char* const TraceScreenKeys[] = {"F3", "F4", "F8", "F9", "Esc"};
+/* Interval between two samples of the threads' current system calls */
+#define TRACESCREEN_SAMPLE_INTERVAL_MS 10
 
-static const int TraceScreenEvents[] = {KEY_F(3), KEY_F(4), KEY_F(8), KEY_F(9), 27};
+/* Interval to rebuild the syscall table from the collected samples */
+#define TRACESCREEN_SAMPLE_REFRESH_MS 500
+
+static const char* const TraceScreenFunctions[] = {"Search ", "Filter ", "SortBy ", "Sample ", "AutoScroll ", "Stop Tracing   ", "Done   ", NULL};
+
+static const char* const TraceScreenKeys[] = {"F3", "F4", "F6", "F7", "F8", "F9", "Esc"};
+
+static const int TraceScreenEvents[] = {KEY_F(3), KEY_F(4), KEY_F(6), KEY_F(7), KEY_F(8), KEY_F(9), 27};
+
+static const char* const TraceScreen_sortNames[LAST_SYSCALL_SORT] = {
+   [SYSCALL_SORT_COUNT]   = "COUNT",
+   [SYSCALL_SORT_SYSCALL] = "SYSCALL",
+   [SYSCALL_SORT_TID]     = "TID",
+};
 
 TraceScreen* TraceScreen_new(const Process* process) {
    // This initializes all TraceScreen variables to "false" so only default = true ones need to be set below
@@ -42,11 +59,12 @@ TraceScreen* TraceScreen_new(const Process* process) {
    this->strace_alive = false;
    FunctionBar* fuBar = FunctionBar_new(TraceScreenFunctions, TraceScreenKeys, TraceScreenEvents);
    CRT_disableDelay();
-   return (TraceScreen*) InfoScreen_init(&this->super, process, fuBar, LINES - 2, " ");
+   InfoScreen_init(&this->super, process, fuBar, LINES - 2, " ");
+   InfoScreen_setMaxLines(&this->super, TRACESCREEN_MAX_LINES);
+   return this;
 }
 
-void TraceScreen_delete(Object* cast) {
-   TraceScreen* this = (TraceScreen*) cast;
+static void TraceScreen_stopTracer(TraceScreen* this) {
    if (this->child > 0) {
       kill(this->child, SIGTERM);
       while (waitpid(this->child, NULL, 0) == -1)
@@ -58,12 +76,38 @@ void TraceScreen_delete(Object* cast) {
       fclose(this->strace);
    }
 
+   this->child = 0;
+   this->strace = NULL;
+   this->strace_alive = false;
+   this->contLine = false;
+}
+
+void TraceScreen_delete(Object* cast) {
+   TraceScreen* this = (TraceScreen*) cast;
+   TraceScreen_stopTracer(this);
+
+   if (this->sampler)
+      Platform_deleteSyscallSampler(this->sampler);
+
    CRT_enableDelay();
    free(InfoScreen_done((InfoScreen*)this));
 }
 
-static void TraceScreen_draw(InfoScreen* this) {
-   InfoScreen_drawTitled(this, "Trace of process %d - %s", Process_getPid(this->process), Process_getCommand(this->process));
+static void TraceScreen_draw(InfoScreen* super) {
+   const TraceScreen* this = (const TraceScreen*) super;
+   if (this->sampling) {
+      InfoScreen_drawTitled(super, "Syscall samples of process %d - %s (%u samples, sorted by %s)",
+         Process_getPid(super->process), Process_getCommand(super->process),
+         this->samplePasses, TraceScreen_sortNames[this->sampleSort]);
+      return;
+   }
+
+   InfoScreen_drawTitled(super, "Trace of process %d - %s", Process_getPid(super->process), Process_getCommand(super->process));
+}
+
+static void TraceScreen_clearLines(TraceScreen* this) {
+   Vector_prune(this->super.lines);
+   Panel_prune(this->super.display);
 }
 
 bool TraceScreen_forkTracer(TraceScreen* this) {
@@ -177,17 +221,188 @@ static void TraceScreen_updateTrace(InfoScreen* super) {
          Panel_setSelected(this->super.display, Panel_size(this->super.display) - 1);
       }
    } else {
-      if (this->strace_alive && waitpid(this->child, NULL, WNOHANG) != 0)
+      int status = 0;
+      if (this->strace_alive && waitpid(this->child, &status, WNOHANG) != 0) {
          this->strace_alive = false;
+         if (WIFEXITED(status) && WEXITSTATUS(status) == 127)
+            InfoScreen_addLine(&this->super, "Press F7 to sample the system calls of the process without a tracer.");
+      }
+   }
+}
+
+static int TraceScreen_compareCount(const void* v1, const void* v2) {
+   const SyscallSampler_Entry* e1 = *(const SyscallSampler_Entry* const*) v1;
+   const SyscallSampler_Entry* e2 = *(const SyscallSampler_Entry* const*) v2;
+
+   if (e1->count != e2->count)
+      return e1->count > e2->count ? -1 : 1;
+
+   return SPACESHIP_NUMBER(e1->tid, e2->tid);
+}
+
+static int TraceScreen_compareSyscall(const void* v1, const void* v2) {
+   const SyscallSampler_Entry* e1 = *(const SyscallSampler_Entry* const*) v1;
+   const SyscallSampler_Entry* e2 = *(const SyscallSampler_Entry* const*) v2;
+
+   if (e1->syscall != e2->syscall)
+      return SPACESHIP_NUMBER(e1->syscall, e2->syscall);
+
+   return TraceScreen_compareCount(v1, v2);
+}
+
+static int TraceScreen_compareTid(const void* v1, const void* v2) {
+   const SyscallSampler_Entry* e1 = *(const SyscallSampler_Entry* const*) v1;
+   const SyscallSampler_Entry* e2 = *(const SyscallSampler_Entry* const*) v2;
+
+   if (e1->tid != e2->tid)
+      return SPACESHIP_NUMBER(e1->tid, e2->tid);
+
+   return TraceScreen_compareCount(v1, v2);
+}
+
+static void TraceScreen_showSamples(TraceScreen* this) {
+   InfoScreen* super = &this->super;
+   Panel* panel = super->display;
+   int idx = Panel_getSelectedIndex(panel);
+
+   TraceScreen_clearLines(this);
+
+   char line[128];
+   if (this->sampleError) {
+      xSnprintf(line, sizeof(line), "Could not read the system calls of some threads: %s", strerror(this->sampleError));
+      InfoScreen_addLine(super, line);
+      InfoScreen_addLine(super, "Sampling requires the same permissions as attaching a debugger to the process.");
+   }
+
+   static int (* const comparators[LAST_SYSCALL_SORT])(const void*, const void*) = {
+      [SYSCALL_SORT_COUNT]   = TraceScreen_compareCount,
+      [SYSCALL_SORT_SYSCALL] = TraceScreen_compareSyscall,
+      [SYSCALL_SORT_TID]     = TraceScreen_compareTid,
+   };
+
+   size_t count;
+   SyscallSampler_Entry** entries = Platform_getSyscallSamples(this->sampler, &count);
+   if (count > 1)
+      qsort(entries, count, sizeof(SyscallSampler_Entry*), comparators[this->sampleSort]);
+
+   for (size_t i = 0; i < count; i++) {
+      const SyscallSampler_Entry* entry = entries[i];
+      double percent = entry->samples ? 100.0 * entry->count / entry->samples : 0.0;
+
+      xSnprintf(line, sizeof(line), "%7d %9u %5.1f%%  %-20s %s",
+         entry->tid, entry->count, percent, entry->name, entry->wchan);
+      InfoScreen_addLine(super, line);
    }
+   free(entries);
+
+   Panel_setSelected(panel, idx);
+   InfoScreen_draw(this);
+}
+
+static void TraceScreen_updateSamples(TraceScreen* this) {
+   fd_set fds;
+   FD_ZERO(&fds);
+   FD_SET(STDIN_FILENO, &fds);
+
+   /* Wait for input until the next sample is due */
+   struct timeval tv = { .tv_sec = 0, .tv_usec = TRACESCREEN_SAMPLE_INTERVAL_MS * 1000 };
+   select(STDIN_FILENO + 1, &fds, NULL, NULL, &tv);
+
+   if (!this->tracing)
+      return;
+
+   uint64_t now;
+   Platform_gettime_monotonic(&now);
+
+   if (now - this->lastSampleMs >= TRACESCREEN_SAMPLE_INTERVAL_MS) {
+      int err = Platform_sampleSyscalls(this->sampler);
+      if (err)
+         this->sampleError = err;
+      this->samplePasses++;
+      this->lastSampleMs = now;
+   }
+
+   if (now - this->lastSampleRefreshMs >= TRACESCREEN_SAMPLE_REFRESH_MS) {
+      TraceScreen_showSamples(this);
+      this->lastSampleRefreshMs = now;
+   }
+}
+
+static void TraceScreen_toggleSampling(TraceScreen* this) {
+   InfoScreen* super = &this->super;
+
+   if (this->sampling) {
+      Platform_deleteSyscallSampler(this->sampler);
+      this->sampler = NULL;
+      this->sampling = false;
+
+      TraceScreen_clearLines(this);
+      Panel_setHeader(super->display, " ");
+      FunctionBar_setLabel(super->display->defaultBar, KEY_F(7), "Sample ");
+      if (!TraceScreen_forkTracer(this))
+         InfoScreen_addLine(super, "Could not start the tracer.");
+
+      InfoScreen_draw(this);
+      return;
+   }
+
+   SyscallSampler* sampler;
+   int err = Platform_newSyscallSampler(Process_getPid(super->process), &sampler);
+   if (err == -1) {
+      InfoScreen_addLine(super, "Sampling system calls is not supported on this platform.");
+      return;
+   } else if (err != 0) {
+      char line[128];
+      xSnprintf(line, sizeof(line), "Could not sample the system calls of the process: %s", strerror(err));
+      InfoScreen_addLine(super, line);
+      return;
+   }
+
+   /* The sampler reads the threads' state without stopping them, so strace has to go */
+   TraceScreen_stopTracer(this);
+
+   this->sampler = sampler;
+   this->sampling = true;
+   this->sampleError = 0;
+   this->samplePasses = 0;
+   this->follow = false;
+   Platform_gettime_monotonic(&this->lastSampleMs);
+   this->lastSampleRefreshMs = 0;
+
+   TraceScreen_clearLines(this);
+   Panel_setHeader(super->display, "    TID   SAMPLES  SHARE  SYSCALL              WCHAN");
+   FunctionBar_setLabel(super->display->defaultBar, KEY_F(7), "Strace ");
+   InfoScreen_draw(this);
+}
+
+static void TraceScreen_update(InfoScreen* super) {
+   TraceScreen* this = (TraceScreen*) super;
+   if (this->sampling) {
+      TraceScreen_updateSamples(this);
+      return;
+   }
+
+   TraceScreen_updateTrace(super);
 }
 
 static bool TraceScreen_onKey(InfoScreen* super, int ch) {
    TraceScreen* this = (TraceScreen*) super;
 
    switch (ch) {
+      case 's':
+      case KEY_F(6):
+         if (!this->sampling)
+            break;
+         this->sampleSort = (this->sampleSort + 1) % LAST_SYSCALL_SORT;
+         TraceScreen_showSamples(this);
+         return true;
+      case KEY_F(7):
+         TraceScreen_toggleSampling(this);
+         return true;
       case 'f':
       case KEY_F(8):
+         if (this->sampling)
+            return true;
          this->follow = !(this->follow);
          if (this->follow)
             Panel_setSelected(super->display, Panel_size(super->display) - 1);
@@ -210,6 +425,6 @@ const InfoScreenClass TraceScreen_class = {
       .delete = TraceScreen_delete
    },
    .draw = TraceScreen_draw,
-   .onErr = TraceScreen_updateTrace,
+   .onErr = TraceScreen_update,
    .onKey = TraceScreen_onKey,
 };
@@ -8,6 +8,7 @@ in the source distribution for its full text.
 */
 
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <sys/types.h>
 
@@ -16,6 +17,30 @@ in the source distribution for its full text.
 #include "Process.h"
 
 
+/* Pseudo syscall numbers for samples taken outside of a system call */
+#define SYSCALL_SAMPLER_RUNNING  (-2L)   /* running in user space */
+#define SYSCALL_SAMPLER_BLOCKED  (-1L)   /* in the kernel, but not in a system call */
+
+typedef enum SyscallSampler_Sort_ {
+   SYSCALL_SORT_COUNT,
+   SYSCALL_SORT_SYSCALL,
+   SYSCALL_SORT_TID,
+   LAST_SYSCALL_SORT
+} SyscallSampler_Sort;
+
+/* One line of the syscall samples, see Platform_getSyscallSamples */
+typedef struct SyscallSampler_Entry_ {
+   pid_t tid;
+   long syscall;
+   unsigned int count;
+   unsigned int samples;   /* samples taken of the owning thread */
+   char name[24];          /* name of the syscall, or its number in angle brackets */
+   char wchan[40];         /* most recent kernel wait channel, if readable */
+} SyscallSampler_Entry;
+
+/* Defined by the platform, see Platform_newSyscallSampler */
+typedef struct SyscallSampler_ SyscallSampler;
+
 typedef struct TraceScreen_ {
    InfoScreen super;
    bool tracing;
@@ -24,6 +49,13 @@ typedef struct TraceScreen_ {
    bool contLine;
    bool follow;
    bool strace_alive;
+   bool sampling;                     /* sampling the threads' current system calls instead of tracing */
+   SyscallSampler* sampler;
+   unsigned int samplePasses;
+   int sampleSort;
+   int sampleError;
+   uint64_t lastSampleMs;
+   uint64_t lastSampleRefreshMs;
 } TraceScreen;
 
 
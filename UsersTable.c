@@ -9,36 +9,335 @@ in the source distribution for its full text.
 
 #include "UsersTable.h"
 
+#include <errno.h>
+#include <limits.h>
 #include <pwd.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
 
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#include "Macros.h"
 #include "XUtils.h"
 
 
+/* Seconds until a resolved name is looked up again */
+#define USERSTABLE_POSITIVE_TTL 3600
+
+/* Seconds until a user that could not be resolved is looked up again */
+#define USERSTABLE_NEGATIVE_TTL 60
+
+/* Seconds between two checks for expired names */
+#define USERSTABLE_REFRESH_INTERVAL 60
+
+typedef struct UsersTable_Lookup_ {
+   time_t expires;
+   bool pending;
+} UsersTable_Lookup;
+
+typedef struct UsersTable_Result_ {
+   unsigned int uid;
+   char* name;             /* NULL if the user is unknown */
+} UsersTable_Result;
+
+#ifdef HAVE_PTHREAD
+
+/*
+ * Shared between the table and the resolver thread. The thread is detached,
+ * as it might be stuck in a slow name service when htop exits, so whichever
+ * side lets go last frees the state.
+ */
+typedef struct UsersTable_Resolver_ {
+   pthread_mutex_t lock;
+   pthread_cond_t wakeup;
+   unsigned int refs;
+   bool stop;
+   unsigned int* requests;
+   size_t requestCount;
+   size_t requestSize;
+   UsersTable_Result* results;
+   size_t resultCount;
+   size_t resultSize;
+} UsersTable_Resolver;
+
+#endif /* HAVE_PTHREAD */
+
+static void UsersTable_preload(UsersTable* this) {
+   FILE* fp = fopen("/etc/passwd", "r");
+   if (!fp)
+      return;
+
+   char* line;
+   while ((line = String_readLine(fp)) != NULL) {
+      /* name:password:uid:gid:gecos:home:shell, skipping comments and NIS compat entries */
+      char* nameEnd = strchr(line, ':');
+      char* uidStart = nameEnd ? strchr(nameEnd + 1, ':') : NULL;
+      if (!uidStart || nameEnd == line || line[0] == '#' || line[0] == '+' || line[0] == '-') {
+         free(line);
+         continue;
+      }
+
+      uidStart++;
+      char* uidEnd;
+      errno = 0;
+      unsigned long uid = strtoul(uidStart, &uidEnd, 10);
+      if (errno == 0 && uidEnd != uidStart && *uidEnd == ':' && uid <= UINT_MAX && !Hashtable_get(this->local, (ht_key_t) uid))
+         Hashtable_put(this->local, (ht_key_t) uid, xStrndup(line, (size_t)(nameEnd - line)));
+
+      free(line);
+   }
+
+   fclose(fp);
+}
+
+#ifdef HAVE_PTHREAD
+
+static char* UsersTable_lookupName(unsigned int uid) {
+   long size = sysconf(_SC_GETPW_R_SIZE_MAX);
+   size_t bufferSize = size > 0 ? (size_t) size : 1024;
+   char* buffer = xMalloc(bufferSize);
+   char* name = NULL;
+
+   for (;;) {
+      struct passwd pwd;
+      struct passwd* result = NULL;
+      int err = getpwuid_r(uid, &pwd, buffer, bufferSize, &result);
+      if (err == ERANGE && bufferSize < 1024 * 1024) {
+         bufferSize *= 2;
+         buffer = xRealloc(buffer, bufferSize);
+         continue;
+      }
+
+      if (err == 0 && result)
+         name = xStrdup(result->pw_name);
+      break;
+   }
+
+   free(buffer);
+   return name;
+}
+
+static void UsersTable_releaseResolver(UsersTable_Resolver* resolver) {
+   pthread_mutex_lock(&resolver->lock);
+   bool last = --resolver->refs == 0;
+   pthread_mutex_unlock(&resolver->lock);
+
+   if (!last)
+      return;
+
+   for (size_t i = 0; i < resolver->resultCount; i++)
+      free(resolver->results[i].name);
+
+   pthread_cond_destroy(&resolver->wakeup);
+   pthread_mutex_destroy(&resolver->lock);
+   free(resolver->requests);
+   free(resolver->results);
+   free(resolver);
+}
+
+static void* UsersTable_resolverThread(void* arg) {
+   UsersTable_Resolver* resolver = arg;
+
+   pthread_mutex_lock(&resolver->lock);
+   while (!resolver->stop) {
+      if (resolver->requestCount == 0) {
+         pthread_cond_wait(&resolver->wakeup, &resolver->lock);
+         continue;
+      }
+
+      unsigned int uid = resolver->requests[--resolver->requestCount];
+
+      /* Name services may block for a long time, never hold the lock meanwhile */
+      pthread_mutex_unlock(&resolver->lock);
+      char* name = UsersTable_lookupName(uid);
+      pthread_mutex_lock(&resolver->lock);
+
+      if (resolver->resultCount == resolver->resultSize) {
+         resolver->resultSize = resolver->resultSize ? resolver->resultSize * 2 : 16;
+         resolver->results = xReallocArray(resolver->results, resolver->resultSize, sizeof(UsersTable_Result));
+      }
+      resolver->results[resolver->resultCount++] = (UsersTable_Result) { .uid = uid, .name = name };
+   }
+   pthread_mutex_unlock(&resolver->lock);
+
+   UsersTable_releaseResolver(resolver);
+   return NULL;
+}
+
+static UsersTable_Resolver* UsersTable_startResolver(void) {
+   UsersTable_Resolver* resolver = xCalloc(1, sizeof(UsersTable_Resolver));
+   pthread_mutex_init(&resolver->lock, NULL);
+   pthread_cond_init(&resolver->wakeup, NULL);
+   resolver->refs = 2;
+
+   pthread_t thread;
+   if (pthread_create(&thread, NULL, UsersTable_resolverThread, resolver) != 0) {
+      resolver->refs = 1;
+      UsersTable_releaseResolver(resolver);
+      return NULL;
+   }
+
+   pthread_detach(thread);
+   return resolver;
+}
+
+#endif /* HAVE_PTHREAD */
+
 UsersTable* UsersTable_new(void) {
    UsersTable* this;
-   this = xMalloc(sizeof(UsersTable));
-   this->users = Hashtable_new(10, true);
+   this = xCalloc(1, sizeof(UsersTable));
+   /* Not owning, as names replaced on refresh must outlive their entry */
+   this->users = Hashtable_new(10, false);
+   this->local = Hashtable_new(64, true);
+   this->lookups = Hashtable_new(10, true);
+   this->now = time(NULL);
+   this->nextRefresh = this->now + USERSTABLE_REFRESH_INTERVAL;
+   UsersTable_preload(this);
    return this;
 }
 
+static void UsersTable_freeName(ATTR_UNUSED ht_key_t key, void* value, ATTR_UNUSED void* userData) {
+   free(value);
+}
+
 void UsersTable_delete(UsersTable* this) {
+#ifdef HAVE_PTHREAD
+   if (this->resolver) {
+      pthread_mutex_lock(&this->resolver->lock);
+      this->resolver->stop = true;
+      pthread_cond_signal(&this->resolver->wakeup);
+      pthread_mutex_unlock(&this->resolver->lock);
+      UsersTable_releaseResolver(this->resolver);
+   }
+#endif
+
+   for (size_t i = 0; i < this->retiredCount; i++)
+      free(this->retired[i]);
+   free(this->retired);
+
+   Hashtable_foreach(this->users, UsersTable_freeName, NULL);
+
+   Hashtable_delete(this->lookups);
+   Hashtable_delete(this->local);
    Hashtable_delete(this->users);
    free(this);
 }
 
+static void UsersTable_applyResult(UsersTable* this, unsigned int uid, char* name) {
+   UsersTable_Lookup* lookup = Hashtable_get(this->lookups, uid);
+   if (!lookup) {
+      lookup = xCalloc(1, sizeof(UsersTable_Lookup));
+      Hashtable_put(this->lookups, uid, lookup);
+   }
+
+   lookup->pending = false;
+   lookup->expires = this->now + (name ? USERSTABLE_POSITIVE_TTL : USERSTABLE_NEGATIVE_TTL);
+
+   if (!name)
+      return;
+
+   char* old = Hashtable_get(this->users, uid);
+   if (old && String_eq(old, name)) {
+      free(name);
+      return;
+   }
+
+   if (old) {
+      /* Processes still point at the old name, keep it alive */
+      this->retired = xReallocArray(this->retired, this->retiredCount + 1, sizeof(char*));
+      this->retired[this->retiredCount++] = old;
+   }
+
+   Hashtable_put(this->users, uid, name);
+}
+
+static void UsersTable_request(UsersTable* this, unsigned int uid) {
+#ifdef HAVE_PTHREAD
+   if (!this->resolver)
+      this->resolver = UsersTable_startResolver();
+
+   if (this->resolver) {
+      UsersTable_Lookup* lookup = Hashtable_get(this->lookups, uid);
+      if (!lookup) {
+         lookup = xCalloc(1, sizeof(UsersTable_Lookup));
+         Hashtable_put(this->lookups, uid, lookup);
+      }
+      lookup->pending = true;
+
+      UsersTable_Resolver* resolver = this->resolver;
+      pthread_mutex_lock(&resolver->lock);
+      if (resolver->requestCount == resolver->requestSize) {
+         resolver->requestSize = resolver->requestSize ? resolver->requestSize * 2 : 16;
+         resolver->requests = xReallocArray(resolver->requests, resolver->requestSize, sizeof(unsigned int));
+      }
+      resolver->requests[resolver->requestCount++] = uid;
+      pthread_cond_signal(&resolver->wakeup);
+      pthread_mutex_unlock(&resolver->lock);
+      return;
+   }
+#endif
+
+   const struct passwd* userData = getpwuid(uid);
+   UsersTable_applyResult(this, uid, userData ? xStrdup(userData->pw_name) : NULL);
+}
+
 char* UsersTable_getRef(UsersTable* this, unsigned int uid) {
    char* name = Hashtable_get(this->users, uid);
-   if (name == NULL) {
-      const struct passwd* userData = getpwuid(uid);
-      if (userData != NULL) {
-         name = xStrdup(userData->pw_name);
-         Hashtable_put(this->users, uid, name);
-      }
+   if (name)
+      return name;
+
+   const UsersTable_Lookup* lookup = Hashtable_get(this->lookups, uid);
+   if (lookup && (lookup->pending || this->now < lookup->expires))
+      return NULL;
+
+   const char* localName = Hashtable_get(this->local, uid);
+   if (localName) {
+      UsersTable_applyResult(this, uid, xStrdup(localName));
+      return Hashtable_get(this->users, uid);
+   }
+
+   UsersTable_request(this, uid);
+   return Hashtable_get(this->users, uid);
+}
+
+static void UsersTable_refreshExpired(ht_key_t key, void* value, void* userData) {
+   UsersTable* this = userData;
+   const UsersTable_Lookup* lookup = value;
+
+   /* Unknown users are retried on demand by UsersTable_getRef */
+   if (!lookup->pending && this->now >= lookup->expires && Hashtable_get(this->users, key))
+      UsersTable_request(this, key);
+}
+
+void UsersTable_update(UsersTable* this) {
+   this->now = time(NULL);
+
+#ifdef HAVE_PTHREAD
+   UsersTable_Resolver* resolver = this->resolver;
+   if (resolver) {
+      pthread_mutex_lock(&resolver->lock);
+      UsersTable_Result* results = resolver->results;
+      size_t resultCount = resolver->resultCount;
+      resolver->results = NULL;
+      resolver->resultCount = 0;
+      resolver->resultSize = 0;
+      pthread_mutex_unlock(&resolver->lock);
+
+      for (size_t i = 0; i < resultCount; i++)
+         UsersTable_applyResult(this, results[i].uid, results[i].name);
+      free(results);
+   }
+#endif
+
+   if (this->now >= this->nextRefresh) {
+      this->nextRefresh = this->now + USERSTABLE_REFRESH_INTERVAL;
+      Hashtable_foreach(this->lookups, UsersTable_refreshExpired, this);
    }
-   return name;
 }
 
 inline void UsersTable_foreach(UsersTable* this, Hashtable_PairFunction f, void* userData) {
@@ -7,19 +7,35 @@ Released under the GNU GPLv2+, see the COPYING file
 in the source distribution for its full text.
 */
 
+#include <stddef.h>
+#include <time.h>
+
 #include "Hashtable.h"
 
 
+struct UsersTable_Resolver_;
+
 typedef struct UsersTable_ {
-   Hashtable* users;
+   Hashtable* users;        /* uid -> name, for all users names were requested for */
+   Hashtable* local;        /* uid -> name, preloaded from the local passwd file */
+   Hashtable* lookups;      /* uid -> UsersTable_Lookup, resolution state and expiry */
+   struct UsersTable_Resolver_* resolver;
+   char** retired;          /* names replaced on refresh, still referenced by processes */
+   size_t retiredCount;
+   time_t now;
+   time_t nextRefresh;
 } UsersTable;
 
 UsersTable* UsersTable_new(void);
 
 void UsersTable_delete(UsersTable* this);
 
+/* Returns NULL while the name is being resolved or for unknown users */
 char* UsersTable_getRef(UsersTable* this, unsigned int uid);
 
+/* Applies names resolved in the background; called once per scan */
+void UsersTable_update(UsersTable* this);
+
 void UsersTable_foreach(UsersTable* this, Hashtable_PairFunction f, void* userData);
 
 #endif
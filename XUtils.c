@@ -21,6 +21,7 @@ in the source distribution for its full text.
 
 #include "CRT.h"
 #include "Macros.h"
+#include "Profile.h"
 
 
 void fail(void) {
@@ -278,6 +279,9 @@ char* xStrndup(const char* str, size_t len) {
 
 ATTR_ACCESS3_W(2, 3)
 static ssize_t readfd_internal(int fd, void* buffer, size_t count) {
+   /* counts the close(), which every path ends with */
+   PROFILE_COUNT_CALLS(1);
+
    if (!count) {
       close(fd);
       return -EINVAL;
@@ -287,6 +291,7 @@ static ssize_t readfd_internal(int fd, void* buffer, size_t count) {
    count--; // reserve one for null-terminator
 
    for (;;) {
+      PROFILE_COUNT_CALLS(1);
       ssize_t res = read(fd, buffer, count);
       if (res == -1) {
          if (errno == EINTR)
@@ -314,6 +319,7 @@ static ssize_t readfd_internal(int fd, void* buffer, size_t count) {
 }
 
 ssize_t xReadfile(const char* pathname, void* buffer, size_t count) {
+   PROFILE_COUNT_CALLS(1);
    int fd = open(pathname, O_RDONLY);
    if (fd < 0)
       return -errno;
@@ -0,0 +1,372 @@
+/*
+htop - bench/htop-bench.c
+(C) 2024 htop dev team
+Released under the GNU GPLv2+, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "config.h" // IWYU pragma: keep
+
+#include <getopt.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef HTOP_PCP
+#include <pcp/pmapi.h>
+#endif
+
+#include "CRT.h"
+#include "DynamicColumn.h"
+#include "DynamicMeter.h"
+#include "DynamicScreen.h"
+#include "Hashtable.h"
+#include "Machine.h"
+#include "Macros.h"
+#include "Object.h"
+#include "Platform.h"
+#include "ProcessTable.h"
+#include "RichString.h"
+#include "Row.h"
+#include "Settings.h"
+#include "Table.h"
+#include "UsersTable.h"
+#include "Vector.h"
+#include "XUtils.h"
+
+
+/*
+ * Times the phases of an update against the proc tree compiled in as PROCDIR,
+ * usually one generated by bench/mkproc.py, and prints the results as JSON.
+ * Built for PCP, it replays the archive named by $PCP_ARCHIVE instead, one
+ * recorded sample per scan.
+ */
+
+#ifdef HTOP_PCP
+const char* program = "pcp-htop-bench";
+#else
+const char* program = "htop-bench";
+#endif
+
+/* Shows every column that makes the scan read another file of /proc/<pid> */
+static const ScreenDefaults Bench_screen = {
+   .name = "Bench",
+   .columns = "PID USER PRIORITY NICE M_VIRT M_RESIDENT M_SHARE M_PSS M_SWAP STATE PERCENT_CPU PERCENT_MEM TIME IO_READ_RATE IO_WRITE_RATE CTXT CGROUP Command",
+   .sortKey = "PERCENT_CPU",
+};
+
+typedef enum BenchPhase_ {
+   BENCH_MACHINE_SCAN,
+   BENCH_GO_THROUGH_ENTRIES,
+   BENCH_SORT,
+   BENCH_TREE,
+   BENCH_RENDER,
+   LAST_BENCH_PHASE
+} BenchPhase;
+
+static const char* const Bench_phaseNames[LAST_BENCH_PHASE] = {
+   [BENCH_MACHINE_SCAN] = "machine_scan",
+   [BENCH_GO_THROUGH_ENTRIES] = "go_through_entries",
+   [BENCH_SORT] = "sort",
+   [BENCH_TREE] = "tree",
+   [BENCH_RENDER] = "render",
+};
+
+typedef struct BenchOptions_ {
+   unsigned int iterations;
+   unsigned int warmup;
+   const char* churn;
+   const char* output;
+} BenchOptions;
+
+static uint64_t Bench_now(void) {
+   struct timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void Bench_usage(FILE* out) {
+   fprintf(out,
+#ifdef HTOP_PCP
+      "pcp-htop-bench - times the scan of the processes in the archive named by\n"
+      "$PCP_ARCHIVE, which needs a sample for every warmup and timed iteration\n"
+#else
+      "htop-bench - times the scan of the proc tree at " PROCDIR "\n"
+#endif
+      "\n"
+      "-n --iterations=COUNT   Timed iterations (default: 20)\n"
+      "-w --warmup=COUNT       Untimed iterations before, at least 1 (default: 2)\n"
+      "-c --churn=COMMAND      Shell command run before each iteration, e.g. to\n"
+      "                        change the tree with 'mkproc.py --churn'\n"
+      "-o --output=FILE        Write the JSON results to FILE instead of stdout\n"
+      "-h --help               Print this help screen\n");
+}
+
+static bool Bench_parseCount(const char* arg, unsigned int min, unsigned int* count) {
+   char* end;
+   unsigned long value = strtoul(arg, &end, 10);
+   if (end == arg || *end != '\0' || value < min || value > 100000)
+      return false;
+
+   *count = value;
+   return true;
+}
+
+static bool Bench_parseArguments(int argc, char** argv, BenchOptions* options) {
+   const struct option long_opts[] = {
+      {"iterations", required_argument, 0, 'n'},
+      {"warmup",     required_argument, 0, 'w'},
+      {"churn",      required_argument, 0, 'c'},
+      {"output",     required_argument, 0, 'o'},
+      {"help",       no_argument,       0, 'h'},
+      {0, 0, 0, 0}
+   };
+
+   int opt;
+   while ((opt = getopt_long(argc, argv, "n:w:c:o:h", long_opts, NULL)) != -1) {
+      switch (opt) {
+         case 'n':
+            if (!Bench_parseCount(optarg, 1, &options->iterations)) {
+               fprintf(stderr, "Error: invalid iteration count \"%s\".\n", optarg);
+               return false;
+            }
+            break;
+         case 'w':
+            if (!Bench_parseCount(optarg, 1, &options->warmup)) {
+               fprintf(stderr, "Error: invalid warmup count \"%s\".\n", optarg);
+               return false;
+            }
+            break;
+         case 'c':
+            options->churn = optarg;
+            break;
+         case 'o':
+            options->output = optarg;
+            break;
+         case 'h':
+            Bench_usage(stdout);
+            exit(0);
+         default:
+            Bench_usage(stderr);
+            return false;
+      }
+   }
+
+   if (optind < argc) {
+      Bench_usage(stderr);
+      return false;
+   }
+
+   return true;
+}
+
+static void Bench_churn(const BenchOptions* options) {
+   if (!options->churn)
+      return;
+
+   fflush(stdout);
+   int r = system(options->churn);
+   if (r != 0) {
+      fprintf(stderr, "Error: churn command failed: %s\n", options->churn);
+      exit(1);
+   }
+}
+
+/* One update as ScanThread_scan and Machine_scanTables do it, timed by phase */
+static void Bench_iterate(Machine* host, Table* table, uint64_t times[LAST_BENCH_PHASE]) {
+   Settings* settings = host->settings;
+   uint64_t start;
+
+   Platform_gettime_realtime(&host->realtime, &host->realtimeMs);
+
+   start = Bench_now();
+   Machine_scan(host);
+   times[BENCH_MACHINE_SCAN] = Bench_now() - start;
+
+   host->prevMonotonicMs = host->monotonicMs;
+   Platform_gettime_monotonic(&host->monotonicMs);
+   host->maxUserId = 0;
+   Row_resetFieldWidths();
+   UsersTable_update(host->usersTable);
+   Table_scanPrepare(table);
+
+   start = Bench_now();
+   ProcessTable_goThroughEntries((ProcessTable*) table);
+   times[BENCH_GO_THROUGH_ENTRIES] = Bench_now() - start;
+
+   Table_scanCleanup(table);
+   Row_commitFieldWidths();
+   Row_setUidColumnWidth(host->maxUserId);
+
+   settings->ss->treeView = false;
+   table->needsSort = true;
+   start = Bench_now();
+   Table_updateDisplayList(table);
+   times[BENCH_SORT] = Bench_now() - start;
+
+   settings->ss->treeView = true;
+   table->needsSort = true;
+   start = Bench_now();
+   Table_updateDisplayList(table);
+   times[BENCH_TREE] = Bench_now() - start;
+
+   /* What Panel_draw does for each row, without a screen to draw to */
+   start = Bench_now();
+   int rows = Vector_size(table->displayList);
+   for (int i = 0; i < rows; i++) {
+      const Object* row = Vector_get(table->displayList, i);
+      RichString_begin(line);
+      Object_display(row, &line);
+      RichString_delete(&line);
+   }
+   times[BENCH_RENDER] = Bench_now() - start;
+}
+
+static int Bench_compare(const void* v1, const void* v2) {
+   uint64_t a = *(const uint64_t*)v1;
+   uint64_t b = *(const uint64_t*)v2;
+   return (a > b) - (a < b);
+}
+
+static void Bench_writePhase(FILE* out, const char* name, const uint64_t* samples, unsigned int count, bool last) {
+   uint64_t* sorted = xMallocArray(count, sizeof(uint64_t));
+   memcpy(sorted, samples, count * sizeof(uint64_t));
+   qsort(sorted, count, sizeof(uint64_t), Bench_compare);
+
+   uint64_t sum = 0;
+   for (unsigned int i = 0; i < count; i++)
+      sum += sorted[i];
+
+   /* Microseconds, nearest-rank percentiles */
+   fprintf(out, "    \"%s\": {\n", name);
+   fprintf(out, "      \"min_us\": %.1f,\n", sorted[0] / 1000.0);
+   fprintf(out, "      \"median_us\": %.1f,\n", sorted[(count + 1) / 2 - 1] / 1000.0);
+   fprintf(out, "      \"p95_us\": %.1f,\n", sorted[(count * 95 + 99) / 100 - 1] / 1000.0);
+   fprintf(out, "      \"max_us\": %.1f,\n", sorted[count - 1] / 1000.0);
+   fprintf(out, "      \"mean_us\": %.1f,\n", sum / 1000.0 / count);
+   fprintf(out, "      \"samples_us\": [");
+   for (unsigned int i = 0; i < count; i++)
+      fprintf(out, "%s%.1f", i ? ", " : "", samples[i] / 1000.0);
+   fprintf(out, "]\n    }%s\n", last ? "" : ",");
+
+   free(sorted);
+}
+
+static void Bench_writeResults(FILE* out, const BenchOptions* options, const Table* table, uint64_t* const samples[LAST_BENCH_PHASE]) {
+   const ProcessTable* pt = (const ProcessTable*) table;
+
+   fprintf(out, "{\n");
+#ifdef HTOP_PCP
+   const char* archive = getenv("PCP_ARCHIVE");
+   fprintf(out, "  \"archive\": \"%s\",\n", archive ? archive : "");
+#else
+   fprintf(out, "  \"procdir\": \"%s\",\n", PROCDIR);
+#endif
+   fprintf(out, "  \"version\": \"%s\",\n", VERSION);
+   fprintf(out, "  \"iterations\": %u,\n", options->iterations);
+   fprintf(out, "  \"warmup\": %u,\n", options->warmup);
+   fprintf(out, "  \"churn\": %s,\n", options->churn ? "true" : "false");
+   fprintf(out, "  \"rows\": %d,\n", Vector_size(table->rows));
+   fprintf(out, "  \"kernel_threads\": %u,\n", pt->kernelThreads);
+   fprintf(out, "  \"userland_threads\": %u,\n", pt->userlandThreads);
+   fprintf(out, "  \"phases\": {\n");
+   for (unsigned int p = 0; p < LAST_BENCH_PHASE; p++)
+      Bench_writePhase(out, Bench_phaseNames[p], samples[p], options->iterations, p == LAST_BENCH_PHASE - 1);
+   fprintf(out, "  }\n");
+   fprintf(out, "}\n");
+}
+
+int main(int argc, char** argv) {
+   BenchOptions options = {
+      .iterations = 20,
+      .warmup = 2,
+      .churn = NULL,
+      .output = NULL,
+   };
+
+   if (!Bench_parseArguments(argc, argv, &options))
+      return 1;
+
+#ifdef HTOP_PCP
+   /* The archive comes from the environment, as for pcp-htop */
+   pmSetProgname(program);
+   opts.flags |= PM_OPTFLAG_ENV_ONLY;
+   (void)pmGetOptions(argc, argv, &opts);
+#endif
+
+   /* Keep the user's configuration out of the results */
+   setenv("HTOPRC", "/dev/null", 1);
+   Settings_enableReadonly();
+
+   if (!Platform_init())
+      return 1;
+
+   UsersTable* ut = UsersTable_new();
+   Hashtable* dm = DynamicMeters_new();
+   Hashtable* dc = DynamicColumns_new();
+   Hashtable* ds = DynamicScreens_new();
+
+   Machine* host = Machine_new(ut, (uid_t)-1);
+   ProcessTable* pt = ProcessTable_new(host, NULL);
+   Settings* settings = Settings_new(host, dm, dc, ds);
+
+   settings->ss = Settings_newScreen(settings, &Bench_screen);
+   settings->ssIndex = settings->nScreens - 1;
+   settings->hideKernelThreads = false;
+   settings->hideUserlandThreads = false;
+   settings->hideRunningInContainer = false;
+   settings->showThreadNames = false;
+   settings->updateProcessNames = false;
+   Machine_populateTablesFromSettings(host, settings, &pt->super);
+
+   /* Rendering only needs attributes, not a terminal to show them on */
+   static int colors[LAST_COLORELEMENT];
+   CRT_colors = colors;
+
+   Table* table = &pt->super;
+   uint64_t times[LAST_BENCH_PHASE];
+   uint64_t* samples[LAST_BENCH_PHASE];
+   for (unsigned int p = 0; p < LAST_BENCH_PHASE; p++)
+      samples[p] = xCalloc(options.iterations, sizeof(uint64_t));
+
+   /* The first scan adds every process; later ones are steady state */
+   for (unsigned int i = 0; i < options.warmup; i++) {
+      Bench_churn(&options);
+      Bench_iterate(host, table, times);
+   }
+
+   for (unsigned int i = 0; i < options.iterations; i++) {
+      Bench_churn(&options);
+      Bench_iterate(host, table, times);
+      for (unsigned int p = 0; p < LAST_BENCH_PHASE; p++)
+         samples[p][i] = times[p];
+   }
+
+   FILE* out = stdout;
+   if (options.output) {
+      out = fopen(options.output, "w");
+      if (!out) {
+         fprintf(stderr, "Error: cannot write %s\n", options.output);
+         return 1;
+      }
+   }
+   Bench_writeResults(out, &options, table, samples);
+   if (out != stdout)
+      fclose(out);
+
+   for (unsigned int p = 0; p < LAST_BENCH_PHASE; p++)
+      free(samples[p]);
+
+   Platform_done();
+   Machine_delete(host);
+   UsersTable_delete(ut);
+   Settings_delete(settings);
+   DynamicColumns_delete(dc);
+   DynamicMeters_delete(dm);
+   DynamicScreens_delete(ds);
+
+   return 0;
+}
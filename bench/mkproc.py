@@ -0,0 +1,519 @@
+#!/usr/bin/env python3
+"""
+htop - bench/mkproc.py
+(C) 2024 htop dev team
+Released under the GNU GPLv2+, see the COPYING file
+in the source distribution for its full text.
+
+Generates a synthetic Linux /proc tree for the scan benchmark (htop-bench).
+
+  mkproc.py [-p PROCESSES] [-t THREADS] [-k KTHREADS] [-s SEED] DIR
+      creates DIR with PROCESSES userland processes of THREADS threads each,
+      plus KTHREADS kernel threads
+
+  mkproc.py --churn PERCENT DIR
+      advances an existing tree by one update interval: all counters move on,
+      PERCENT of the processes exit and as many new ones are started
+
+The tree only depends on the arguments and the seed, so two runs with the same
+arguments give the same fixture; its state is kept in DIR/.mkproc.json.
+"""
+
+import argparse
+import json
+import os
+import random
+import shutil
+import sys
+
+STATE_FILE = ".mkproc.json"
+HZ = 100
+PAGE_SIZE = 4096
+INTERVAL = 1.5            # seconds between two churn steps
+UPTIME = 864000.0         # ten days
+BTIME = 1700000000
+MEM_TOTAL_KB = 32 * 1024 * 1024
+PF_KTHREAD = 0x00200000
+
+PROGRAMS = [
+   ("systemd", "/usr/lib/systemd/systemd", ["--user"]),
+   ("bash", "/usr/bin/bash", []),
+   ("zsh", "/usr/bin/zsh", ["-l"]),
+   ("sshd", "/usr/sbin/sshd", ["-D"]),
+   ("postgres", "/usr/lib/postgresql/16/bin/postgres", ["-D", "/var/lib/postgresql/16/main"]),
+   ("nginx", "/usr/sbin/nginx", ["-g", "daemon off;"]),
+   ("java", "/usr/lib/jvm/java-21/bin/java", ["-Xmx2g", "-jar", "/opt/app/server.jar"]),
+   ("node", "/usr/bin/node", ["/srv/web/index.js"]),
+   ("python3", "/usr/bin/python3.12", ["-m", "http.server", "8080"]),
+   ("chrome", "/opt/google/chrome/chrome", ["--type=renderer", "--lang=en-US"]),
+   ("containerd", "/usr/bin/containerd", []),
+   ("dbus-daemon", "/usr/bin/dbus-daemon", ["--session", "--address=systemd:"]),
+   ("vim", "/usr/bin/vim", ["src/main.c"]),
+   ("make", "/usr/bin/make", ["-j8"]),
+   ("cc1", "/usr/libexec/gcc/x86_64-linux-gnu/13/cc1", ["-quiet", "main.c"]),
+]
+
+KTHREADS = ["kworker/%d:1", "ksoftirqd/%d", "migration/%d", "rcu_preempt", "kswapd0", "jbd2/sda1-8"]
+
+CGROUPS = [
+   "/init.scope",
+   "/system.slice/sshd.service",
+   "/system.slice/postgresql.service",
+   "/system.slice/nginx.service",
+   "/system.slice/docker-4f3c2b1a9e8d7c6b5a4f3e2d1c0b9a8f7e6d5c4b3a2f1e0d9c8b7a6f5e4d3c2b.scope",
+   "/user.slice/user-1000.slice/session-2.scope",
+   "/user.slice/user-1000.slice/user@1000.service/app.slice/app-org.gnome.Terminal.slice/vte-spawn.scope",
+]
+
+LIBRARIES = [
+   "/usr/lib/x86_64-linux-gnu/libc.so.6",
+   "/usr/lib/x86_64-linux-gnu/libm.so.6",
+   "/usr/lib/x86_64-linux-gnu/libpthread.so.0",
+   "/usr/lib/x86_64-linux-gnu/libssl.so.3",
+   "/usr/lib/x86_64-linux-gnu/libcrypto.so.3",
+   "/usr/lib/x86_64-linux-gnu/ld-linux-x86-64.so.2",
+]
+
+
+def write(path, content):
+   with open(path, "w") as f:
+      f.write(content)
+
+
+def new_task(rng, state, pid, tgid, ppid, kernel, program):
+   age = rng.uniform(30.0, UPTIME - 60.0) if pid > 300 else UPTIME - rng.uniform(0.5, 5.0)
+   return {
+      "pid": pid,
+      "tgid": tgid,
+      "ppid": ppid,
+      "kernel": kernel,
+      "program": program,
+      "comm": program if kernel else PROGRAMS[program][0],
+      "start": int((UPTIME - age) * HZ),
+      "cpu": rng.choice([0.0, 0.0, 0.0, 0.1, 0.5, 2.0, 15.0, 80.0]),
+      "utime": rng.randint(0, 50000),
+      "stime": rng.randint(0, 20000),
+      "rss": 0 if kernel else rng.randint(500, 200000),
+      "io": rng.choice([0, 0, 4096, 65536, 1048576]),
+      "rchar": rng.randint(0, 1 << 30),
+      "wchar": rng.randint(0, 1 << 28),
+      "ctxt": rng.randint(0, 100000),
+      "cgroup": "/" if kernel else rng.choice(CGROUPS),
+      "state": rng.choice("SSSSSSSRD") if not kernel else rng.choice("SI"),
+      "processor": rng.randrange(state["cpus"]),
+   }
+
+
+def advance(rng, task):
+   ticks = task["cpu"] / 100.0 * INTERVAL * HZ
+   task["utime"] += int(ticks * 0.7 + rng.random())
+   task["stime"] += int(ticks * 0.3 + rng.random())
+   task["ctxt"] += rng.randint(0, 50) if task["cpu"] > 0 else 0
+   if task["io"]:
+      task["rchar"] += rng.randint(0, task["io"])
+      task["wchar"] += rng.randint(0, task["io"] // 4)
+   if task["cpu"] > 0:
+      task["state"] = rng.choice("SSSR")
+
+
+def stat_line(task, threads):
+   t = task
+   rss = t["rss"]
+   flags = PF_KTHREAD | 0x40 if t["kernel"] else 0x400100
+   fields = [
+      t["pid"], "(%s)" % t["comm"], t["state"], t["ppid"],
+      t["tgid"], t["tgid"], 0 if t["kernel"] else 34817, -1, flags,
+      t["utime"] * 3, 0, t["utime"] // 50, 0,
+      t["utime"], t["stime"], 0, 0,
+      20, 0, threads, 0, t["start"],
+      0 if t["kernel"] else rss * PAGE_SIZE * 3, rss, "18446744073709551615",
+      0 if t["kernel"] else 94000000000000, 0 if t["kernel"] else 94000000200000,
+      0 if t["kernel"] else 140720000000000, 0, 0, 0, 0, 0 if t["kernel"] else 4096, 0 if t["kernel"] else 81920,
+      0, 0, 0, 17, t["processor"], 0, 0, t["utime"] // 1000, 0, 0,
+      0, 0, 0, 0, 0, 0, 0, 0,
+   ]
+   return " ".join(str(f) for f in fields) + "\n"
+
+
+def status_text(task, threads, uid):
+   t = task
+   kb = t["rss"] * PAGE_SIZE // 1024
+   name = t["comm"][:15]
+   state = {"S": "S (sleeping)", "R": "R (running)", "D": "D (disk sleep)", "I": "I (idle)"}[t["state"]]
+   lines = [
+      "Name:\t%s" % name,
+      "Umask:\t0022",
+      "State:\t%s" % state,
+      "Tgid:\t%d" % t["tgid"],
+      "Ngid:\t0",
+      "Pid:\t%d" % t["pid"],
+      "PPid:\t%d" % t["ppid"],
+      "TracerPid:\t0",
+      "Uid:\t%d\t%d\t%d\t%d" % (uid, uid, uid, uid),
+      "Gid:\t%d\t%d\t%d\t%d" % (uid, uid, uid, uid),
+      "FDSize:\t64",
+      "Groups:\t%d" % uid,
+      "NStgid:\t%d" % t["tgid"],
+      "NSpid:\t%d" % t["pid"],
+      "NSpgid:\t%d" % t["tgid"],
+      "NSsid:\t%d" % t["tgid"],
+   ]
+   if not t["kernel"]:
+      lines += [
+         "VmPeak:\t%8d kB" % (kb * 4),
+         "VmSize:\t%8d kB" % (kb * 3),
+         "VmLck:\t%8d kB" % 0,
+         "VmPin:\t%8d kB" % 0,
+         "VmHWM:\t%8d kB" % (kb + kb // 5),
+         "VmRSS:\t%8d kB" % kb,
+         "RssAnon:\t%8d kB" % (kb * 2 // 3),
+         "RssFile:\t%8d kB" % (kb // 3),
+         "RssShmem:\t%8d kB" % 0,
+         "VmData:\t%8d kB" % (kb * 2),
+         "VmStk:\t%8d kB" % 132,
+         "VmExe:\t%8d kB" % 1024,
+         "VmLib:\t%8d kB" % 8192,
+         "VmPTE:\t%8d kB" % 200,
+         "VmSwap:\t%8d kB" % (kb // 10),
+         "HugetlbPages:\t%8d kB" % 0,
+         "CoreDumping:\t0",
+         "THP_enabled:\t1",
+      ]
+   lines += [
+      "Threads:\t%d" % threads,
+      "SigQ:\t0/127573",
+      "SigPnd:\t0000000000000000",
+      "ShdPnd:\t0000000000000000",
+      "SigBlk:\t0000000000000000",
+      "SigIgn:\t0000000000001000",
+      "SigCgt:\t0000000180004002",
+      "CapInh:\t0000000000000000",
+      "CapPrm:\t0000000000000000",
+      "CapEff:\t0000000000000000",
+      "CapBnd:\t000001ffffffffff",
+      "CapAmb:\t0000000000000000",
+      "NoNewPrivs:\t0",
+      "Seccomp:\t0",
+      "Seccomp_filters:\t0",
+      "Speculation_Store_Bypass:\tthread vulnerable",
+      "SpeculationIndirectBranch:\tconditional enabled",
+      "Cpus_allowed:\tffff",
+      "Cpus_allowed_list:\t0-15",
+      "Mems_allowed:\t00000001",
+      "Mems_allowed_list:\t0",
+      "voluntary_ctxt_switches:\t%d" % (t["ctxt"] * 9 // 10),
+      "nonvoluntary_ctxt_switches:\t%d" % (t["ctxt"] // 10),
+   ]
+   return "\n".join(lines) + "\n"
+
+
+def statm_text(task):
+   rss = task["rss"]
+   return "%d %d %d %d 0 %d 0\n" % (rss * 3, rss, rss // 3, 256, rss * 2)
+
+
+def io_text(task):
+   t = task
+   return ("rchar: %d\nwchar: %d\nsyscr: %d\nsyscw: %d\nread_bytes: %d\n"
+           "write_bytes: %d\ncancelled_write_bytes: 0\n") % (
+      t["rchar"], t["wchar"], t["rchar"] // 4096, t["wchar"] // 4096, t["rchar"] // 2, t["wchar"] // 2)
+
+
+def mappings(task):
+   program = PROGRAMS[task["program"]]
+   maps = []
+   address = 0x555555554000
+   for perms, path in [("r--p", program[1]), ("r-xp", program[1]), ("rw-p", program[1])]:
+      maps.append((address, 0x1000 * 16, perms, path))
+      address += 0x1000 * 16
+   maps.append((0x555555a00000, task["rss"] * PAGE_SIZE * 2 // 3 + 0x1000, "rw-p", "[heap]"))
+   address = 0x7f0000000000
+   for lib in LIBRARIES:
+      for perms in ("r--p", "r-xp", "rw-p"):
+         maps.append((address, 0x1000 * 8, perms, lib))
+         address += 0x1000 * 8
+   maps.append((0x7ffc00000000, 0x21000, "rw-p", "[stack]"))
+   maps.append((0x7ffc00100000, 0x2000, "r-xp", "[vdso]"))
+   return maps
+
+
+def maps_text(task):
+   lines = []
+   for start, size, perms, path in mappings(task):
+      inode = 0 if path.startswith("[") else 1000 + len(path)
+      dev = "00:00" if path.startswith("[") else "08:01"
+      lines.append("%012x-%012x %s 00000000 %s %-10d                %s" % (start, start + size, perms, dev, inode, path))
+   return "\n".join(lines) + "\n"
+
+
+SMAPS_KEYS = ["Rss", "Pss", "Pss_Dirty", "Shared_Clean", "Shared_Dirty", "Private_Clean", "Private_Dirty",
+              "Referenced", "Anonymous", "LazyFree", "AnonHugePages", "ShmemPmdMapped", "FilePmdMapped",
+              "Shared_Hugetlb", "Private_Hugetlb", "Swap", "SwapPss", "Locked"]
+
+
+def smaps_values(size_kb, anon):
+   rss = size_kb // 2
+   return {
+      "Rss": rss, "Pss": rss // 2, "Pss_Dirty": rss // 4 if anon else 0,
+      "Shared_Clean": 0 if anon else rss // 2, "Shared_Dirty": 0,
+      "Private_Clean": 0 if anon else rss // 2, "Private_Dirty": rss if anon else 0,
+      "Referenced": rss, "Anonymous": rss if anon else 0, "LazyFree": 0, "AnonHugePages": 0,
+      "ShmemPmdMapped": 0, "FilePmdMapped": 0, "Shared_Hugetlb": 0, "Private_Hugetlb": 0,
+      "Swap": size_kb // 16 if anon else 0, "SwapPss": size_kb // 16 if anon else 0, "Locked": 0,
+   }
+
+
+def smaps_texts(task):
+   lines = []
+   total = dict.fromkeys(SMAPS_KEYS, 0)
+   for start, size, perms, path in mappings(task):
+      inode = 0 if path.startswith("[") else 1000 + len(path)
+      dev = "00:00" if path.startswith("[") else "08:01"
+      lines.append("%012x-%012x %s 00000000 %s %-10d                %s" % (start, start + size, perms, dev, inode, path))
+      size_kb = size // 1024
+      values = smaps_values(size_kb, path in ("[heap]", "[stack]") or perms == "rw-p")
+      lines.append("Size:           %8d kB" % size_kb)
+      lines.append("KernelPageSize:        4 kB")
+      lines.append("MMUPageSize:           4 kB")
+      for key in SMAPS_KEYS:
+         lines.append("%-16s%8d kB" % (key + ":", values[key]))
+         total[key] += values[key]
+      lines.append("THPeligible:    0")
+      lines.append("VmFlags: rd wr mr mw me ac sd")
+   rollup = ["00400000-7fffffffff ---p 00000000 00:00 0                          [rollup]"]
+   for key in SMAPS_KEYS:
+      rollup.append("%-16s%8d kB" % (key + ":", total[key]))
+   return "\n".join(lines) + "\n", "\n".join(rollup) + "\n"
+
+
+def cmdline_text(task):
+   if task["kernel"]:
+      return ""
+   name, exe, args = PROGRAMS[task["program"]]
+   return "\0".join([exe] + args) + "\0"
+
+
+def write_task(root, path, task, threads, uid, full):
+   os.makedirs(path, exist_ok=True)
+   write(os.path.join(path, "stat"), stat_line(task, threads))
+   write(os.path.join(path, "statm"), statm_text(task))
+   write(os.path.join(path, "status"), status_text(task, threads, uid))
+   write(os.path.join(path, "io"), io_text(task))
+   if not full:
+      return
+
+   write(os.path.join(path, "comm"), task["comm"] + "\n")
+   write(os.path.join(path, "cmdline"), cmdline_text(task))
+   write(os.path.join(path, "cgroup"), "0::%s\n" % task["cgroup"])
+   write(os.path.join(path, "oom_score"), "%d\n" % (task["rss"] * 1000 // (MEM_TOTAL_KB // 4)))
+   write(os.path.join(path, "oom_score_adj"), "0\n")
+   os.makedirs(os.path.join(path, "ns"), exist_ok=True)
+   depth = os.path.relpath(root, path)
+   os.symlink(os.path.join("..", depth, "nsroot"), os.path.join(path, "ns", "pid"))
+   if not task["kernel"]:
+      os.symlink(PROGRAMS[task["program"]][1], os.path.join(path, "exe"))
+      write(os.path.join(path, "maps"), maps_text(task))
+      smaps, rollup = smaps_texts(task)
+      write(os.path.join(path, "smaps"), smaps)
+      write(os.path.join(path, "smaps_rollup"), rollup)
+
+
+def process_path(root, process):
+   return os.path.join(root, str(process["main"]["pid"]))
+
+
+def write_process(root, process, uid, full):
+   path = process_path(root, process)
+   tasks = [process["main"]] + process["threads"]
+   write_task(root, path, process["main"], len(tasks), uid, full)
+   for task in tasks:
+      write_task(root, os.path.join(path, "task", str(task["pid"])), task, len(tasks), uid, full)
+
+
+def new_process(rng, state, ppid, program=None, kernel=None, count=None):
+   pid = state["nextPid"]
+   if kernel is not None:
+      program = kernel
+   elif program is None:
+      program = rng.randrange(len(PROGRAMS))
+   main = new_task(rng, state, pid, pid, ppid, kernel is not None, program)
+   if count is None:
+      count = 0 if kernel is not None else state["threads"]
+   threads = []
+   for tid in range(pid + 1, pid + 1 + count):
+      thread = new_task(rng, state, tid, pid, ppid, False, program)
+      thread.update(rss=main["rss"], cgroup=main["cgroup"], start=main["start"])
+      threads.append(thread)
+   state["nextPid"] = pid + 1 + count
+   return {"main": main, "threads": threads}
+
+
+def write_system(root, state):
+   cpus = state["cpus"]
+   tick = state["tick"]
+   busy = int(tick * INTERVAL * HZ * 0.2)
+   idle = int(UPTIME * HZ) + int(tick * INTERVAL * HZ)
+   lines = ["cpu  %d 120 %d %d 500 0 300 0 0 0" % (busy * cpus, busy * cpus // 3, idle * cpus)]
+   for i in range(cpus):
+      lines.append("cpu%d %d 15 %d %d 60 0 40 0 0 0" % (i, busy, busy // 3, idle))
+   running = sum(1 for p in state["processes"] if p["main"]["state"] == "R")
+   tasks = sum(1 + len(p["threads"]) for p in state["processes"])
+   lines += [
+      "intr 0",
+      "ctxt %d" % (123456789 + tick * 10000),
+      "btime %d" % BTIME,
+      "processes %d" % state["nextPid"],
+      "procs_running %d" % max(running, 1),
+      "procs_blocked 0",
+      "softirq 0 0 0 0 0 0 0 0 0 0 0",
+   ]
+   write(os.path.join(root, "stat"), "\n".join(lines) + "\n")
+
+   write(os.path.join(root, "meminfo"), "\n".join([
+      "MemTotal:       %8d kB" % MEM_TOTAL_KB,
+      "MemFree:        %8d kB" % (MEM_TOTAL_KB // 3),
+      "MemAvailable:   %8d kB" % (MEM_TOTAL_KB // 2),
+      "Buffers:        %8d kB" % 204800,
+      "Cached:         %8d kB" % (MEM_TOTAL_KB // 6),
+      "SwapCached:     %8d kB" % 1024,
+      "Active:         %8d kB" % (MEM_TOTAL_KB // 4),
+      "Inactive:       %8d kB" % (MEM_TOTAL_KB // 5),
+      "SwapTotal:      %8d kB" % (8 * 1024 * 1024),
+      "SwapFree:       %8d kB" % (7 * 1024 * 1024),
+      "Zswap:          %8d kB" % 0,
+      "Zswapped:       %8d kB" % 0,
+      "Dirty:          %8d kB" % 512,
+      "Shmem:          %8d kB" % 409600,
+      "SReclaimable:   %8d kB" % 307200,
+      "SUnreclaim:     %8d kB" % 102400,
+      "HugePages_Total:       0",
+      "HugePages_Free:        0",
+      "Hugepagesize:       2048 kB",
+   ]) + "\n")
+
+   write(os.path.join(root, "cpuinfo"), "".join(
+      "processor\t: %d\ncpu MHz\t\t: %.3f\n\n" % (i, 2400.0 + 100 * (i % 4)) for i in range(cpus)))
+   uptime = UPTIME + tick * INTERVAL
+   write(os.path.join(root, "uptime"), "%.2f %.2f\n" % (uptime, uptime * cpus * 0.9))
+   write(os.path.join(root, "loadavg"), "1.25 1.10 0.95 %d/%d %d\n" % (max(running, 1), tasks, state["nextPid"] - 1))
+
+
+def create(args):
+   root = args.dir
+   if os.path.exists(root):
+      if not os.path.exists(os.path.join(root, STATE_FILE)):
+         sys.exit("%s: %s exists and is not a fixture tree" % (sys.argv[0], root))
+      shutil.rmtree(root)
+
+   rng = random.Random(args.seed)
+   state = {
+      "seed": args.seed,
+      "threads": args.threads,
+      "cpus": args.cpus,
+      "uid": os.getuid(),
+      "tick": 0,
+      "nextPid": 1,
+      "processes": [],
+   }
+
+   # init, kthreadd and its kernel threads, then userland processes below init
+   processes = state["processes"]
+   processes.append(new_process(rng, state, 0, program=0, count=0))
+   processes.append(new_process(rng, state, 0, kernel="kthreadd"))
+   for i in range(args.kthreads):
+      name = KTHREADS[i % len(KTHREADS)]
+      if "%d" in name:
+         name = name % (i % args.cpus)
+      processes.append(new_process(rng, state, 2, kernel=name))
+   state["nextPid"] = max(state["nextPid"], 1000)
+   for _ in range(args.processes - 1):
+      userland = [p for p in processes[-50:] if not p["main"]["kernel"]] or [processes[0]]
+      processes.append(new_process(rng, state, rng.choice(userland)["main"]["pid"]))
+
+   os.makedirs(root)
+   for sub in ("sys/kernel", "sys/fs", "tty", "pressure"):
+      os.makedirs(os.path.join(root, sub))
+   write(os.path.join(root, "nsroot"), "")
+   write(os.path.join(root, "sys/kernel/pid_max"), "4194304\n")
+   write(os.path.join(root, "sys/fs/file-nr"), "12000\t0\t9223372036854775807\n")
+   write(os.path.join(root, "tty/drivers"),
+         "/dev/tty             /dev/tty        5       0 system:/dev/tty\n"
+         "/dev/console         /dev/console    5       1 system:console\n"
+         "/dev/ptmx            /dev/ptmx       5       2 system\n"
+         "pty_slave            /dev/pts      136 0-1048575 pty:slave\n"
+         "serial               /dev/ttyS       4 64-95 serial\n")
+   for resource in ("cpu", "io", "memory"):
+      write(os.path.join(root, "pressure", resource),
+            "some avg10=0.00 avg60=0.00 avg300=0.00 total=0\nfull avg10=0.00 avg60=0.00 avg300=0.00 total=0\n")
+
+   for process in processes:
+      write_process(root, process, state["uid"], True)
+   os.symlink("1", os.path.join(root, "self"))
+   os.symlink("1/task/1", os.path.join(root, "thread-self"))
+
+   write_system(root, state)
+   save(root, state, rng)
+
+
+def churn(args):
+   root = args.dir
+   with open(os.path.join(root, STATE_FILE)) as f:
+      state = json.load(f)
+   rng = random.Random()
+   rng.setstate((state["rng"][0], tuple(state["rng"][1]), state["rng"][2]))
+   state["tick"] += 1
+
+   processes = state["processes"]
+   userland = [i for i, p in enumerate(processes) if not p["main"]["kernel"] and p["main"]["pid"] != 1]
+   exiting = set(rng.sample(userland, min(len(userland), len(userland) * args.churn // 100)))
+   for i in exiting:
+      shutil.rmtree(process_path(root, processes[i]))
+   survivors = [p for i, p in enumerate(processes) if i not in exiting]
+   pids = {p["main"]["pid"] for p in survivors}
+   for p in survivors:
+      if p["main"]["ppid"] not in pids and p["main"]["ppid"] not in (0, 2):
+         p["main"]["ppid"] = 1
+
+   for p in survivors:
+      for task in [p["main"]] + p["threads"]:
+         advance(rng, task)
+      write_process(root, p, state["uid"], False)
+
+   parents = [p for p in survivors if not p["main"]["kernel"]]
+   for _ in exiting:
+      process = new_process(rng, state, rng.choice(parents)["main"]["pid"])
+      for task in [process["main"]] + process["threads"]:
+         task["start"] = int((UPTIME + state["tick"] * INTERVAL) * HZ)
+      survivors.append(process)
+      write_process(root, process, state["uid"], True)
+
+   state["processes"] = survivors
+   write_system(root, state)
+   save(root, state, rng)
+
+
+def save(root, state, rng):
+   state["rng"] = rng.getstate()
+   with open(os.path.join(root, STATE_FILE), "w") as f:
+      json.dump(state, f)
+
+
+def main():
+   parser = argparse.ArgumentParser(description="Generate a synthetic /proc tree for htop-bench.")
+   parser.add_argument("-p", "--processes", type=int, default=500, help="userland processes (default: 500)")
+   parser.add_argument("-t", "--threads", type=int, default=4, help="extra threads per process (default: 4)")
+   parser.add_argument("-k", "--kthreads", type=int, default=100, help="kernel threads (default: 100)")
+   parser.add_argument("-c", "--cpus", type=int, default=os.cpu_count() or 1, help="CPUs in /proc/stat (default: this machine's)")
+   parser.add_argument("-s", "--seed", type=int, default=1, help="random seed (default: 1)")
+   parser.add_argument("--churn", type=int, metavar="PERCENT", help="advance an existing tree, replacing PERCENT of the processes")
+   parser.add_argument("dir", help="root of the tree, used as PROCDIR by htop-bench")
+   args = parser.parse_args()
+
+   if args.churn is not None:
+      churn(args)
+   else:
+      create(args)
+
+
+if __name__ == "__main__":
+   main()
@@ -76,6 +76,12 @@ void Process_delete(Object* cast) {
 }
 
 static void DarwinProcess_rowWriteField(const Row* super, RichString* str, ProcessField field) {
+   /* Groups only sum up the fields common to all platforms */
+   if (Row_isGroup(super)) {
+      Process_writeField((const Process*) super, str, field);
+      return;
+   }
+
    const DarwinProcess* dp = (const DarwinProcess*) super;
 
    char buffer[256]; buffer[255] = '\0';
@@ -522,6 +528,10 @@ void DarwinProcess_scanThreads(DarwinProcess* dp, DarwinProcessTable* dpt) {
 }
 
 
+static Row* DarwinProcess_rowNewGroup(const Row* member, const char* key) {
+   return Process_newGroup(member, key, DarwinProcess_new);
+}
+
 const ProcessClass DarwinProcess_class = {
    .super = {
       .super = {
@@ -535,7 +545,11 @@ const ProcessClass DarwinProcess_class = {
       .matchesFilter = Process_rowMatchesFilter,
       .compareByParent = Process_compareByParent,
       .sortKeyString = Process_rowGetSortKey,
-      .writeField = DarwinProcess_rowWriteField
+      .writeField = DarwinProcess_rowWriteField,
+      .groupKey = Process_rowGroupKey,
+      .newGroup = DarwinProcess_rowNewGroup,
+      .accumulate = Process_rowAccumulate,
+      .resetGroup = Process_rowResetGroup
    },
    .compareByKey = DarwinProcess_compareByKey
 };
@@ -98,6 +98,8 @@ void ProcessTable_goThroughEntries(ProcessTable* super) {
    ps = ProcessTable_getKInfoProcs(&count);
 
    for (size_t i = 0; i < count; ++i) {
+      Machine_yield(host);
+
       proc = (DarwinProcess*)ProcessTable_getProcess(super, ps[i].kp_proc.p_pid, &preExisting, DarwinProcess_new);
 
       DarwinProcess_setFromKInfoProc(&proc->super, &ps[i], preExisting);
@@ -110,7 +112,7 @@ void ProcessTable_goThroughEntries(ProcessTable* super) {
          proc->super.state = STOPPED;
       }
 
-      if (proc->super.st_uid != ps[i].kp_eproc.e_ucred.cr_uid) {
+      if (proc->super.st_uid != ps[i].kp_eproc.e_ucred.cr_uid || !proc->super.user) {
          proc->super.st_uid = ps[i].kp_eproc.e_ucred.cr_uid;
          proc->super.user = UsersTable_getRef(host->usersTable, proc->super.st_uid);
       }
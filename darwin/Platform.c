@@ -46,6 +46,8 @@ in the source distribution for its full text.
 #include "MemoryMeter.h"
 #include "MemorySwapMeter.h"
 #include "ProcessLocksScreen.h"
+#include "ProfileMeter.h"
+#include "SelfMeter.h"
 #include "SwapMeter.h"
 #include "SysArchMeter.h"
 #include "TasksMeter.h"
@@ -129,6 +131,10 @@ const MeterClass* const Platform_meterTypes[] = {
    &HostnameMeter_class,
    &SysArchMeter_class,
    &UptimeMeter_class,
+   &SelfMeter_class,
+#ifdef BUILD_WITH_PROFILING
+   &ProfileMeter_class,
+#endif
    &AllCPUsMeter_class,
    &AllCPUs2Meter_class,
    &AllCPUs4Meter_class,
@@ -141,6 +147,7 @@ const MeterClass* const Platform_meterTypes[] = {
    &RightCPUs4Meter_class,
    &LeftCPUs8Meter_class,
    &RightCPUs8Meter_class,
+   &CPUHeatmapMeter_class,
    &ZfsArcMeter_class,
    &ZfsCompressedArcMeter_class,
    &DiskIOMeter_class,
@@ -438,6 +445,34 @@ FileLocks_ProcessData* Platform_getProcessLocks(pid_t pid) {
    return NULL;
 }
 
+int Platform_getOpenFiles(pid_t pid, OpenFiles_EntryCallback callback, void* context) {
+   (void)pid;
+   (void)callback;
+   (void)context;
+   return -1;
+}
+
+int Platform_newSyscallSampler(pid_t pid, SyscallSampler** sampler) {
+   (void)pid;
+   *sampler = NULL;
+   return -1;
+}
+
+void Platform_deleteSyscallSampler(SyscallSampler* sampler) {
+   (void)sampler;
+}
+
+int Platform_sampleSyscalls(SyscallSampler* sampler) {
+   (void)sampler;
+   return 0;
+}
+
+SyscallSampler_Entry** Platform_getSyscallSamples(SyscallSampler* sampler, size_t* count) {
+   (void)sampler;
+   *count = 0;
+   return NULL;
+}
+
 void Platform_getFileDescriptors(double* used, double* max) {
    Generic_getFileDescriptors_sysctl(used, max);
 }
@@ -67,6 +67,12 @@ void Process_delete(Object* cast) {
 }
 
 static void DragonFlyBSDProcess_rowWriteField(const Row* super, RichString* str, ProcessField field) {
+   /* Groups only sum up the fields common to all platforms */
+   if (Row_isGroup(super)) {
+      Process_writeField((const Process*) super, str, field);
+      return;
+   }
+
    const Process* this = (const Process*) super;
    const DragonFlyBSDProcess* fp = (const DragonFlyBSDProcess*) super;
 
@@ -102,6 +108,10 @@ static int DragonFlyBSDProcess_compareByKey(const Process* v1, const Process* v2
    }
 }
 
+static Row* DragonFlyBSDProcess_rowNewGroup(const Row* member, const char* key) {
+   return Process_newGroup(member, key, DragonFlyBSDProcess_new);
+}
+
 const ProcessClass DragonFlyBSDProcess_class = {
    .super = {
       .super = {
@@ -115,7 +125,11 @@ const ProcessClass DragonFlyBSDProcess_class = {
       .matchesFilter = Process_rowMatchesFilter,
       .compareByParent = Process_compareByParent,
       .sortKeyString = Process_rowGetSortKey,
-      .writeField = DragonFlyBSDProcess_rowWriteField
+      .writeField = DragonFlyBSDProcess_rowWriteField,
+      .groupKey = Process_rowGroupKey,
+      .newGroup = DragonFlyBSDProcess_rowNewGroup,
+      .accumulate = Process_rowAccumulate,
+      .resetGroup = Process_rowResetGroup
    },
    .compareByKey = DragonFlyBSDProcess_compareByKey
 };
@@ -143,6 +143,8 @@ void ProcessTable_goThroughEntries(ProcessTable* super) {
 
    for (int i = 0; i < count; i++) {
       const struct kinfo_proc* kproc = &kprocs[i];
+      Machine_yield(host);
+
       bool preExisting = false;
       bool ATTR_UNUSED isIdleProcess = false;
 
@@ -201,7 +203,7 @@ void ProcessTable_goThroughEntries(ProcessTable* super) {
          }
          // if there are reapers in the system, process can get reparented anytime
          Process_setParent(proc, kproc->kp_ppid);
-         if (proc->st_uid != kproc->kp_uid) {	// some processes change users (eg. to lower privs)
+         if (proc->st_uid != kproc->kp_uid || !proc->user) {	// some processes change users (eg. to lower privs)
             proc->st_uid = kproc->kp_uid;
             proc->user = UsersTable_getRef(host->usersTable, proc->st_uid);
          }
@@ -83,6 +83,12 @@ static const char FreeBSD_schedclassChars[MAX_SCHEDCLASS] = {
 };
 
 static void FreeBSDProcess_rowWriteField(const Row* super, RichString* str, ProcessField field) {
+   /* Groups only sum up the fields common to all platforms */
+   if (Row_isGroup(super)) {
+      Process_writeField((const Process*) super, str, field);
+      return;
+   }
+
    const FreeBSDProcess* fp = (const FreeBSDProcess*) super;
 
    char buffer[256]; buffer[255] = '\0';
@@ -136,6 +142,10 @@ static int FreeBSDProcess_compareByKey(const Process* v1, const Process* v2, Pro
    }
 }
 
+static Row* FreeBSDProcess_rowNewGroup(const Row* member, const char* key) {
+   return Process_newGroup(member, key, FreeBSDProcess_new);
+}
+
 const ProcessClass FreeBSDProcess_class = {
    .super = {
       .super = {
@@ -149,7 +159,11 @@ const ProcessClass FreeBSDProcess_class = {
       .matchesFilter = Process_rowMatchesFilter,
       .compareByParent = Process_compareByParent,
       .sortKeyString = Process_rowGetSortKey,
-      .writeField = FreeBSDProcess_rowWriteField
+      .writeField = FreeBSDProcess_rowWriteField,
+      .groupKey = Process_rowGroupKey,
+      .newGroup = FreeBSDProcess_rowNewGroup,
+      .accumulate = Process_rowAccumulate,
+      .resetGroup = Process_rowResetGroup
    },
    .compareByKey = FreeBSDProcess_compareByKey
 };
@@ -167,6 +167,8 @@ void ProcessTable_goThroughEntries(ProcessTable* super) {
 
    for (int i = 0; i < count; i++) {
       const struct kinfo_proc* kproc = &kprocs[i];
+      Machine_yield(host);
+
       bool preExisting = false;
       Process* proc = ProcessTable_getProcess(super, kproc->ki_pid, &preExisting, FreeBSDProcess_new);
       FreeBSDProcess* fp = (FreeBSDProcess*) proc;
@@ -216,7 +218,7 @@ void ProcessTable_goThroughEntries(ProcessTable* super) {
          }
          // if there are reapers in the system, process can get reparented anytime
          Process_setParent(proc, kproc->ki_ppid);
-         if (proc->st_uid != kproc->ki_uid) {
+         if (proc->st_uid != kproc->ki_uid || !proc->user) {
             // some processes change users (eg. to lower privs)
             proc->st_uid = kproc->ki_uid;
             proc->user = UsersTable_getRef(host->usersTable, proc->st_uid);
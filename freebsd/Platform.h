@@ -16,10 +16,12 @@ in the source distribution for its full text.
 #include "Hashtable.h"
 #include "Meter.h"
 #include "NetworkIOMeter.h"
+#include "OpenFilesScreen.h"
 #include "Process.h"
 #include "ProcessLocksScreen.h"
 #include "SignalsPanel.h"
 #include "CommandLine.h"
+#include "TraceScreen.h"
 #include "generic/gettime.h"
 #include "generic/hostname.h"
 #include "generic/uname.h"
@@ -61,6 +63,21 @@ char* Platform_getProcessEnv(pid_t pid);
 
 FileLocks_ProcessData* Platform_getProcessLocks(pid_t pid);
 
+/* Returns 0 on success, -1 without native support (lsof is used then) or an errno value */
+int Platform_getOpenFiles(pid_t pid, OpenFiles_EntryCallback callback, void* context);
+
+/* Starts sampling the system calls the threads of a process are in, without stopping them.
+   Returns 0 on success, -1 without support on this platform or an errno value */
+int Platform_newSyscallSampler(pid_t pid, SyscallSampler** sampler);
+
+void Platform_deleteSyscallSampler(SyscallSampler* sampler);
+
+/* Takes one sample of every thread; returns 0 or an errno value */
+int Platform_sampleSyscalls(SyscallSampler* sampler);
+
+/* Returns a newly allocated, unsorted array of the entries, to be released with free() */
+SyscallSampler_Entry** Platform_getSyscallSamples(SyscallSampler* sampler, size_t* count);
+
 void Platform_getFileDescriptors(double* used, double* max);
 
 bool Platform_getDiskIO(DiskIOData* data);
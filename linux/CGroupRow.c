@@ -0,0 +1,187 @@
+/*
+htop - CGroupRow.c
+(C) 2024 htop dev team
+Released under the GNU GPLv2+, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "config.h" // IWYU pragma: keep
+
+#include "linux/CGroupRow.h"
+
+#include <limits.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "CRT.h"
+#include "Macros.h"
+#include "RichString.h"
+#include "Settings.h"
+#include "Table.h"
+#include "XUtils.h"
+
+
+CGroupRow* CGroupRow_new(const Machine* host, int id, const CGroupRow* parent, const char* name, int dirfd, ino_t inode) {
+   CGroupRow* this = xCalloc(1, sizeof(CGroupRow));
+   Object_setClass(this, Class(CGroupRow));
+
+   Row* super = &this->super;
+   Row_init(super, host);
+   super->id = id;
+   super->group = id;
+   super->parent = parent ? parent->super.id : 0;
+
+   if (!parent) {
+      this->path = xStrdup("/");
+      this->name = this->path;
+   } else {
+      bool atRoot = String_eq(parent->path, "/");
+      xAsprintf(&this->path, "%s/%s", atRoot ? "" : parent->path, name);
+      this->name = strrchr(this->path, '/') + 1;
+   }
+   this->dirfd = dirfd;
+   this->inode = inode;
+
+   this->cpuUsageUsec = ULLONG_MAX;
+   this->ioReadBytes = ULLONG_MAX;
+   this->ioWriteBytes = ULLONG_MAX;
+   this->ioReadRate = NAN;
+   this->ioWriteRate = NAN;
+   this->memoryCurrent = ULLONG_MAX;
+   this->memoryPeak = ULLONG_MAX;
+   this->pidsCurrent = ULLONG_MAX;
+   this->cpuPressure = NAN;
+   this->memoryPressure = NAN;
+   this->ioPressure = NAN;
+
+   return this;
+}
+
+void CGroupRow_done(CGroupRow* this) {
+   if (this->dirfd >= 0)
+      close(this->dirfd);
+   free(this->path);
+   Row_done(&this->super);
+}
+
+static void CGroupRow_delete(Object* cast) {
+   CGroupRow* this = (CGroupRow*) cast;
+   CGroupRow_done(this);
+   free(this);
+}
+
+static void CGroupRow_writeField(const Row* super, RichString* str, RowField field) {
+   const CGroupRow* this = (const CGroupRow*) super;
+   const Settings* settings = super->host->settings;
+   bool coloring = settings->highlightMegabytes;
+   char buffer[256]; buffer[255] = '\0';
+   int attr = CRT_colors[DEFAULT_COLOR];
+   size_t n = sizeof(buffer) - 1;
+
+   switch (field) {
+   case CGROUP_CPU:
+      Row_printPercentage(this->cpuPercent, buffer, n, 5, &attr);
+      break;
+   case CGROUP_MEMORY: Row_printBytes(str, this->memoryCurrent, coloring); return;
+   case CGROUP_MEMORY_PEAK: Row_printBytes(str, this->memoryPeak, coloring); return;
+   case CGROUP_IO_READ: Row_printRate(str, this->ioReadRate, coloring); return;
+   case CGROUP_IO_WRITE: Row_printRate(str, this->ioWriteRate, coloring); return;
+   case CGROUP_PIDS:
+      if (this->pidsCurrent == ULLONG_MAX) {
+         attr = CRT_colors[PROCESS_SHADOW];
+         xSnprintf(buffer, n, "%5s ", "N/A");
+      } else {
+         xSnprintf(buffer, n, "%5llu ", this->pidsCurrent);
+      }
+      break;
+   case CGROUP_CPU_PRESSURE:
+      Row_printPercentage(this->cpuPressure, buffer, n, 7, &attr);
+      break;
+   case CGROUP_MEMORY_PRESSURE:
+      Row_printPercentage(this->memoryPressure, buffer, n, 7, &attr);
+      break;
+   case CGROUP_IO_PRESSURE:
+      Row_printPercentage(this->ioPressure, buffer, n, 7, &attr);
+      break;
+   case CGROUP_NAME:
+      if (settings->ss->treeView) {
+         Row_printTreeBranch(super, str);
+         RichString_appendWide(str, CRT_colors[PROCESS_BASENAME], this->name);
+      } else {
+         RichString_appendWide(str, attr, this->path);
+      }
+      return;
+   default:
+      attr = CRT_colors[PROCESS_SHADOW];
+      xSnprintf(buffer, n, "- ");
+      break;
+   }
+
+   RichString_appendAscii(str, attr, buffer);
+}
+
+static bool CGroupRow_matchesFilter(const Row* super, const Table* table) {
+   const CGroupRow* this = (const CGroupRow*) super;
+   const char* incFilter = table->incFilter;
+   return incFilter && !String_contains_i(this->path, incFilter, true);
+}
+
+static const char* CGroupRow_sortKeyString(Row* super) {
+   const CGroupRow* this = (const CGroupRow*) super;
+   return this->path;
+}
+
+static int CGroupRow_compareByKey(const CGroupRow* c1, const CGroupRow* c2, RowField key) {
+   switch (key) {
+   case CGROUP_CPU:
+      return compareRealNumbers(c2->cpuPercent, c1->cpuPercent);
+   case CGROUP_MEMORY:
+      return SPACESHIP_NUMBER(c2->memoryCurrent, c1->memoryCurrent);
+   case CGROUP_MEMORY_PEAK:
+      return SPACESHIP_NUMBER(c2->memoryPeak, c1->memoryPeak);
+   case CGROUP_IO_READ:
+      return compareRealNumbers(c2->ioReadRate, c1->ioReadRate);
+   case CGROUP_IO_WRITE:
+      return compareRealNumbers(c2->ioWriteRate, c1->ioWriteRate);
+   case CGROUP_PIDS:
+      return SPACESHIP_NUMBER(c2->pidsCurrent, c1->pidsCurrent);
+   case CGROUP_CPU_PRESSURE:
+      return compareRealNumbers(c2->cpuPressure, c1->cpuPressure);
+   case CGROUP_MEMORY_PRESSURE:
+      return compareRealNumbers(c2->memoryPressure, c1->memoryPressure);
+   case CGROUP_IO_PRESSURE:
+      return compareRealNumbers(c2->ioPressure, c1->ioPressure);
+   case CGROUP_NAME:
+      return SPACESHIP_NULLSTR(c1->path, c2->path);
+   default:
+      return 0;
+   }
+}
+
+static int CGroupRow_compare(const void* v1, const void* v2) {
+   const CGroupRow* c1 = (const CGroupRow*)v1;
+   const CGroupRow* c2 = (const CGroupRow*)v2;
+   const ScreenSettings* ss = c1->super.host->settings->ss;
+   RowField key = ScreenSettings_getActiveSortKey(ss);
+   int result = CGroupRow_compareByKey(c1, c2, key);
+
+   // Implement tie-breaker (needed to make tree mode more stable)
+   if (!result)
+      return SPACESHIP_NUMBER(c1->super.id, c2->super.id);
+
+   return (ScreenSettings_getActiveDirection(ss) == 1) ? result : -result;
+}
+
+const RowClass CGroupRow_class = {
+   .super = {
+      .extends = Class(Row),
+      .display = Row_display,
+      .delete = CGroupRow_delete,
+      .compare = CGroupRow_compare,
+   },
+   .matchesFilter = CGroupRow_matchesFilter,
+   .sortKeyString = CGroupRow_sortKeyString,
+   .writeField = CGroupRow_writeField,
+};
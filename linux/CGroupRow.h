@@ -0,0 +1,71 @@
+#ifndef HEADER_CGroupRow
+#define HEADER_CGroupRow
+/*
+htop - CGroupRow.h
+(C) 2024 htop dev team
+Released under the GNU GPLv2+, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+#include "Machine.h"
+#include "Object.h"
+#include "Row.h"
+#include "RowField.h"
+
+
+/* Columns of the cgroups screen, the first dynamic keys on Linux */
+typedef enum CGroupField_ {
+   CGROUP_CPU = ROW_DYNAMIC_FIELDS,
+   CGROUP_MEMORY,
+   CGROUP_MEMORY_PEAK,
+   CGROUP_IO_READ,
+   CGROUP_IO_WRITE,
+   CGROUP_PIDS,
+   CGROUP_CPU_PRESSURE,
+   CGROUP_MEMORY_PRESSURE,
+   CGROUP_IO_PRESSURE,
+   CGROUP_NAME,
+   LAST_CGROUPFIELD
+} CGroupField;
+
+typedef struct CGroupRow_ {
+   Row super;
+
+   char* path;           /* relative to the cgroup root, "/" for the root itself */
+   const char* name;     /* last component of path */
+   int dirfd;            /* kept open, files are read relative to it */
+   ino_t inode;          /* tells a recreated cgroup of the same name apart */
+
+   /* cgroup tree as found by the last full directory walk */
+   struct CGroupRow_* firstChild;
+   struct CGroupRow_* nextSibling;
+
+   uint64_t sampleMs;    /* monotonic time the counters were read at */
+
+   /* cumulative counters, ULLONG_MAX when the controller is not enabled */
+   unsigned long long cpuUsageUsec;
+   unsigned long long ioReadBytes;
+   unsigned long long ioWriteBytes;
+
+   float cpuPercent;
+   double ioReadRate;       /* bytes per second */
+   double ioWriteRate;      /* bytes per second */
+   unsigned long long memoryCurrent;   /* bytes */
+   unsigned long long memoryPeak;      /* bytes */
+   unsigned long long pidsCurrent;
+   float cpuPressure;       /* "some" avg10 of the pressure files, NAN if absent */
+   float memoryPressure;
+   float ioPressure;
+} CGroupRow;
+
+extern const RowClass CGroupRow_class;
+
+CGroupRow* CGroupRow_new(const Machine* host, int id, const CGroupRow* parent, const char* name, int dirfd, ino_t inode);
+
+void CGroupRow_done(CGroupRow* this);
+
+#endif
@@ -0,0 +1,181 @@
+/*
+htop - CGroupScreen.c
+(C) 2024 htop dev team
+Released under the GNU GPLv2+, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "config.h" // IWYU pragma: keep
+
+#include "linux/CGroupScreen.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+
+#include "Compat.h"
+#include "DynamicColumn.h"
+#include "ListItem.h"
+#include "Macros.h"
+#include "Object.h"
+#include "XUtils.h"
+
+#include "linux/CGroupRow.h"
+
+
+#define CGROUP_SCREEN_NAME "cgroups"
+
+typedef struct CGroupColumnDefinition_ {
+   const char* name;
+   const char* heading;
+   const char* description;
+   int width;
+} CGroupColumnDefinition;
+
+static const CGroupColumnDefinition CGroupScreen_columnDefinitions[] = {
+   [CGROUP_CPU - ROW_DYNAMIC_FIELDS] = { "cpu", "CPU%", "Percentage of the CPU time used by the cgroup and its descendants", 5 },
+   [CGROUP_MEMORY - ROW_DYNAMIC_FIELDS] = { "memory", "MEM", "Memory charged to the cgroup (memory.current)", 5 },
+   [CGROUP_MEMORY_PEAK - ROW_DYNAMIC_FIELDS] = { "memory_peak", "PEAK", "Highest memory usage recorded for the cgroup (memory.peak)", 5 },
+   [CGROUP_IO_READ - ROW_DYNAMIC_FIELDS] = { "io_read", "DISK READ", "Block device read rate of the cgroup (io.stat)", 11 },
+   [CGROUP_IO_WRITE - ROW_DYNAMIC_FIELDS] = { "io_write", "DISK WRITE", "Block device write rate of the cgroup (io.stat)", 11 },
+   [CGROUP_PIDS - ROW_DYNAMIC_FIELDS] = { "pids", "TASKS", "Number of tasks in the cgroup and its descendants (pids.current)", 5 },
+   [CGROUP_CPU_PRESSURE - ROW_DYNAMIC_FIELDS] = { "cpu_pressure", "CPU PSI", "Share of time some tasks stalled on CPU over the last 10s (cpu.pressure)", 7 },
+   [CGROUP_MEMORY_PRESSURE - ROW_DYNAMIC_FIELDS] = { "memory_pressure", "MEM PSI", "Share of time some tasks stalled on memory over the last 10s (memory.pressure)", 7 },
+   [CGROUP_IO_PRESSURE - ROW_DYNAMIC_FIELDS] = { "io_pressure", "IO PSI", "Share of time some tasks stalled on I/O over the last 10s (io.pressure)", 7 },
+   [CGROUP_NAME - ROW_DYNAMIC_FIELDS] = { "name", "CGROUP", "Path of the cgroup, or its name in tree view", -6 },
+};
+
+static_assert(ARRAYSIZE(CGroupScreen_columnDefinitions) == LAST_CGROUPFIELD - ROW_DYNAMIC_FIELDS,
+              "CGroupScreen_columnDefinitions must cover all cgroup fields");
+
+static Hashtable* CGroupScreen_columnTable;
+static Hashtable* CGroupScreen_screenTable;
+
+Hashtable* CGroupScreen_columns(void) {
+   if (CGroupScreen_columnTable)
+      return CGroupScreen_columnTable;
+
+   Hashtable* columns = Hashtable_new(ARRAYSIZE(CGroupScreen_columnDefinitions), true);
+   for (unsigned int key = ROW_DYNAMIC_FIELDS; key < LAST_CGROUPFIELD; key++) {
+      const CGroupColumnDefinition* definition = &CGroupScreen_columnDefinitions[key - ROW_DYNAMIC_FIELDS];
+      DynamicColumn* column = xCalloc(1, sizeof(DynamicColumn));
+      xSnprintf(column->name, sizeof(column->name), "%s:%s", CGROUP_SCREEN_NAME, definition->name);
+      column->heading = xStrdup(definition->heading);
+      column->description = xStrdup(definition->description);
+      column->width = definition->width;
+      column->enabled = true;
+      Hashtable_put(columns, key, column);
+   }
+
+   CGroupScreen_columnTable = columns;
+   return columns;
+}
+
+Hashtable* CGroupScreen_screens(void) {
+   if (CGroupScreen_screenTable)
+      return CGroupScreen_screenTable;
+
+   CGroupScreen* screen = xCalloc(1, sizeof(CGroupScreen));
+   xSnprintf(screen->super.name, sizeof(screen->super.name), "%s", CGROUP_SCREEN_NAME);
+   screen->super.heading = xStrdup("Cgroups");
+   screen->super.caption = xStrdup("Resource usage per control group (cgroup v2)");
+   screen->super.direction = 1;
+
+   char* columnKeys = xStrdup("");
+   for (unsigned int key = ROW_DYNAMIC_FIELDS; key < LAST_CGROUPFIELD; key++) {
+      char* prefix = columnKeys;
+      xAsprintf(&columnKeys, "%s%sDynamic(%s:%s)", prefix, *prefix ? " " : "",
+                CGROUP_SCREEN_NAME, CGroupScreen_columnDefinitions[key - ROW_DYNAMIC_FIELDS].name);
+      free(prefix);
+   }
+   screen->super.columnKeys = columnKeys;
+
+   CGroupScreen_screenTable = Hashtable_new(1, true);
+   Hashtable_put(CGroupScreen_screenTable, 0, screen);
+   return CGroupScreen_screenTable;
+}
+
+static CGroupScreen* CGroupScreen_get(void) {
+   return CGroupScreen_screenTable ? Hashtable_get(CGroupScreen_screenTable, 0) : NULL;
+}
+
+const char* CGroupScreen_columnName(unsigned int key) {
+   const DynamicColumn* column = CGroupScreen_columnTable ? Hashtable_get(CGroupScreen_columnTable, key) : NULL;
+   if (!column)
+      return NULL;
+   return column->heading ? column->heading : column->name;
+}
+
+void CGroupScreen_appendTables(Machine* host) {
+   CGroupScreen* screen = CGroupScreen_get();
+   if (!screen || screen->table)
+      return;
+
+   screen->table = CGroupTable_new(host);
+
+   /* mark the columns as belonging to this screen, not to processes */
+   for (unsigned int key = ROW_DYNAMIC_FIELDS; key < LAST_CGROUPFIELD; key++) {
+      DynamicColumn* column = CGroupScreen_columnTable ? Hashtable_get(CGroupScreen_columnTable, key) : NULL;
+      if (column)
+         column->table = &screen->table->super;
+   }
+}
+
+void CGroupScreen_appendScreens(Settings* settings) {
+   const CGroupScreen* screen = CGroupScreen_get();
+   if (!screen || !screen->table || !screen->table->root)
+      return;
+
+   Settings_newDynamicScreen(settings, screen->super.heading, &screen->super, &screen->table->super);
+}
+
+/* called when htoprc .dynamic line is parsed, or a screen is added in Setup */
+void CGroupScreen_addDynamicScreen(ScreenSettings* ss) {
+   const CGroupScreen* screen = CGroupScreen_get();
+   if (!screen || !screen->table)
+      return;
+
+   if (String_eq(ss->dynamic, screen->super.name))
+      ss->table = &screen->table->super;
+}
+
+void CGroupScreen_addAvailableColumns(Panel* availableColumns, const char* screen) {
+   Vector_prune(availableColumns->items);
+
+   if (!CGroupScreen_columnTable || !String_eq(screen, CGROUP_SCREEN_NAME))
+      return;
+
+   for (unsigned int key = ROW_DYNAMIC_FIELDS; key < LAST_CGROUPFIELD; key++) {
+      const DynamicColumn* column = Hashtable_get(CGroupScreen_columnTable, key);
+      if (!column)
+         continue;
+
+      char description[256];
+      xSnprintf(description, sizeof(description), "%s - %s", column->heading, column->description);
+      Panel_add(availableColumns, (Object*) ListItem_new(description, key));
+   }
+}
+
+static void CGroupScreen_freeColumn(ATTR_UNUSED ht_key_t key, void* value, ATTR_UNUSED void* data) {
+   DynamicColumn_done((DynamicColumn*) value);
+}
+
+void CGroupScreen_columnsDone(Hashtable* columns) {
+   Hashtable_foreach(columns, CGroupScreen_freeColumn, NULL);
+   if (columns == CGroupScreen_columnTable)
+      CGroupScreen_columnTable = NULL;
+}
+
+static void CGroupScreen_freeScreen(ATTR_UNUSED ht_key_t key, void* value, ATTR_UNUSED void* data) {
+   CGroupScreen* screen = (CGroupScreen*) value;
+   if (screen->table)
+      Object_delete(screen->table);
+   DynamicScreen_done(&screen->super);
+}
+
+void CGroupScreen_screensDone(Hashtable* screens) {
+   Hashtable_foreach(screens, CGroupScreen_freeScreen, NULL);
+   if (screens == CGroupScreen_screenTable)
+      CGroupScreen_screenTable = NULL;
+}
@@ -0,0 +1,42 @@
+#ifndef HEADER_CGroupScreen
+#define HEADER_CGroupScreen
+/*
+htop - CGroupScreen.h
+(C) 2024 htop dev team
+Released under the GNU GPLv2+, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "DynamicScreen.h"
+#include "Hashtable.h"
+#include "Machine.h"
+#include "Panel.h"
+#include "Settings.h"
+
+#include "linux/CGroupTable.h"
+
+
+typedef struct CGroupScreen_ {
+   DynamicScreen super;
+   CGroupTable* table;
+} CGroupScreen;
+
+Hashtable* CGroupScreen_columns(void);
+
+Hashtable* CGroupScreen_screens(void);
+
+const char* CGroupScreen_columnName(unsigned int key);
+
+void CGroupScreen_appendTables(Machine* host);
+
+void CGroupScreen_appendScreens(Settings* settings);
+
+void CGroupScreen_addDynamicScreen(ScreenSettings* ss);
+
+void CGroupScreen_addAvailableColumns(Panel* availableColumns, const char* screen);
+
+void CGroupScreen_columnsDone(Hashtable* columns);
+
+void CGroupScreen_screensDone(Hashtable* screens);
+
+#endif
@@ -0,0 +1,354 @@
+/*
+htop - CGroupTable.c
+(C) 2024 htop dev team
+Released under the GNU GPLv2+, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "config.h" // IWYU pragma: keep
+
+#include "linux/CGroupTable.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "Machine.h"
+#include "Macros.h"
+#include "Object.h"
+#include "Row.h"
+#include "Table.h"
+#include "XUtils.h"
+
+#include "linux/CGroupRow.h"
+
+
+static int CGroupTable_openRoot(ino_t* inode) {
+   /* pure cgroup v2, then the unified part of a hybrid setup */
+   static const char* const candidates[] = { "/sys/fs/cgroup", "/sys/fs/cgroup/unified" };
+
+   for (size_t i = 0; i < ARRAYSIZE(candidates); i++) {
+      int fd = open(candidates[i], O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+      if (fd < 0)
+         continue;
+
+      struct stat sb;
+      if (faccessat(fd, "cgroup.controllers", F_OK, 0) == 0 && fstat(fd, &sb) == 0) {
+         *inode = sb.st_ino;
+         return fd;
+      }
+      close(fd);
+   }
+   return -1;
+}
+
+CGroupTable* CGroupTable_new(Machine* host) {
+   CGroupTable* this = xCalloc(1, sizeof(CGroupTable));
+   Object_setClass(this, Class(CGroupTable));
+
+   Table* super = &this->super;
+   Table_init(super, Class(CGroupRow), host);
+
+   ino_t inode;
+   int fd = CGroupTable_openRoot(&inode);
+   if (fd >= 0) {
+      this->root = CGroupRow_new(host, ++this->nextId, NULL, NULL, fd, inode);
+      Table_add(super, &this->root->super);
+   }
+   this->descendants = ULLONG_MAX;
+   this->needsWalk = true;
+
+   return this;
+}
+
+void CGroupTable_done(CGroupTable* this) {
+   Table_done(&this->super);
+}
+
+static void CGroupTable_delete(Object* cast) {
+   CGroupTable* this = (CGroupTable*) cast;
+   CGroupTable_done(this);
+   free(this);
+}
+
+static bool CGroupTable_isActive(const CGroupTable* this) {
+   return this->super.host->activeTable == &this->super;
+}
+
+static unsigned long long CGroupTable_readNumber(int dirfd, const char* file) {
+   char buffer[32];
+   if (xReadfileat(dirfd, file, buffer, sizeof(buffer)) <= 0)
+      return ULLONG_MAX;
+
+   char* end;
+   unsigned long long value = strtoull(buffer, &end, 10);
+   return end != buffer ? value : ULLONG_MAX;
+}
+
+/* Looks up "key value" in a flat-keyed file such as cpu.stat or cgroup.stat */
+static unsigned long long CGroupTable_readKey(int dirfd, const char* file, const char* key) {
+   char buffer[1024];
+   if (xReadfileat(dirfd, file, buffer, sizeof(buffer)) <= 0)
+      return ULLONG_MAX;
+
+   size_t len = strlen(key);
+   for (const char* line = buffer; *line; line = String_strchrnul(line, '\n')) {
+      if (*line == '\n')
+         line++;
+      if (strncmp(line, key, len) == 0 && line[len] == ' ')
+         return strtoull(line + len + 1, NULL, 10);
+   }
+   return ULLONG_MAX;
+}
+
+static float CGroupTable_readPressure(int dirfd, const char* file) {
+   char buffer[256];
+   if (xReadfileat(dirfd, file, buffer, sizeof(buffer)) <= 0)
+      return NAN;
+
+   float avg10;
+   if (sscanf(buffer, "some avg10=%f", &avg10) != 1)
+      return NAN;
+   return avg10;
+}
+
+/* io.stat has one line per device, "MAJ:MIN rbytes=N wbytes=N rios=N ..." */
+static bool CGroupTable_readIO(int dirfd, unsigned long long* readBytes, unsigned long long* writeBytes) {
+   char buffer[4096];
+   if (xReadfileat(dirfd, "io.stat", buffer, sizeof(buffer)) < 0)
+      return false;
+
+   *readBytes = 0;
+   *writeBytes = 0;
+   for (char* line = buffer; *line; line = String_strchrnul(line, '\n')) {
+      if (*line == '\n')
+         line++;
+
+      unsigned long long rbytes;
+      unsigned long long wbytes;
+      if (sscanf(line, "%*u:%*u rbytes=%llu wbytes=%llu", &rbytes, &wbytes) == 2) {
+         *readBytes += rbytes;
+         *writeBytes += wbytes;
+      }
+   }
+   return true;
+}
+
+static double CGroupTable_rate(unsigned long long previous, unsigned long long current, uint64_t periodMs) {
+   if (previous == ULLONG_MAX || current == ULLONG_MAX || !periodMs)
+      return current == ULLONG_MAX ? NAN : 0.0;
+   if (current < previous)
+      return 0.0;
+   return (double)(current - previous) * 1000.0 / (double)periodMs;
+}
+
+/* Returns whether the subtree of the cgroup was idle since the last read, going
+ * by its hierarchical counters; a first read is never idle */
+static bool CGroupTable_readStats(CGroupTable* this, CGroupRow* row) {
+   const Machine* host = this->super.host;
+   uint64_t periodMs = row->sampleMs ? host->monotonicMs - row->sampleMs : 0;
+   int fd = row->dirfd;
+   bool idle = periodMs != 0;
+
+   unsigned long long usage = CGroupTable_readKey(fd, "cpu.stat", "usage_usec");
+   if (usage == ULLONG_MAX && row->cpuUsageUsec != ULLONG_MAX)
+      this->needsWalk = true;   /* most likely removed since the last walk */
+   idle = idle && usage != ULLONG_MAX && usage == row->cpuUsageUsec;
+   row->cpuPercent = CGroupTable_rate(row->cpuUsageUsec, usage, periodMs) / 10000.0;
+   row->cpuUsageUsec = usage;
+
+   unsigned long long readBytes = ULLONG_MAX;
+   unsigned long long writeBytes = ULLONG_MAX;
+   if (!CGroupTable_readIO(fd, &readBytes, &writeBytes))
+      readBytes = writeBytes = ULLONG_MAX;
+   idle = idle && readBytes == row->ioReadBytes && writeBytes == row->ioWriteBytes;
+   row->ioReadRate = CGroupTable_rate(row->ioReadBytes, readBytes, periodMs);
+   row->ioWriteRate = CGroupTable_rate(row->ioWriteBytes, writeBytes, periodMs);
+   row->ioReadBytes = readBytes;
+   row->ioWriteBytes = writeBytes;
+
+   unsigned long long memory = CGroupTable_readNumber(fd, "memory.current");
+   unsigned long long pids = CGroupTable_readNumber(fd, "pids.current");
+   idle = idle && memory == row->memoryCurrent && pids == row->pidsCurrent;
+   row->memoryCurrent = memory;
+   row->memoryPeak = CGroupTable_readNumber(fd, "memory.peak");
+   row->pidsCurrent = pids;
+
+   row->cpuPressure = CGroupTable_readPressure(fd, "cpu.pressure");
+   row->memoryPressure = CGroupTable_readPressure(fd, "memory.pressure");
+   row->ioPressure = CGroupTable_readPressure(fd, "io.pressure");
+   idle = idle && !(row->cpuPressure > 0.0F) && !(row->memoryPressure > 0.0F) && !(row->ioPressure > 0.0F);
+
+   row->sampleMs = host->monotonicMs;
+   return idle;
+}
+
+/* Carries the rows of an idle subtree over to this scan without reading them:
+ * the cumulative counters cannot have moved, so the rates drop to zero */
+static void CGroupTable_keepRow(CGroupTable* this, CGroupRow* row) {
+   const Machine* host = this->super.host;
+
+   row->cpuPercent = row->cpuUsageUsec == ULLONG_MAX ? NAN : 0.0F;
+   row->ioReadRate = row->ioReadBytes == ULLONG_MAX ? NAN : 0.0;
+   row->ioWriteRate = row->ioWriteBytes == ULLONG_MAX ? NAN : 0.0;
+   if (row->cpuPressure > 0.0F)
+      row->cpuPressure = 0.0F;
+   if (row->memoryPressure > 0.0F)
+      row->memoryPressure = 0.0F;
+   if (row->ioPressure > 0.0F)
+      row->ioPressure = 0.0F;
+
+   row->sampleMs = host->monotonicMs;
+   row->super.updated = true;
+
+   for (CGroupRow* child = row->firstChild; child; child = child->nextSibling)
+      CGroupTable_keepRow(this, child);
+}
+
+/* Relinks the children of a cgroup from its directory, reusing the known rows */
+static void CGroupTable_readChildren(CGroupTable* this, CGroupRow* row) {
+   int fd = openat(row->dirfd, ".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+   if (fd < 0)
+      return;
+
+   DIR* dir = fdopendir(fd);
+   if (!dir) {
+      close(fd);
+      return;
+   }
+
+   /* children not seen again stay unlinked and are culled as not updated */
+   CGroupRow* previous = row->firstChild;
+   CGroupRow** tail = &row->firstChild;
+   row->firstChild = NULL;
+
+   const struct dirent* entry;
+   while ((entry = readdir(dir)) != NULL) {
+      if (entry->d_type != DT_DIR || entry->d_name[0] == '.')
+         continue;
+
+      CGroupRow* child = NULL;
+      for (CGroupRow** link = &previous; *link; link = &(*link)->nextSibling) {
+         if ((*link)->inode == entry->d_ino && String_eq((*link)->name, entry->d_name)) {
+            child = *link;
+            *link = child->nextSibling;
+            break;
+         }
+      }
+
+      if (!child) {
+         int childfd = openat(row->dirfd, entry->d_name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+         if (childfd < 0)
+            continue;
+
+         child = CGroupRow_new(this->super.host, ++this->nextId, row, entry->d_name, childfd, entry->d_ino);
+         Table_add(&this->super, &child->super);
+      } else if (child->dirfd < 0) {
+         /* closed while the screen was hidden */
+         child->dirfd = openat(row->dirfd, entry->d_name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+         if (child->dirfd < 0)
+            continue;
+      }
+
+      child->nextSibling = NULL;
+      *tail = child;
+      tail = &child->nextSibling;
+   }
+
+   closedir(dir);
+}
+
+/* Writeback, reclaim and stalls change the stats without any CPU time charged,
+ * so a subtree is only skipped when none of its hierarchical counters moved and
+ * nothing stalled; memory moving between siblings is caught by the next walk */
+static void CGroupTable_scanRow(CGroupTable* this, CGroupRow* row, bool walk) {
+   bool idle = CGroupTable_readStats(this, row);
+   row->super.updated = true;
+
+   if (walk)
+      CGroupTable_readChildren(this, row);
+
+   for (CGroupRow* child = row->firstChild; child; child = child->nextSibling) {
+      if (idle && !walk)
+         CGroupTable_keepRow(this, child);
+      else
+         CGroupTable_scanRow(this, child, walk);
+   }
+}
+
+/* Hidden, the table keeps its rows but not a descriptor per cgroup, which on
+ * large hosts could starve the process scan; the next walk reopens them */
+static void CGroupTable_closeDirs(CGroupRow* row) {
+   for (CGroupRow* child = row->firstChild; child; child = child->nextSibling) {
+      if (child->dirfd >= 0) {
+         close(child->dirfd);
+         child->dirfd = -1;
+      }
+      CGroupTable_closeDirs(child);
+   }
+}
+
+static void CGroupTable_prepareEntries(Table* super) {
+   CGroupTable* this = (CGroupTable*) super;
+
+   /* only the screen on display is refreshed, the others keep their rows */
+   if (CGroupTable_isActive(this))
+      Table_prepareEntries(super);
+}
+
+static void CGroupTable_iterateEntries(Table* super) {
+   CGroupTable* this = (CGroupTable*) super;
+   const Machine* host = super->host;
+
+   if (!this->root)
+      return;
+
+   if (!CGroupTable_isActive(this)) {
+      if (this->dirsOpen) {
+         CGroupTable_closeDirs(this->root);
+         this->dirsOpen = false;
+         this->needsWalk = true;
+      }
+      return;
+   }
+   this->dirsOpen = true;
+
+   /* walk the directories again when cgroups came or went, and every few scans
+    * to notice a removal offset by a creation; the rows are stale after a pause */
+   unsigned long long descendants = CGroupTable_readKey(this->root->dirfd, "cgroup.stat", "nr_descendants");
+   bool walk = this->needsWalk ||
+               descendants != this->descendants ||
+               this->lastScanMs != host->prevMonotonicMs ||
+               ++this->scansSinceWalk >= CGROUP_WALK_INTERVAL;
+   if (walk) {
+      this->needsWalk = false;
+      this->scansSinceWalk = 0;
+      this->descendants = descendants;
+   }
+
+   CGroupTable_scanRow(this, this->root, walk);
+   this->lastScanMs = host->monotonicMs;
+}
+
+static void CGroupTable_cleanupEntries(Table* super) {
+   CGroupTable* this = (CGroupTable*) super;
+
+   if (CGroupTable_isActive(this))
+      Table_cleanupEntries(super);
+}
+
+const TableClass CGroupTable_class = {
+   .super = {
+      .extends = Class(Table),
+      .delete = CGroupTable_delete,
+   },
+   .prepare = CGroupTable_prepareEntries,
+   .iterate = CGroupTable_iterateEntries,
+   .cleanup = CGroupTable_cleanupEntries,
+};
@@ -0,0 +1,40 @@
+#ifndef HEADER_CGroupTable
+#define HEADER_CGroupTable
+/*
+htop - CGroupTable.h
+(C) 2024 htop dev team
+Released under the GNU GPLv2+, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "Machine.h"
+#include "Table.h"
+
+#include "linux/CGroupRow.h"
+
+
+/* Number of scans reusing the known cgroup tree before walking the directories again */
+#define CGROUP_WALK_INTERVAL 10
+
+typedef struct CGroupTable_ {
+   Table super;
+
+   CGroupRow* root;      /* NULL without a cgroup v2 hierarchy */
+   int nextId;
+   unsigned long long descendants;   /* nr_descendants of the root at the last walk */
+   unsigned int scansSinceWalk;
+   uint64_t lastScanMs;
+   bool needsWalk;
+   bool dirsOpen;        /* descriptors below the root, closed while hidden */
+} CGroupTable;
+
+extern const TableClass CGroupTable_class;
+
+CGroupTable* CGroupTable_new(Machine* host);
+
+void CGroupTable_done(CGroupTable* this);
+
+#endif
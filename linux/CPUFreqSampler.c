@@ -0,0 +1,246 @@
+/*
+htop - linux/CPUFreqSampler.c
+(C) 2024 htop dev team
+Released under the GNU GPLv2+, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "config.h" // IWYU pragma: keep
+
+#include "linux/CPUFreqSampler.h"
+
+#include <fcntl.h>
+#include <math.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#include "Profile.h"
+#include "XUtils.h"
+
+
+/* Passes between attempts to open the files of CPUs without a readable one */
+#define CPUFREQ_SAMPLER_REOPEN_PASSES 15
+
+struct CPUFreqSampler_ {
+#ifdef HAVE_PTHREAD
+   /*
+    * The thread is detached, as a read might hang in a slow driver when htop
+    * exits, so whichever side lets go last frees the sampler.
+    */
+   pthread_mutex_t lock;
+   pthread_cond_t wakeup;
+   unsigned int refs;
+   bool stop;
+   bool threaded;
+   bool threadFailed;
+#endif
+
+   /* Shared state, guarded by the lock when threaded */
+   unsigned int cpus;            /* CPUs requested by the last CPUFreqSampler_get */
+   double* frequencies;          /* result of the last pass */
+   unsigned int frequencyCount;
+   bool ready;                   /* a pass has completed */
+   bool available;               /* the last pass found a readable file */
+
+   /* Only touched by the reading side */
+   int* fds;                     /* scaling_cur_freq of each CPU, -1 if absent */
+   unsigned int fdCount;
+   unsigned int passes;
+};
+
+CPUFreqSampler* CPUFreqSampler_new(void) {
+   CPUFreqSampler* this = xCalloc(1, sizeof(CPUFreqSampler));
+#ifdef HAVE_PTHREAD
+   pthread_mutex_init(&this->lock, NULL);
+   pthread_cond_init(&this->wakeup, NULL);
+   this->refs = 1;
+#endif
+   return this;
+}
+
+static void CPUFreqSampler_free(CPUFreqSampler* this) {
+   for (unsigned int i = 0; i < this->fdCount; i++) {
+      if (this->fds[i] >= 0) {
+         PROFILE_COUNT_CALLS(1);
+         close(this->fds[i]);
+      }
+   }
+
+#ifdef HAVE_PTHREAD
+   pthread_cond_destroy(&this->wakeup);
+   pthread_mutex_destroy(&this->lock);
+#endif
+   free(this->fds);
+   free(this->frequencies);
+   free(this);
+}
+
+static double* CPUFreqSampler_read(CPUFreqSampler* this, unsigned int cpus, bool* available) {
+   bool reopen = this->passes % CPUFREQ_SAMPLER_REOPEN_PASSES == 0;
+
+   if (cpus > this->fdCount) {
+      this->fds = xReallocArray(this->fds, cpus, sizeof(int));
+      for (unsigned int i = this->fdCount; i < cpus; i++)
+         this->fds[i] = -1;
+      this->fdCount = cpus;
+      reopen = true;
+   }
+
+   double* frequencies = xMallocArray(cpus, sizeof(double));
+   *available = false;
+
+   for (unsigned int i = 0; i < cpus; i++) {
+      frequencies[i] = NAN;
+
+      if (this->fds[i] < 0 && reopen) {
+         char path[64];
+         xSnprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%u/cpufreq/scaling_cur_freq", i);
+         PROFILE_COUNT_CALLS(1);
+         this->fds[i] = open(path, O_RDONLY | O_CLOEXEC);
+      }
+      if (this->fds[i] < 0)
+         continue;
+
+      /* sysfs regenerates the content on every read at offset 0 */
+      char buffer[32];
+      PROFILE_COUNT_CALLS(1);
+      ssize_t len = pread(this->fds[i], buffer, sizeof(buffer) - 1, 0);
+      if (len <= 0) {
+         /* CPU went offline */
+         PROFILE_COUNT_CALLS(1);
+         close(this->fds[i]);
+         this->fds[i] = -1;
+         continue;
+      }
+      buffer[len] = '\0';
+
+      char* end;
+      unsigned long frequency = strtoul(buffer, &end, 10);
+      if (end == buffer)
+         continue;
+
+      /* convert kHz to MHz */
+      frequencies[i] = (double)(frequency / 1000);
+      *available = true;
+   }
+
+   this->passes++;
+   return frequencies;
+}
+
+static void CPUFreqSampler_publish(CPUFreqSampler* this, double* frequencies, unsigned int cpus, bool available) {
+   free(this->frequencies);
+   this->frequencies = frequencies;
+   this->frequencyCount = cpus;
+   this->available = available;
+   this->ready = true;
+}
+
+#ifdef HAVE_PTHREAD
+
+static void CPUFreqSampler_release(CPUFreqSampler* this) {
+   pthread_mutex_lock(&this->lock);
+   bool last = --this->refs == 0;
+   pthread_mutex_unlock(&this->lock);
+
+   if (last)
+      CPUFreqSampler_free(this);
+}
+
+static void* CPUFreqSampler_thread(void* arg) {
+   CPUFreqSampler* this = arg;
+
+   pthread_mutex_lock(&this->lock);
+   while (!this->stop) {
+      unsigned int cpus = this->cpus;
+
+      /* Never hold the lock while reading, that is what the thread is for */
+      pthread_mutex_unlock(&this->lock);
+      bool available;
+      double* frequencies = CPUFreqSampler_read(this, cpus, &available);
+      pthread_mutex_lock(&this->lock);
+
+      CPUFreqSampler_publish(this, frequencies, cpus, available);
+      if (this->stop)
+         break;
+
+      struct timespec deadline;
+      clock_gettime(CLOCK_REALTIME, &deadline);
+      deadline.tv_sec += CPUFREQ_SAMPLER_INTERVAL / 1000;
+      deadline.tv_nsec += (CPUFREQ_SAMPLER_INTERVAL % 1000) * 1000000L;
+      if (deadline.tv_nsec >= 1000000000L) {
+         deadline.tv_sec++;
+         deadline.tv_nsec -= 1000000000L;
+      }
+      pthread_cond_timedwait(&this->wakeup, &this->lock, &deadline);
+   }
+   pthread_mutex_unlock(&this->lock);
+
+   CPUFreqSampler_release(this);
+   return NULL;
+}
+
+static void CPUFreqSampler_start(CPUFreqSampler* this) {
+   this->refs = 2;
+
+   pthread_t thread;
+   if (pthread_create(&thread, NULL, CPUFreqSampler_thread, this) != 0) {
+      this->refs = 1;
+      this->threadFailed = true;
+      return;
+   }
+
+   pthread_detach(thread);
+   this->threaded = true;
+}
+
+#endif /* HAVE_PTHREAD */
+
+void CPUFreqSampler_delete(CPUFreqSampler* this) {
+   if (!this)
+      return;
+
+#ifdef HAVE_PTHREAD
+   pthread_mutex_lock(&this->lock);
+   this->stop = true;
+   pthread_cond_signal(&this->wakeup);
+   pthread_mutex_unlock(&this->lock);
+   CPUFreqSampler_release(this);
+#else
+   CPUFreqSampler_free(this);
+#endif
+}
+
+static bool CPUFreqSampler_copy(const CPUFreqSampler* this, double* frequencies, unsigned int cpus) {
+   for (unsigned int i = 0; i < cpus; i++)
+      frequencies[i] = i < this->frequencyCount ? this->frequencies[i] : NAN;
+
+   return !this->ready || this->available;
+}
+
+bool CPUFreqSampler_get(CPUFreqSampler* this, double* frequencies, unsigned int cpus) {
+#ifdef HAVE_PTHREAD
+   if (!this->threaded && !this->threadFailed) {
+      this->cpus = cpus;
+      CPUFreqSampler_start(this);
+   }
+
+   if (this->threaded) {
+      pthread_mutex_lock(&this->lock);
+      this->cpus = cpus;
+      bool result = CPUFreqSampler_copy(this, frequencies, cpus);
+      pthread_mutex_unlock(&this->lock);
+      return result;
+   }
+#endif
+
+   bool available;
+   double* values = CPUFreqSampler_read(this, cpus, &available);
+   CPUFreqSampler_publish(this, values, cpus, available);
+   return CPUFreqSampler_copy(this, frequencies, cpus);
+}
@@ -0,0 +1,33 @@
+#ifndef HEADER_CPUFreqSampler
+#define HEADER_CPUFreqSampler
+/*
+htop - linux/CPUFreqSampler.h
+(C) 2024 htop dev team
+Released under the GNU GPLv2+, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include <stdbool.h>
+
+
+/* Milliseconds between two reads of the cpufreq files */
+#define CPUFREQ_SAMPLER_INTERVAL 2000
+
+/*
+ * Reads scaling_cur_freq of every CPU through persistent file descriptors.
+ * Where threads are available this happens in the background, as these reads
+ * take more than a millisecond per CPU on some AMD and Intel systems.
+ */
+typedef struct CPUFreqSampler_ CPUFreqSampler;
+
+CPUFreqSampler* CPUFreqSampler_new(void);
+
+void CPUFreqSampler_delete(CPUFreqSampler* this);
+
+/*
+ * Copies the most recent frequencies in MHz of 'cpus' CPUs, NAN where unknown.
+ * Returns false once it is known that no cpufreq file can be read.
+ */
+bool CPUFreqSampler_get(CPUFreqSampler* this, double* frequencies, unsigned int cpus);
+
+#endif
@@ -52,7 +52,27 @@ static void* dlopenHandle = NULL;
 
 #endif /* BUILD_STATIC */
 
+/* A temperature input and the CPU data indices it is reported for */
+typedef struct TempMapping_ {
+   const sensors_chip_name* chip;   /* owned by libsensors, valid until sensors_cleanup() */
+   int subfeature;
+   bool merge;                      /* platform temperature by feature ID, keep the bigger value */
+   size_t firstTarget;              /* first entry in mappingTargets */
+   size_t targetCount;
+} TempMapping;
+
+static TempMapping* mappings = NULL;
+static size_t mappingCount = 0;
+static unsigned int* mappingTargets = NULL;
+static size_t mappingTargetCount = 0;
+static unsigned int mappedCPUs = 0;   /* 0 if the mapping needs to be rebuilt */
+
+static double* temperatures = NULL;
+static unsigned int temperatureCount = 0;
+
 int LibSensors_init(void) {
+   mappedCPUs = 0;
+
 #ifdef BUILD_STATIC
 
    return sym_sensors_init(NULL);
@@ -104,6 +124,18 @@ dlfailure:
 }
 
 void LibSensors_cleanup(void) {
+   free(mappings);
+   mappings = NULL;
+   mappingCount = 0;
+   free(mappingTargets);
+   mappingTargets = NULL;
+   mappingTargetCount = 0;
+   mappedCPUs = 0;
+
+   free(temperatures);
+   temperatures = NULL;
+   temperatureCount = 0;
+
 #ifdef BUILD_STATIC
 
    sym_sensors_cleanup();
@@ -128,6 +160,9 @@ int LibSensors_reload(void) {
    }
 #endif /* !BUILD_STATIC */
 
+   /* Chip names are invalidated by sensors_cleanup() */
+   mappedCPUs = 0;
+
    sym_sensors_cleanup();
    return sym_sensors_init(NULL);
 }
@@ -201,19 +236,45 @@ int LibSensors_countCCDs(void) {
    return ccds;
 }
 
-void LibSensors_getCPUTemperatures(CPUData* cpus, unsigned int existingCPUs, unsigned int activeCPUs) {
-   assert(existingCPUs > 0 && existingCPUs < 16384);
+static void LibSensors_clearMapping(void) {
+   mappingCount = 0;
+   mappingTargetCount = 0;
+}
 
-   double* data = xMallocArray(existingCPUs + 1, sizeof(double));
-   for (size_t i = 0; i < existingCPUs + 1; i++)
-      data[i] = NAN;
+static TempMapping* LibSensors_addMapping(const sensors_chip_name* chip, int subfeature, bool merge) {
+   mappings = xReallocArray(mappings, mappingCount + 1, sizeof(*mappings));
 
-#ifndef BUILD_STATIC
-   if (!dlopenHandle)
-      goto out;
-#endif /* !BUILD_STATIC */
+   TempMapping* mapping = &mappings[mappingCount++];
+   *mapping = (TempMapping) {
+      .chip        = chip,
+      .subfeature  = subfeature,
+      .merge       = merge,
+      .firstTarget = mappingTargetCount,
+      .targetCount = 0,
+   };
+
+   return mapping;
+}
+
+static void LibSensors_addTarget(TempMapping* mapping, unsigned int index) {
+   mappingTargets = xReallocArray(mappingTargets, mappingTargetCount + 1, sizeof(*mappingTargets));
+   mappingTargets[mappingTargetCount++] = index;
+   mapping->targetCount++;
+}
+
+static void LibSensors_addTargetRange(TempMapping* mapping, unsigned int first, unsigned int last) {
+   for (unsigned int i = first; i <= last; i++)
+      LibSensors_addTarget(mapping, i);
+}
+
+/*
+ * Resolves which temperature input feeds which CPU data index. Walking all
+ * chips, features and labels is expensive, thus this is only done once per
+ * libsensors (re)initialization or change of the number of CPUs.
+ */
+static void LibSensors_buildMapping(const CPUData* cpus, unsigned int existingCPUs) {
+   LibSensors_clearMapping();
 
-   unsigned int coreTempCount = 0;
    int topPriority = 99;
 
    int ccdID = 0;
@@ -228,9 +289,8 @@ void LibSensors_getCPUTemperatures(CPUData* cpus, unsigned int existingCPUs, uns
          continue;
 
       if (priority < topPriority) {
-         /* Clear data from lower priority sensor */
-         for (size_t i = 0; i < existingCPUs + 1; i++)
-            data[i] = NAN;
+         /* Drop mappings of lower priority sensors */
+         LibSensors_clearMapping();
       }
 
       topPriority = priority;
@@ -256,6 +316,7 @@ void LibSensors_getCPUTemperatures(CPUData* cpus, unsigned int existingCPUs, uns
          if (!subFeature)
             continue;
 
+         /* Skip sensors not providing a value at all */
          double temp;
          int r = sym_sensors_get_value(chip, subFeature->number, &temp);
          if (r != 0)
@@ -264,8 +325,7 @@ void LibSensors_getCPUTemperatures(CPUData* cpus, unsigned int existingCPUs, uns
          if (existingCPUs == 8) {
             /* Map temperature values to Snapdragon 8cx cores */
             if (String_startsWith(chip->prefix, "cpu") && chip->prefix[3] >= '0' && chip->prefix[3] <= '7' && String_eq(chip->prefix + 4, "_thermal")) {
-               data[1 + chip->prefix[3] - '0'] = temp;
-               coreTempCount++;
+               LibSensors_addTarget(LibSensors_addMapping(chip, subFeature->number, false), 1 + chip->prefix[3] - '0');
                continue;
             }
 
@@ -276,23 +336,15 @@ void LibSensors_getCPUTemperatures(CPUData* cpus, unsigned int existingCPUs, uns
              *   bigcore1   -> cores 7,8
              */
             if (String_eq(chip->prefix, "littlecore_thermal")) {
-               data[1] = temp;
-               data[2] = temp;
-               data[3] = temp;
-               data[4] = temp;
-               coreTempCount += 4;
+               LibSensors_addTargetRange(LibSensors_addMapping(chip, subFeature->number, false), 1, 4);
                continue;
             }
             if (String_eq(chip->prefix, "bigcore0_thermal")) {
-               data[5] = temp;
-               data[6] = temp;
-               coreTempCount += 2;
+               LibSensors_addTargetRange(LibSensors_addMapping(chip, subFeature->number, false), 5, 6);
                continue;
             }
             if (String_eq(chip->prefix, "bigcore1_thermal") || String_eq(chip->prefix, "bigcore2_thermal")) {
-               data[7] = temp;
-               data[8] = temp;
-               coreTempCount += 2;
+               LibSensors_addTargetRange(LibSensors_addMapping(chip, subFeature->number, false), 7, 8);
                continue;
             }
          }
@@ -300,11 +352,7 @@ void LibSensors_getCPUTemperatures(CPUData* cpus, unsigned int existingCPUs, uns
          /* Rockchip RK3566 */
          if (existingCPUs == 4) {
             if (String_eq(chip->prefix, "soc_thermal")) {
-               data[1] = temp;
-               data[2] = temp;
-               data[3] = temp;
-               data[4] = temp;
-               coreTempCount += 4;
+               LibSensors_addTargetRange(LibSensors_addMapping(chip, subFeature->number, false), 1, 4);
                continue;
             }
          }
@@ -319,21 +367,19 @@ void LibSensors_getCPUTemperatures(CPUData* cpus, unsigned int existingCPUs, uns
                physicalID = strtoul(label + strlen("Physical id "), NULL, 10);
             } else if (String_startsWith(label, "Core ")) {
                int coreID = strtoul(label + strlen("Core "), NULL, 10);
-               for (size_t i = 1; i < existingCPUs + 1; i++) {
-                  if (cpus[i].physicalID == physicalID && cpus[i].coreID == coreID) {
-                     data[i] = temp;
-                     coreTempCount++;
-                  }
+               TempMapping* mapping = LibSensors_addMapping(chip, subFeature->number, false);
+               for (unsigned int i = 1; i < existingCPUs + 1; i++) {
+                  if (cpus[i].physicalID == physicalID && cpus[i].coreID == coreID)
+                     LibSensors_addTarget(mapping, i);
                }
             }
 
             /* AMD k10temp/zenpower names, only CCD is known */
             else if (String_startsWith(label, "Tccd")) {
-               for (size_t i = 1; i <= existingCPUs; i++) {
-                  if (cpus[i].ccdID == ccdID) {
-                     data[i] = temp;
-                     coreTempCount++;
-                  }
+               TempMapping* mapping = LibSensors_addMapping(chip, subFeature->number, false);
+               for (unsigned int i = 1; i <= existingCPUs; i++) {
+                  if (cpus[i].ccdID == ccdID)
+                     LibSensors_addTarget(mapping, i);
                }
                ccdID++;
             } else {
@@ -349,14 +395,63 @@ void LibSensors_getCPUTemperatures(CPUData* cpus, unsigned int existingCPUs, uns
          if (tempID > existingCPUs)
             continue;
 
-         /* If already set, e.g. Ryzen reporting platform temperature for each die, use the bigger one */
-         if (isNaN(data[tempID])) {
-            data[tempID] = temp;
-            if (tempID > 0)
-               coreTempCount++;
-         } else {
-            data[tempID] = MAXIMUM(data[tempID], temp);
-         }
+         LibSensors_addTarget(LibSensors_addMapping(chip, subFeature->number, true), tempID);
+      }
+   }
+
+   mappedCPUs = existingCPUs;
+}
+
+bool LibSensors_getCPUTemperatures(CPUData* cpus, unsigned int existingCPUs, unsigned int activeCPUs) {
+   assert(existingCPUs > 0 && existingCPUs < 16384);
+
+   if (existingCPUs != temperatureCount) {
+      temperatures = xReallocArray(temperatures, existingCPUs + 1, sizeof(double));
+      temperatureCount = existingCPUs;
+   }
+
+   double* data = temperatures;
+   for (size_t i = 0; i < existingCPUs + 1; i++)
+      data[i] = NAN;
+
+   bool found = false;
+
+#ifndef BUILD_STATIC
+   if (!dlopenHandle)
+      goto out;
+#endif /* !BUILD_STATIC */
+
+   if (existingCPUs != mappedCPUs)
+      LibSensors_buildMapping(cpus, existingCPUs);
+
+   unsigned int coreTempCount = 0;
+
+   for (size_t i = 0; i < mappingCount; i++) {
+      const TempMapping* mapping = &mappings[i];
+      const unsigned int* targets = &mappingTargets[mapping->firstTarget];
+
+      double temp;
+      int r = sym_sensors_get_value(mapping->chip, mapping->subfeature, &temp);
+      if (r != 0)
+         continue;
+
+      if (!mapping->merge) {
+         for (size_t t = 0; t < mapping->targetCount; t++)
+            data[targets[t]] = temp;
+
+         coreTempCount += mapping->targetCount;
+         continue;
+      }
+
+      const unsigned int tempID = targets[0];
+
+      /* If already set, e.g. Ryzen reporting platform temperature for each die, use the bigger one */
+      if (isNaN(data[tempID])) {
+         data[tempID] = temp;
+         if (tempID > 0)
+            coreTempCount++;
+      } else {
+         data[tempID] = MAXIMUM(data[tempID], temp);
       }
    }
 
@@ -410,10 +505,11 @@ void LibSensors_getCPUTemperatures(CPUData* cpus, unsigned int existingCPUs, uns
    }
 
 out:
-   for (size_t i = 0; i <= existingCPUs; i++)
+   for (size_t i = 0; i <= existingCPUs; i++) {
       cpus[i].temperature = data[i];
-
-   free(data);
+      found |= !isNaN(data[i]);
+   }
+   return found;
 }
 
 #endif /* HAVE_SENSORS_SENSORS_H */
@@ -15,6 +15,7 @@ void LibSensors_cleanup(void);
 int LibSensors_reload(void);
 
 int LibSensors_countCCDs(void);
-void LibSensors_getCPUTemperatures(CPUData* cpus, unsigned int existingCPUs, unsigned int activeCPUs);
+/* Returns false if no CPU temperature could be read */
+bool LibSensors_getCPUTemperatures(CPUData* cpus, unsigned int existingCPUs, unsigned int activeCPUs);
 
 #endif /* HEADER_LibSensors */
@@ -22,26 +22,44 @@ in the source distribution for its full text.
 #include <strings.h>
 #include <unistd.h>
 #include <time.h>
+#include <sys/stat.h>
 
 #include "Compat.h"
 #include "CRT.h"
 #include "Macros.h"
 #include "ProcessTable.h"
+#include "Profile.h"
 #include "Row.h"
 #include "Settings.h"
 #include "UsersTable.h"
 #include "XUtils.h"
 
+#include "linux/CPUFreqSampler.h"
 #include "linux/Platform.h" // needed for GNU/hurd to get PATH_MAX  // IWYU pragma: keep
 
 #ifdef HAVE_SENSORS_SENSORS_H
 #include "LibSensors.h"
 #endif
 
+#include "linux/SPU.h"
+#include "linux/SysfsSensors.h"
+
 #ifndef O_PATH
 #define O_PATH         010000000 // declare for ancient glibc versions
 #endif
 
+#define SYSSPUDIR "/sys/devices/system/spu"
+#define SYSNODEDIR "/sys/devices/system/node"
+
+/* Times of interest in the SPU stat files, in the order they appear */
+enum {
+   SPU_STAT_USER,
+   SPU_STAT_SYSTEM,
+   SPU_STAT_IOWAIT,
+   SPU_STAT_IDLE,
+   SPU_STAT_TIMES
+};
+
 /* Similar to get_nprocs_conf(3) / _SC_NPROCESSORS_CONF
  * https://sourceware.org/git/?p=glibc.git;a=blob;f=sysdeps/unix/sysv/linux/getsysstats.c;hb=HEAD
  */
@@ -115,40 +133,135 @@ static void LinuxMachine_updateCPUcount(LinuxMachine* this) {
    if (existing < 1)
       return;
 
+   /* Sensors of offline CPUs are not monitored, even when they become online. */
+   if (super->existingCPUs != 0 && (active > super->activeCPUs || currExisting > super->existingCPUs)) {
+      SysfsSensors_reload();
 #ifdef HAVE_SENSORS_SENSORS_H
-   /* When started with offline CPUs, libsensors does not monitor those,
-    * even when they become online. */
-   if (super->existingCPUs != 0 && (active > super->activeCPUs || currExisting > super->existingCPUs))
       LibSensors_reload();
 #endif
+   }
 
    super->activeCPUs = active;
    assert(existing == currExisting);
    super->existingCPUs = currExisting;
 }
 
+static void LinuxMachine_closeSPUStatFds(LinuxMachine* this, unsigned int from) {
+   for (unsigned int i = from; i < this->super.existingSPUs; i++) {
+      if (this->spuStatFds[i] >= 0) {
+         close(this->spuStatFds[i]);
+         this->spuStatFds[i] = -1;
+      }
+   }
+}
+
+/* Returns the cpuData index of the first CPU of the given node, 0 if there is none */
+static unsigned int LinuxMachine_findNodeCPU(const LinuxMachine* this, unsigned long int node) {
+   for (unsigned int i = 0; i < this->super.existingCPUs; i++) {
+      char path[64];
+      xSnprintf(path, sizeof(path), SYSNODEDIR "/node%lu/cpu%u", node, i);
+      if (access(path, F_OK) == 0)
+         return i + 1;
+   }
+
+   return 0;
+}
+
+/*
+ * Each Cell Broadband Engine chip is exposed as a NUMA node, which links
+ * its SPUs, e.g. /sys/devices/system/node/node1/spu8.
+ */
+static void LinuxMachine_updateSPUTopology(LinuxMachine* this) {
+   Machine* super = &this->super;
+   unsigned int existing = super->existingSPUs;
+   unsigned int nodes = existing ? 1 : 0;
+
+   if (existing) {
+      this->spuNodeIDs = xReallocArray(this->spuNodeIDs, existing, sizeof(unsigned int));
+      this->spuNodeCPUs = xReallocArray(this->spuNodeCPUs, existing, sizeof(unsigned int));
+   }
+   for (unsigned int i = 0; i < existing; i++) {
+      this->spuNodeIDs[i] = 0;
+      this->spuNodeCPUs[i] = 0;
+   }
+
+   DIR* dir = existing ? opendir(SYSNODEDIR) : NULL;
+   if (dir) {
+      const struct dirent* entry;
+      while ((entry = readdir(dir)) != NULL) {
+         if (!String_startsWith(entry->d_name, "node"))
+            continue;
+
+         char* endp;
+         unsigned long int node = strtoul(entry->d_name + 4, &endp, 10);
+         if (node >= UINT_MAX || endp == entry->d_name + 4 || *endp != '\0')
+            continue;
+
+         unsigned int nodeCPU = UINT_MAX;
+         for (unsigned int i = 0; i < existing; i++) {
+            char path[64];
+            xSnprintf(path, sizeof(path), SYSNODEDIR "/node%lu/spu%u", node, i);
+            if (access(path, F_OK) != 0)
+               continue;
+
+            if (nodeCPU == UINT_MAX)
+               nodeCPU = LinuxMachine_findNodeCPU(this, node);
+
+            this->spuNodeIDs[i] = node;
+            this->spuNodeCPUs[i] = nodeCPU;
+            nodes = MAXIMUM(nodes, node + 1);
+         }
+      }
+
+      closedir(dir);
+   }
+
+   /* Keep the node data of vanished nodes around, they are reported offline */
+   if (nodes > super->existingSPUNodes) {
+      this->spuNodeData = xReallocArrayZero(this->spuNodeData, super->existingSPUNodes, nodes, sizeof(CPUData));
+      super->existingSPUNodes = nodes;
+   }
+}
+
 static void LinuxMachine_updateSPUcount(LinuxMachine* this) {
-   unsigned int existing = 0, active = 0;
    Machine* super = &this->super;
 
-   if (this->spuData)
+   // Initialize the spuData array before anything else.
+   if (!this->spuData) {
+      this->spuData = xCalloc(1, sizeof(CPUData));
+      this->spuData[0].online = true; /* average is always "online" */
+      super->activeSPUs = 0;
+      super->existingSPUs = 0;
+   }
+
+   /* Adding or removing a SPU directory updates the modification time of the
+      parent directory, thus a full readdir() is only needed after hotplug or
+      when a stat file went away. */
+   struct stat sb;
+   if (stat(SYSSPUDIR, &sb) != 0) {
+      LinuxMachine_closeSPUStatFds(this, 0);
+      super->activeSPUs = 0;
+      super->existingSPUs = 0;
       return;
+   }
 
-   // Initialize the spuData array before anything else.
-   this->spuData = xCalloc(2, sizeof(CPUData));
-   this->spuData[0].online = true; /* average is always "online" */
-   super->activeSPUs = 0;
-   super->existingSPUs = 0;
+   if (!this->spuRescan &&
+       sb.st_mtim.tv_sec == this->spuDirMtime.tv_sec &&
+       sb.st_mtim.tv_nsec == this->spuDirMtime.tv_nsec)
+      return;
 
-   DIR* dir = opendir("/sys/devices/system/spu");
+   DIR* dir = opendir(SYSSPUDIR);
    if (!dir)
       return;
 
-   unsigned int currExisting = super->existingSPUs;
+   this->spuDirMtime = sb.st_mtim;
+   this->spuRescan = false;
+
+   unsigned int existing = 0;
 
    const struct dirent* entry;
    while ((entry = readdir(dir)) != NULL) {
-      if (entry->d_type != DT_DIR && entry->d_type != DT_UNKNOWN)
+      if (entry->d_type != DT_DIR && entry->d_type != DT_UNKNOWN && entry->d_type != DT_LNK)
          continue;
 
       if (!String_startsWith(entry->d_name, "spu"))
@@ -156,39 +269,42 @@ static void LinuxMachine_updateSPUcount(LinuxMachine* this) {
 
       char* endp;
       unsigned long int id = strtoul(entry->d_name + 3, &endp, 10);
-      if (id == ULONG_MAX || endp == entry->d_name + 3 || *endp != '\0')
+      if (id >= UINT_MAX || endp == entry->d_name + 3 || *endp != '\0')
          continue;
 
-      existing++;
-
       /* readdir() iterates with no specific order */
-      unsigned int max = MAXIMUM(existing, id + 1);
-      if (max > currExisting) {
-         this->spuData = xReallocArrayZero(this->spuData, currExisting ? (currExisting + 1) : 0, max + /* aggregate */ 1, sizeof(CPUData));
-         this->spuData[0].online = true; /* average is always "online" */
-         currExisting = max;
-      }
-
-      active++;
-      this->spuData[id + 1].online = true;
+      existing = MAXIMUM(existing, id + 1);
    }
 
    closedir(dir);
 
-   // return if no SPU is found
-   if (existing < 1)
-      return;
+   unsigned int currExisting = super->existingSPUs;
+   if (existing < currExisting)
+      LinuxMachine_closeSPUStatFds(this, existing);
+
+   if (existing > currExisting) {
+      this->spuData = xReallocArrayZero(this->spuData, currExisting + /* aggregate */ 1, existing + /* aggregate */ 1, sizeof(CPUData));
+      this->spuStatFds = xReallocArray(this->spuStatFds, existing, sizeof(int));
+      for (unsigned int i = currExisting; i < existing; i++)
+         this->spuStatFds[i] = -1;
+   }
 
-#ifdef HAVE_SENSORS_SENSORS_H
-   /* When started with offline SPUs, libsensors does not monitor those,
-    * even when they become online. */
-   if (super->existingSPUs != 0 && (active > super->activeSPUs || currExisting > super->existingSPUs))
-      LibSensors_reload();
-#endif
+   for (unsigned int i = 0; i < existing; i++) {
+      if (this->spuStatFds[i] >= 0)
+         continue;
 
-   super->activeSPUs = active;
-   assert(existing == currExisting);
-   super->existingSPUs = currExisting;
+      char statname[64];
+      xSnprintf(statname, sizeof(statname), SYSSPUDIR "/spu%u/stat", i);
+      this->spuStatFds[i] = open(statname, O_RDONLY | O_CLOEXEC);
+   }
+
+   /* The thermal attributes of new SPUs are not opened yet */
+   if (currExisting != 0 && existing > currExisting)
+      SysfsSensors_reload();
+
+   super->existingSPUs = existing;
+
+   LinuxMachine_updateSPUTopology(this);
 }
 
 static void LinuxMachine_scanMemoryInfo(LinuxMachine* this) {
@@ -463,23 +579,84 @@ static void LinuxMachine_scanZfsArcstats(LinuxMachine* this) {
    }
 }
 
+static void LinuxMachine_resizeCPUArrays(LinuxMachine* this) {
+   Machine* super = &this->super;
+
+   // Aggregate first, plus an extra phantom CPU for the offline detection
+   size_t size = (size_t)super->existingCPUs + 2;
+   if (size == this->cpuArraySize)
+      return;
+
+   this->cpuSeen = xReallocArray(this->cpuSeen, size, sizeof(bool));
+   this->cpuBusyPeriod = xReallocArray(this->cpuBusyPeriod, size, sizeof(unsigned long long int));
+   this->cpuTotalPeriod = xReallocArray(this->cpuTotalPeriod, size, sizeof(unsigned long long int));
+   super->cpuUsage = xReallocArray(super->cpuUsage, size, sizeof(double));
+   this->cpuArraySize = size;
+}
+
+static unsigned long long int LinuxMachine_parseDecimal(const char** str) {
+   const char* c = *str;
+   unsigned long long int value = 0;
+
+   while (*c >= '0' && *c <= '9') {
+      value = value * 10 + (unsigned long long int)(*c - '0');
+      c++;
+   }
+
+   *str = c;
+   return value;
+}
+
+/*
+ * Parses a "cpu" or "cpuN" line of /proc/stat into the CPU index (0 for the
+ * aggregate, N + 1 otherwise) and up to 10 time fields; missing fields are zero.
+ */
+static bool LinuxMachine_parseCPULine(const char* line, unsigned int* adjCpuId, unsigned long long int fields[static 10]) {
+   const char* c = line + strlen("cpu");
+
+   if (*c >= '0' && *c <= '9') {
+      unsigned long long int cpuid = LinuxMachine_parseDecimal(&c);
+      if (cpuid >= UINT_MAX)
+         return false;
+
+      *adjCpuId = (unsigned int)cpuid + 1;
+   } else {
+      *adjCpuId = 0;
+   }
+
+   if (*c != ' ')
+      return false;
+
+   for (size_t i = 0; i < 10; i++) {
+      while (*c == ' ')
+         c++;
+
+      fields[i] = LinuxMachine_parseDecimal(&c);
+   }
+
+   return true;
+}
+
 static void LinuxMachine_scanCPUTime(LinuxMachine* this) {
-   const Machine* super = &this->super;
+   Machine* super = &this->super;
 
    LinuxMachine_updateCPUcount(this);
+   LinuxMachine_resizeCPUArrays(this);
 
    FILE* file = fopen(PROCSTATFILE, "r");
    if (!file)
       CRT_fatalError("Cannot open " PROCSTATFILE);
 
-   // Add an extra phantom thread for a later loop
-   bool adjCpuIdProcessed[super->existingCPUs+2];
-   memset(adjCpuIdProcessed, 0, sizeof(adjCpuIdProcessed));
+   size_t cpuCount = (size_t)super->existingCPUs + 1;
+   bool* seen = this->cpuSeen;
+   unsigned long long int* busyPeriod = this->cpuBusyPeriod;
+   unsigned long long int* totalPeriod = this->cpuTotalPeriod;
+   memset(seen, 0, this->cpuArraySize * sizeof(bool));
+   memset(busyPeriod, 0, this->cpuArraySize * sizeof(unsigned long long int));
+   memset(totalPeriod, 0, this->cpuArraySize * sizeof(unsigned long long int));
 
-   for (unsigned int i = 0; i <= super->existingCPUs; i++) {
+   for (size_t i = 0; i < cpuCount; i++) {
       char buffer[PROC_LINE_LENGTH + 1];
-      unsigned long long int usertime, nicetime, systemtime, idletime;
-      unsigned long long int ioWait = 0, irq = 0, softIrq = 0, steal = 0, guest = 0, guestnice = 0;
 
       const char* ok = fgets(buffer, sizeof(buffer), file);
       if (!ok)
@@ -493,18 +670,24 @@ static void LinuxMachine_scanCPUTime(LinuxMachine* this) {
       // 5, 7, 8 or 9 of these fields will be set.
       // The rest will remain at zero.
       unsigned int adjCpuId;
-      if (i == 0) {
-         (void) sscanf(buffer, "cpu  %16llu %16llu %16llu %16llu %16llu %16llu %16llu %16llu %16llu %16llu", &usertime, &nicetime, &systemtime, &idletime, &ioWait, &irq, &softIrq, &steal, &guest, &guestnice);
-         adjCpuId = 0;
-      } else {
-         unsigned int cpuid;
-         (void) sscanf(buffer, "cpu%4u %16llu %16llu %16llu %16llu %16llu %16llu %16llu %16llu %16llu %16llu", &cpuid, &usertime, &nicetime, &systemtime, &idletime, &ioWait, &irq, &softIrq, &steal, &guest, &guestnice);
-         adjCpuId = cpuid + 1;
-      }
+      unsigned long long int fields[10];
+      if (!LinuxMachine_parseCPULine(buffer, &adjCpuId, fields))
+         break;
 
       if (adjCpuId > super->existingCPUs)
          break;
 
+      unsigned long long int usertime = fields[0];
+      unsigned long long int nicetime = fields[1];
+      unsigned long long int systemtime = fields[2];
+      unsigned long long int idletime = fields[3];
+      unsigned long long int ioWait = fields[4];
+      unsigned long long int irq = fields[5];
+      unsigned long long int softIrq = fields[6];
+      unsigned long long int steal = fields[7];
+      unsigned long long int guest = fields[8];
+      unsigned long long int guestnice = fields[9];
+
       // Guest time is already accounted in usertime
       usertime -= guest;
       nicetime -= guestnice;
@@ -543,22 +726,30 @@ static void LinuxMachine_scanCPUTime(LinuxMachine* this) {
       cpuData->guestTime = virtalltime;
       cpuData->totalTime = totaltime;
 
-      adjCpuIdProcessed[adjCpuId] = true;
+      busyPeriod[adjCpuId] = saturatingSub(cpuData->totalPeriod, cpuData->idleAllPeriod);
+      totalPeriod[adjCpuId] = cpuData->totalPeriod;
+      seen[adjCpuId] = true;
    }
 
    // Set the extra phantom thread as checked to make sure to mark trailing offline threads correctly in the loop
-   adjCpuIdProcessed[super->existingCPUs+1] = true;
-   unsigned int lastAdjCpuIdProcessed = 0;
-   for (unsigned int i = 0; i <= super->existingCPUs+1; i++) {
-      if (adjCpuIdProcessed[i]) {
-         for (unsigned int j = lastAdjCpuIdProcessed+1; j < i; j++) {
-            // Skipped an ID, but /proc/stat is ordered => threads in between are offline
-            memset(&(this->cpuData[j]), '\0', sizeof(CPUData));
-         }
-         lastAdjCpuIdProcessed = i;
-      }
+   seen[cpuCount] = true;
+   size_t lastSeen = 0;
+   for (size_t i = 1; i <= cpuCount; i++) {
+      if (!seen[i])
+         continue;
+
+      // Skipped an ID, but /proc/stat is ordered => threads in between are offline
+      if (i > lastSeen + 1)
+         memset(&(this->cpuData[lastSeen + 1]), '\0', (i - lastSeen - 1) * sizeof(CPUData));
+
+      lastSeen = i;
    }
 
+   // Kept branch-free over flat arrays, so it vectorizes for large CPU counts
+   double* usage = super->cpuUsage;
+   for (size_t i = 0; i < cpuCount; i++)
+      usage[i] = 100.0 * (double)busyPeriod[i] / (double)MAXIMUM(totalPeriod[i], 1ULL);
+
    this->period = (double)this->cpuData[0].totalPeriod / super->activeCPUs;
 
    if (!ferror(file) && !feof(file)) {
@@ -574,134 +765,198 @@ static void LinuxMachine_scanCPUTime(LinuxMachine* this) {
    fclose(file);
 }
 
+static void LinuxMachine_updateSPUTimes(CPUData* spuData, unsigned long long int usertime, unsigned long long int systemtime, unsigned long long int ioWait, unsigned long long int idletime) {
+   unsigned long long int idlealltime = idletime + ioWait;
+   unsigned long long int systemalltime = systemtime;
+   unsigned long long int totaltime = usertime + systemalltime + idlealltime;
+   // The per-SPU times are sampled at slightly different points in time,
+   // thus a subtraction can lead to an integer overflow.
+   spuData->userPeriod = saturatingSub(usertime, spuData->userTime);
+   spuData->nicePeriod = 0;
+   spuData->systemPeriod = saturatingSub(systemtime, spuData->systemTime);
+   spuData->systemAllPeriod = saturatingSub(systemalltime, spuData->systemAllTime);
+   spuData->idleAllPeriod = saturatingSub(idlealltime, spuData->idleAllTime);
+   spuData->idlePeriod = saturatingSub(idletime, spuData->idleTime);
+   spuData->ioWaitPeriod = saturatingSub(ioWait, spuData->ioWaitTime);
+   spuData->irqPeriod = 0;
+   spuData->softIrqPeriod = 0;
+   spuData->stealPeriod = 0;
+   spuData->guestPeriod = 0;
+   spuData->totalPeriod = saturatingSub(totaltime, spuData->totalTime);
+   spuData->userTime = usertime;
+   spuData->niceTime = 0;
+   spuData->systemTime = systemtime;
+   spuData->systemAllTime = systemalltime;
+   spuData->idleAllTime = idlealltime;
+   spuData->idleTime = idletime;
+   spuData->ioWaitTime = ioWait;
+   spuData->irqTime = 0;
+   spuData->softIrqTime = 0;
+   spuData->stealTime = 0;
+   spuData->guestTime = 0;
+   spuData->totalTime = totaltime;
+}
+
+/*
+ * Parses the content of /sys/devices/system/spu/spu<N>/stat without allocating.
+ *
+ * Layout since Linux 2.6.22 (spu_stat_show()):
+ *   <state> <user> <system> <iowait> <idle> <8 event counters>
+ * with all times in milliseconds. The state name might be absent and the
+ * event counters are not used, thus only the four times are required and
+ * any further fields are ignored.
+ */
+static bool LinuxMachine_parseSPUStat(char* buffer, unsigned long long int times[SPU_STAT_TIMES]) {
+   char* p = buffer;
+
+   while (*p == ' ' || *p == '\t')
+      p++;
+
+   /* optional state name, e.g. "user", "system", "iowait" or "idle" */
+   if (*p < '0' || *p > '9') {
+      while (*p && *p != ' ' && *p != '\t' && *p != '\n')
+         p++;
+   }
+
+   for (size_t i = 0; i < SPU_STAT_TIMES; i++) {
+      while (*p == ' ' || *p == '\t')
+         p++;
+
+      if (*p < '0' || *p > '9')
+         return false;
+
+      char* endp;
+      times[i] = strtoull(p, &endp, 10);
+      p = endp;
+   }
+
+   return true;
+}
+
+static bool LinuxMachine_readSPUStat(LinuxMachine* this, unsigned int id, unsigned long long int times[SPU_STAT_TIMES]) {
+   int fd = this->spuStatFds[id];
+   if (fd < 0)
+      return false;
+
+   char buffer[256];
+   ssize_t r = pread(fd, buffer, sizeof(buffer) - 1, 0);
+   if (r < 0) {
+      /* The SPU went away underneath us, reopen on the next scan */
+      close(fd);
+      this->spuStatFds[id] = -1;
+      this->spuRescan = true;
+      return false;
+   }
+
+   buffer[r] = '\0';
+   return LinuxMachine_parseSPUStat(buffer, times);
+}
+
+static void LinuxMachine_advanceSPUTimes(CPUData* spuData, const unsigned long long int delta[SPU_STAT_TIMES]) {
+   LinuxMachine_updateSPUTimes(spuData,
+                               spuData->userTime + delta[SPU_STAT_USER],
+                               spuData->systemTime + delta[SPU_STAT_SYSTEM],
+                               spuData->ioWaitTime + delta[SPU_STAT_IOWAIT],
+                               spuData->idleTime + delta[SPU_STAT_IDLE]);
+}
+
 static void LinuxMachine_scanSPUTime(LinuxMachine* this) {
-   const Machine* super = &this->super;
+   Machine* super = &this->super;
 
    LinuxMachine_updateSPUcount(this);
 
-   char statname[128];
+   unsigned int active = 0;
+   unsigned long long int delta[SPU_STAT_TIMES] = { 0 };
+
    for (unsigned int i = 0; i < super->existingSPUs; i++) {
-      xSnprintf(statname, sizeof(statname), "/sys/devices/system/spu/spu%d/stat", i);
-      FILE* file = fopen(statname, "r");
-      if (!file)
-      {
-         xSnprintf(statname, sizeof(statname), "Cannot open /sys/devices/system/spu/spu%d/stat", i);
-         CRT_fatalError(statname);
+      CPUData* spuData = &this->spuData[i + 1];
+      unsigned long long int times[SPU_STAT_TIMES];
+
+      /* Missing or unparsable stat files are treated as offline SPUs */
+      if (!LinuxMachine_readSPUStat(this, i, times)) {
+         if (spuData->online)
+            memset(spuData, '\0', sizeof(CPUData));
+         continue;
       }
 
-	   char state[128];
-      unsigned long long int usertime, systemtime, ioWait, idletime;
-      unsigned long long int voluntary_ctx_switches, involuntary_ctx_switches, slb_misses, hash_faults, minor_page_faults, major_page_faults, class2_interrupts, ppe_library;
+      LinuxMachine_updateSPUTimes(spuData, times[SPU_STAT_USER], times[SPU_STAT_SYSTEM], times[SPU_STAT_IOWAIT], times[SPU_STAT_IDLE]);
 
-      // Depending on your kernel version,
-      // 5, 7, 8 or 9 of these fields will be set.
-      // The rest will remain at zero.
-      int ret = fscanf(file, "%s %16llu %16llu %16llu %16llu %16llu %16llu %16llu %16llu %16llu %16llu %16llu %16llu",
-         state, &usertime, &systemtime, &ioWait, &idletime,
-         &voluntary_ctx_switches, &involuntary_ctx_switches, &slb_misses, &hash_faults, &minor_page_faults, &major_page_faults,  &class2_interrupts,  &ppe_library
-      );
-      
-      if (ret != 13)
-         CRT_fatalError("SPU Stat file doesn't match regular pattern.");
+      active++;
 
-      // Fields existing on kernels >= 2.6
-      // (and RHEL's patched kernel 2.4...)
-      unsigned long long int idlealltime = idletime + ioWait;
-      unsigned long long int systemalltime = systemtime;
-      unsigned long long int totaltime = usertime + systemalltime + idlealltime;
-      CPUData* spuData = &(this->spuData[i + 1]);
-      // Since we do a subtraction (usertime - guest) and sputime64_to_clock_t()
-      // used in /proc/stat rounds down numbers, it can lead to a case where the
-      // integer overflow.
-      spuData->userPeriod = saturatingSub(usertime, spuData->userTime);
-      spuData->nicePeriod = 0;
-      spuData->systemPeriod = saturatingSub(systemtime, spuData->systemTime);
-      spuData->systemAllPeriod = saturatingSub(systemalltime, spuData->systemAllTime);
-      spuData->idleAllPeriod = saturatingSub(idlealltime, spuData->idleAllTime);
-      spuData->idlePeriod = saturatingSub(idletime, spuData->idleTime);
-      spuData->ioWaitPeriod = saturatingSub(ioWait, spuData->ioWaitTime);
-      spuData->irqPeriod = 0;
-      spuData->softIrqPeriod = 0;
-      spuData->stealPeriod = 0;
-      spuData->guestPeriod = 0;
-      spuData->totalPeriod = saturatingSub(totaltime, spuData->totalTime);
-      spuData->userTime = usertime;
-      spuData->niceTime = 0;
-      spuData->systemTime = systemtime;
-      spuData->systemAllTime = systemalltime;
-      spuData->idleAllTime = idlealltime;
-      spuData->idleTime = idletime;
-      spuData->ioWaitTime = ioWait;
-      spuData->irqTime = 0;
-      spuData->softIrqTime = 0;
-      spuData->stealTime = 0;
-      spuData->guestTime = 0;
-      spuData->totalTime = totaltime;
-
-      fclose(file);
+      /* Do not report the whole uptime of a SPU coming (back) online as one period */
+      if (!spuData->online) {
+         LinuxMachine_updateSPUTimes(spuData, times[SPU_STAT_USER], times[SPU_STAT_SYSTEM], times[SPU_STAT_IOWAIT], times[SPU_STAT_IDLE]);
+         spuData->online = true;
+         continue;
+      }
+
+      delta[SPU_STAT_USER] += spuData->userPeriod;
+      delta[SPU_STAT_SYSTEM] += spuData->systemPeriod;
+      delta[SPU_STAT_IOWAIT] += spuData->ioWaitPeriod;
+      delta[SPU_STAT_IDLE] += spuData->idlePeriod;
+   }
+
+   super->activeSPUs = active;
+
+   /* Advance the aggregate by the periods of the SPUs instead of differencing
+      sums of their absolute times, which would jump as SPUs come and go */
+   LinuxMachine_advanceSPUTimes(&this->spuData[0], delta);
+
+   for (unsigned int node = 0; node < super->existingSPUNodes; node++) {
+      CPUData* nodeData = &this->spuNodeData[node];
+      unsigned long long int nodeDelta[SPU_STAT_TIMES] = { 0 };
+      bool online = false;
+
+      /* SPUs that just came online have empty periods and add nothing */
+      for (unsigned int i = 0; i < super->existingSPUs; i++) {
+         const CPUData* spuData = &this->spuData[i + 1];
+         if (this->spuNodeIDs[i] != node || !spuData->online)
+            continue;
+
+         nodeDelta[SPU_STAT_USER] += spuData->userPeriod;
+         nodeDelta[SPU_STAT_SYSTEM] += spuData->systemPeriod;
+         nodeDelta[SPU_STAT_IOWAIT] += spuData->ioWaitPeriod;
+         nodeDelta[SPU_STAT_IDLE] += spuData->idlePeriod;
+         online = true;
+      }
+
+      LinuxMachine_advanceSPUTimes(nodeData, nodeDelta);
+      nodeData->online = online;
    }
 }
 
-static int scanCPUFrequencyFromSysCPUFreq(LinuxMachine* this) {
+static bool scanCPUFrequencyFromSysCPUFreq(LinuxMachine* this) {
    const Machine* super = &this->super;
    int numCPUsWithFrequency = 0;
-   unsigned long totalFrequency = 0;
+   double totalFrequency = 0;
 
    /*
     * On some AMD and Intel CPUs read()ing scaling_cur_freq is quite slow (> 1ms). This delay
     * accumulates for every core. For details see issue#471.
-    * If the read on CPU 0 takes longer than 500us bail out and fall back to reading the
-    * frequencies from /proc/cpuinfo.
-    * Once the condition has been met, bail out early for the next couple of scans.
+    * Thus the files are read in the background at their own pace and the latest values are
+    * picked up here.
     */
-   static int timeout = 0;
+   if (!this->cpuFreqSampler)
+      this->cpuFreqSampler = CPUFreqSampler_new();
 
-   if (timeout > 0) {
-      timeout--;
-      return -1;
-   }
+   this->cpuFrequencies = xReallocArray(this->cpuFrequencies, MAXIMUM(super->existingCPUs, 1U), sizeof(double));
+   if (!CPUFreqSampler_get(this->cpuFreqSampler, this->cpuFrequencies, super->existingCPUs))
+      return false;
 
    for (unsigned int i = 0; i < super->existingCPUs; ++i) {
-      if (!Machine_isCPUonline(super, i))
+      double frequency = this->cpuFrequencies[i];
+      if (!Machine_isCPUonline(super, i) || isNaN(frequency))
          continue;
 
-      char pathBuffer[64];
-      xSnprintf(pathBuffer, sizeof(pathBuffer), "/sys/devices/system/cpu/cpu%u/cpufreq/scaling_cur_freq", i);
-
-      struct timespec start;
-      if (i == 0)
-         clock_gettime(CLOCK_MONOTONIC, &start);
-
-      FILE* file = fopen(pathBuffer, "r");
-      if (!file)
-         return -errno;
-
-      unsigned long frequency;
-      if (fscanf(file, "%lu", &frequency) == 1) {
-         /* convert kHz to MHz */
-         frequency = frequency / 1000;
-         this->cpuData[i + 1].frequency = frequency;
-         numCPUsWithFrequency++;
-         totalFrequency += frequency;
-      }
-
-      fclose(file);
-
-      if (i == 0) {
-         struct timespec end;
-         clock_gettime(CLOCK_MONOTONIC, &end);
-         const time_t timeTakenUs = (end.tv_sec - start.tv_sec) * 1000000 + (end.tv_nsec - start.tv_nsec) / 1000;
-         if (timeTakenUs > 500) {
-            timeout = 30;
-            return -1;
-         }
-      }
+      this->cpuData[i + 1].frequency = frequency;
+      numCPUsWithFrequency++;
+      totalFrequency += frequency;
    }
 
    if (numCPUsWithFrequency > 0)
-      this->cpuData[0].frequency = (double)totalFrequency / numCPUsWithFrequency;
+      this->cpuData[0].frequency = totalFrequency / numCPUsWithFrequency;
 
-   return 0;
+   return true;
 }
 
 static void scanCPUFrequencyFromCPUinfo(LinuxMachine* this) {
@@ -716,32 +971,44 @@ static void scanCPUFrequencyFromCPUinfo(LinuxMachine* this) {
    int cpuid = -1;
 
    while (!feof(file)) {
-      double frequency;
       char buffer[PROC_LINE_LENGTH];
 
       if (fgets(buffer, PROC_LINE_LENGTH, file) == NULL)
          break;
 
-      if (sscanf(buffer, "processor : %d", &cpuid) == 1) {
+      if (buffer[0] == '\n') {
+         cpuid = -1;
          continue;
-      } else if (
-         (sscanf(buffer, "cpu MHz : %lf", &frequency) == 1) ||
-         (sscanf(buffer, "clock : %lfMHz", &frequency) == 1)
-      ) {
-         if (cpuid < 0 || (unsigned int)cpuid > (super->existingCPUs - 1)) {
-            continue;
-         }
+      }
 
-         CPUData* cpuData = &(this->cpuData[cpuid + 1]);
-         /* do not override sysfs data */
-         if (!isNonnegative(cpuData->frequency)) {
-            cpuData->frequency = frequency;
-         }
-         numCPUsWithFrequency++;
-         totalFrequency += frequency;
-      } else if (buffer[0] == '\n') {
-         cpuid = -1;
+      /* Most lines are of no interest, only parse those with a matching key */
+      if (String_startsWith(buffer, "processor")) {
+         (void) sscanf(buffer, "processor : %d", &cpuid);
+         continue;
+      }
+
+      if (!String_startsWith(buffer, "cpu MHz") && !String_startsWith(buffer, "clock"))
+         continue;
+
+      const char* value = strchr(buffer, ':');
+      if (!value)
+         continue;
+
+      char* end;
+      double frequency = strtod(value + 1, &end);
+      if (end == value + 1)
+         continue;
+
+      if (cpuid < 0 || (unsigned int)cpuid > (super->existingCPUs - 1))
+         continue;
+
+      CPUData* cpuData = &(this->cpuData[cpuid + 1]);
+      /* do not override sysfs data */
+      if (!isNonnegative(cpuData->frequency)) {
+         cpuData->frequency = frequency;
       }
+      numCPUsWithFrequency++;
+      totalFrequency += frequency;
    }
    fclose(file);
 
@@ -850,34 +1117,85 @@ static void LinuxMachine_scanCPUFrequency(LinuxMachine* this) {
    for (unsigned int i = 0; i <= super->existingCPUs; i++)
       this->cpuData[i].frequency = NAN;
 
-   if (scanCPUFrequencyFromSysCPUFreq(this) == 0)
+   if (scanCPUFrequencyFromSysCPUFreq(this))
       return;
 
    scanCPUFrequencyFromCPUinfo(this);
 }
 
+/* SPUs run at the clock of the PPE on the same chip */
+static void LinuxMachine_scanSPUFrequency(LinuxMachine* this) {
+   const Machine* super = &this->super;
+
+   this->spuData[0].frequency = this->cpuData[0].frequency;
+
+   for (unsigned int i = 0; i < super->existingSPUs; i++) {
+      unsigned int cpu = this->spuNodeCPUs[i] <= super->existingCPUs ? this->spuNodeCPUs[i] : 0;
+      this->spuData[i + 1].frequency = this->cpuData[cpu].frequency;
+      this->spuNodeData[this->spuNodeIDs[i]].frequency = this->cpuData[cpu].frequency;
+   }
+}
+
+static void LinuxMachine_updateSPUNodeTemperatures(LinuxMachine* this) {
+   const Machine* super = &this->super;
+
+   for (unsigned int node = 0; node < super->existingSPUNodes; node++)
+      this->spuNodeData[node].temperature = NAN;
+
+   for (unsigned int i = 0; i < super->existingSPUs; i++) {
+      CPUData* nodeData = &this->spuNodeData[this->spuNodeIDs[i]];
+      double temperature = this->spuData[i + 1].temperature;
+
+      if (isNaN(nodeData->temperature) || isgreater(temperature, nodeData->temperature))
+         nodeData->temperature = temperature;
+   }
+}
+
 void Machine_scan(Machine* super) {
    LinuxMachine* this = (LinuxMachine*) super;
 
+   PROFILE_BEGIN(PROFILE_SCAN_MEMORY);
    LinuxMachine_scanMemoryInfo(this);
    LinuxMachine_scanHugePages(this);
    LinuxMachine_scanZfsArcstats(this);
    LinuxMachine_scanZramInfo(this);
+   PROFILE_END(PROFILE_SCAN_MEMORY);
+
+   PROFILE_BEGIN(PROFILE_SCAN_CPU);
    LinuxMachine_scanCPUTime(this);
    LinuxMachine_scanSPUTime(this);
+   PROFILE_END(PROFILE_SCAN_CPU);
 
    const Settings* settings = super->settings;
    if (settings->showCPUFrequency
 #ifdef HAVE_SENSORS_SENSORS_H
        || settings->showCPUTemperature
 #endif
-   )
+       || settings->showSPUFrequency
+   ) {
+      PROFILE_BEGIN(PROFILE_SCAN_FREQUENCY);
       LinuxMachine_scanCPUFrequency(this);
+      PROFILE_END(PROFILE_SCAN_FREQUENCY);
+   }
 
-   #ifdef HAVE_SENSORS_SENSORS_H
-   if (settings->showCPUTemperature)
-      LibSensors_getCPUTemperatures(this->cpuData, super->existingCPUs, super->activeCPUs);
-   #endif
+   if (settings->showSPUFrequency)
+      LinuxMachine_scanSPUFrequency(this);
+
+   if (settings->showCPUTemperature || settings->showSPUTemperature) {
+      PROFILE_BEGIN(PROFILE_SCAN_TEMPERATURE);
+      CPUData* sysfsCPUs = settings->showCPUTemperature ? this->cpuData : NULL;
+
+      #ifdef HAVE_SENSORS_SENSORS_H
+      /* libsensors knows the chips best, e.g. the per-CCD sensors of AMD CPUs */
+      if (sysfsCPUs && LibSensors_getCPUTemperatures(this->cpuData, super->existingCPUs, super->activeCPUs))
+         sysfsCPUs = NULL;
+      #endif
+
+      SysfsSensors_getTemperatures(sysfsCPUs, super->existingCPUs, this->spuData, super->existingSPUs);
+
+      LinuxMachine_updateSPUNodeTemperatures(this);
+      PROFILE_END(PROFILE_SCAN_TEMPERATURE);
+   }
 }
 
 Machine* Machine_new(UsersTable* usersTable, uid_t userId) {
@@ -930,6 +1248,9 @@ Machine* Machine_new(UsersTable* usersTable, uid_t userId) {
    LinuxMachine_assignCCDs(this, ccds);
    #endif
 
+   // Tables of the dynamic screens, such as cgroups
+   Platform_updateTables(super);
+
    return super;
 }
 
@@ -946,6 +1267,19 @@ void Machine_delete(Machine* super) {
       gpuEngineData = next;
    }
 
+   SPU_freeContexts(this);
+
+   LinuxMachine_closeSPUStatFds(this, 0);
+   free(this->spuStatFds);
+   free(this->spuNodeIDs);
+   free(this->spuNodeCPUs);
+   free(this->spuNodeData);
+   free(this->spuData);
+   CPUFreqSampler_delete(this->cpuFreqSampler);
+   free(this->cpuFrequencies);
+   free(this->cpuTotalPeriod);
+   free(this->cpuBusyPeriod);
+   free(this->cpuSeen);
    free(this->cpuData);
    free(this);
 }
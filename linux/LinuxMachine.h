@@ -8,6 +8,9 @@ in the source distribution for its full text.
 */
 
 #include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include <sys/types.h>
 
 #include "Machine.h"
 #include "linux/ZramStats.h"
@@ -45,10 +48,9 @@ typedef struct CPUData_ {
    unsigned long long int guestPeriod;
 
    double frequency;
-
-   #ifdef HAVE_SENSORS_SENSORS_H
    double temperature;
 
+   #ifdef HAVE_SENSORS_SENSORS_H
    int physicalID;      /* different for each CPU socket */
    int coreID;          /* same for hyperthreading */
    int ccdID;           /* same for each AMD chiplet */
@@ -63,6 +65,15 @@ typedef struct GPUEngineData_ {
    struct GPUEngineData_* next;
 } GPUEngineData;
 
+typedef struct SPUContextData_ {
+   char* name;                                /* context path relative to the spufs mount point */
+   pid_t pid;                                 /* owning process, 0 if not (yet) resolved */
+   unsigned long long int prevTime, curTime;  /* absolute SPU user and system time in milli seconds */
+   uint64_t resolveMs;                        /* time of last owner lookup in milliseconds */
+   bool seen;                                 /* found in the current spufs scan */
+   struct SPUContextData_* next;
+} SPUContextData;
+
 typedef struct LinuxMachine_ {
    Machine super;
 
@@ -77,8 +88,26 @@ typedef struct LinuxMachine_ {
    double period;
 
    CPUData* cpuData;
+   size_t cpuArraySize;                         /* allocated entries of the per-scan CPU arrays below */
+   bool* cpuSeen;                               /* CPU lines found in the current /proc/stat scan */
+   unsigned long long int* cpuBusyPeriod;       /* non-idle time since the last scan, flat for the usage pass */
+   unsigned long long int* cpuTotalPeriod;
+   struct CPUFreqSampler_* cpuFreqSampler;      /* reads scaling_cur_freq in the background */
+   double* cpuFrequencies;                      /* latest values handed over by it */
 
    CPUData* spuData;
+   int* spuStatFds;                             /* persistent fds of the per-SPU stat files, -1 if absent */
+   struct timespec spuDirMtime;                 /* modification time of the SPU sysfs directory at the last scan */
+   bool spuRescan;                              /* enforce a rescan of the SPU sysfs directory */
+   unsigned int* spuNodeIDs;                    /* node (Cell chip) of each SPU */
+   unsigned int* spuNodeCPUs;                   /* CPU of the same node, 0 (average) if unknown */
+   CPUData* spuNodeData;                        /* aggregate of the SPUs of each node */
+
+   char* spufsMount;                            /* NULL if spufs is not mounted */
+   bool spufsChecked;
+   SPUContextData* spuContextData;
+   unsigned int spuUnresolvedContexts;          /* contexts due for an owner lookup */
+   unsigned long long int spuAttributedPeriod;  /* SPU time of contexts with known owner in milli seconds */
 
    #ifdef HAVE_SENSORS_SENSORS_H
    int maxPhysicalID;
@@ -11,6 +11,7 @@ in the source distribution for its full text.
 #include "linux/LinuxProcess.h"
 
 #include <assert.h>
+#include <limits.h>
 #include <math.h>
 #include <stdint.h>
 #include <stdio.h>
@@ -112,25 +113,72 @@ const ProcessFieldData Process_fields[LAST_PROCESSFIELD] = {
 #endif
    [GPU_TIME] = { .name = "GPU_TIME", .title = "GPU_TIME ", .description = "Total GPU time", .flags = PROCESS_FLAG_LINUX_GPU, .defaultSortDesc = true, },
    [GPU_PERCENT] = { .name = "GPU_PERCENT", .title = " GPU% ", .description = "Percentage of the GPU time the process used in the last sampling", .flags = PROCESS_FLAG_LINUX_GPU, .defaultSortDesc = true, },
+   [SPU_TIME] = { .name = "SPU_TIME", .title = "SPU_TIME ", .description = "Total SPU time of the Cell SPE contexts owned by the process", .flags = PROCESS_FLAG_LINUX_SPU, .defaultSortDesc = true, },
+   [PERCENT_SPU] = { .name = "PERCENT_SPU", .title = " SPU% ", .description = "Percentage of the SPU time the process used in the last sampling", .flags = PROCESS_FLAG_LINUX_SPU, .defaultSortDesc = true, },
+   [M_VMSWAP] = { .name = "M_VMSWAP", .title = " VSWP ", .description = "Size of the process's swapped out anonymous memory (VmSwap, cheaper than M_SWAP)", .flags = PROCESS_FLAG_LINUX_STATUS, .defaultSortDesc = true, },
+   [M_HWM] = { .name = "M_HWM", .title = "  HWM ", .description = "Peak resident set size of the process (VmHWM)", .flags = PROCESS_FLAG_LINUX_STATUS, .defaultSortDesc = true, },
+   [CPUS_ALLOWED] = { .name = "CPUS_ALLOWED", .title = "CPUS ", .description = "Number of CPUs the task is allowed to run on (Cpus_allowed)", .flags = PROCESS_FLAG_LINUX_STATUS, },
+   [SECCOMP] = { .name = "SECCOMP", .title = "SECCOMP ", .description = "Seccomp mode of the task: off, strict or filter", .flags = PROCESS_FLAG_LINUX_STATUS, },
+   [NO_NEW_PRIVS] = { .name = "NO_NEW_PRIVS", .title = "NNP ", .description = "Whether the task can no longer gain privileges through execve (NoNewPrivs)", .flags = PROCESS_FLAG_LINUX_STATUS, },
 };
 
+static void LinuxProcessShared_release(LinuxProcessShared* shared) {
+   if (--shared->refs > 0)
+      return;
+
+   free(shared->container_short);
+   free(shared->cgroup_short);
+   free(shared->cgroup);
+   free(shared->secattr);
+   free(shared);
+}
+
+static LinuxProcessShared* LinuxProcessShared_new(void) {
+   LinuxProcessShared* shared = xCalloc(1, sizeof(LinuxProcessShared));
+   shared->refs = 1;
+   return shared;
+}
+
 Process* LinuxProcess_new(const Machine* host) {
    LinuxProcess* this = xCalloc(1, sizeof(LinuxProcess));
    Object_setClass(this, Class(LinuxProcess));
    Process_init(&this->super, host);
+   this->shared = LinuxProcessShared_new();
+   this->seccomp = -1;
    return (Process*)this;
 }
 
+void LinuxProcess_shareWith(LinuxProcess* this, const LinuxProcess* mainTask) {
+   if (this->shared == mainTask->shared)
+      return;
+
+   LinuxProcessShared_release(this->shared);
+   this->shared = mainTask->shared;
+   this->shared->refs++;
+}
+
+void LinuxProcess_ownShared(LinuxProcess* this) {
+   pid_t pid = Process_getPid(&this->super);
+   if (this->shared->owner == pid)
+      return;
+
+   /* the row was a thread of another group, whose data must not be overwritten */
+   if (this->shared->owner != 0) {
+      LinuxProcessShared_release(this->shared);
+      this->shared = LinuxProcessShared_new();
+   }
+   this->shared->owner = pid;
+}
+
 void Process_delete(Object* cast) {
    LinuxProcess* this = (LinuxProcess*) cast;
+   /* The TTY name is interned in LinuxProcessTable's ttyIndex */
+   this->super.tty_name = NULL;
    Process_done((Process*)cast);
-   free(this->container_short);
-   free(this->cgroup_short);
-   free(this->cgroup);
+   LinuxProcessShared_release(this->shared);
 #ifdef HAVE_OPENVZ
    free(this->ctid);
 #endif
-   free(this->secattr);
    free(this);
 }
 
@@ -231,6 +279,31 @@ static double LinuxProcess_totalIORate(const LinuxProcess* lp) {
    return totalRate;
 }
 
+/* Fields summed up by LinuxProcess_rowAccumulate in addition to the common ones */
+static bool LinuxProcess_isGroupField(ProcessField field) {
+   switch (field) {
+   case CTXT:
+   case GPU_PERCENT:
+   case GPU_TIME:
+   case IO_RATE:
+   case IO_READ_RATE:
+   case IO_WRITE_RATE:
+   case M_PRIV:
+   case M_PSS:
+   case M_PSSWP:
+   case M_SHARE:
+   case M_SWAP:
+   case M_VMSWAP:
+   case RBYTES:
+   case STIME:
+   case UTIME:
+   case WBYTES:
+      return true;
+   default:
+      return false;
+   }
+}
+
 static void LinuxProcess_rowWriteField(const Row* super, RichString* str, ProcessField field) {
    const Process* this = (const Process*) super;
    const LinuxProcess* lp = (const LinuxProcess*) super;
@@ -242,11 +315,18 @@ static void LinuxProcess_rowWriteField(const Row* super, RichString* str, Proces
    int attr = CRT_colors[DEFAULT_COLOR];
    size_t n = sizeof(buffer) - 1;
 
+   if (Row_isGroup(super) && !LinuxProcess_isGroupField(field)) {
+      Process_writeField(this, str, field);
+      return;
+   }
+
    switch (field) {
    case CMINFLT: Row_printCount(str, lp->cminflt, coloring); return;
    case CMAJFLT: Row_printCount(str, lp->cmajflt, coloring); return;
    case GPU_PERCENT: Row_printPercentage(lp->gpu_percent, buffer, n, 5, &attr); break;
    case GPU_TIME: Row_printNanoseconds(str, lp->gpu_time, coloring); return;
+   case PERCENT_SPU: Row_printPercentage(lp->spu_percent, buffer, n, 5, &attr); break;
+   case SPU_TIME: Row_printNanoseconds(str, lp->spu_time, coloring); return;
    case M_DRS: Row_printBytes(str, lp->m_drs * lhost->pageSize, coloring); return;
    case M_LRS:
       if (lp->m_lrs) {
@@ -263,6 +343,8 @@ static void LinuxProcess_rowWriteField(const Row* super, RichString* str, Proces
    case M_PSS: Row_printKBytes(str, lp->m_pss, coloring); return;
    case M_SWAP: Row_printKBytes(str, lp->m_swap, coloring); return;
    case M_PSSWP: Row_printKBytes(str, lp->m_psswp, coloring); return;
+   case M_VMSWAP: Row_printKBytes(str, lp->m_vmswap, coloring); return;
+   case M_HWM: Row_printKBytes(str, lp->m_hwm, coloring); return;
    case UTIME: Row_printTime(str, lp->utime, coloring); return;
    case STIME: Row_printTime(str, lp->stime, coloring); return;
    case CUTIME: Row_printTime(str, lp->cutime, coloring); return;
@@ -285,15 +367,15 @@ static void LinuxProcess_rowWriteField(const Row* super, RichString* str, Proces
    case VXID: xSnprintf(buffer, n, "%5u ", lp->vxid); break;
    #endif
    case CGROUP:
-      xSnprintf(buffer, n, "%-*.*s ", Row_fieldWidths[CGROUP], Row_fieldWidths[CGROUP], lp->cgroup ? lp->cgroup : "N/A");
+      xSnprintf(buffer, n, "%-*.*s ", Row_fieldWidths[CGROUP], Row_fieldWidths[CGROUP], lp->shared->cgroup ? lp->shared->cgroup : "N/A");
       RichString_appendWide(str, attr, buffer);
       return;
    case CCGROUP:
-      xSnprintf(buffer, n, "%-*.*s ", Row_fieldWidths[CCGROUP], Row_fieldWidths[CCGROUP], lp->cgroup_short ? lp->cgroup_short : (lp->cgroup ? lp->cgroup : "N/A"));
+      xSnprintf(buffer, n, "%-*.*s ", Row_fieldWidths[CCGROUP], Row_fieldWidths[CCGROUP], lp->shared->cgroup_short ? lp->shared->cgroup_short : (lp->shared->cgroup ? lp->shared->cgroup : "N/A"));
       RichString_appendWide(str, attr, buffer);
       return;
    case CONTAINER:
-      xSnprintf(buffer, n, "%-*.*s ", Row_fieldWidths[CONTAINER], Row_fieldWidths[CONTAINER], lp->container_short ? lp->container_short : "N/A");
+      xSnprintf(buffer, n, "%-*.*s ", Row_fieldWidths[CONTAINER], Row_fieldWidths[CONTAINER], lp->shared->container_short ? lp->shared->container_short : "N/A");
       RichString_appendWide(str, attr, buffer);
       return;
    case OOM: xSnprintf(buffer, n, "%4u ", lp->oom); break;
@@ -327,7 +409,7 @@ static void LinuxProcess_rowWriteField(const Row* super, RichString* str, Proces
       xSnprintf(buffer, n, "%5lu ", lp->ctxt_diff);
       break;
    case SECATTR:
-      snprintf(buffer, n, "%-*.*s ", Row_fieldWidths[SECATTR], Row_fieldWidths[SECATTR], lp->secattr ? lp->secattr : "N/A");
+      snprintf(buffer, n, "%-*.*s ", Row_fieldWidths[SECATTR], Row_fieldWidths[SECATTR], lp->shared->secattr ? lp->shared->secattr : "N/A");
       RichString_appendWide(str, attr, buffer);
       return;
    case AUTOGROUP_ID:
@@ -349,6 +431,45 @@ static void LinuxProcess_rowWriteField(const Row* super, RichString* str, Proces
          xSnprintf(buffer, n, "N/A ");
       }
       break;
+   case CPUS_ALLOWED:
+      if (lp->cpus_allowed) {
+         xSnprintf(buffer, n, "%4u ", lp->cpus_allowed);
+      } else {
+         attr = CRT_colors[PROCESS_SHADOW];
+         xSnprintf(buffer, n, " N/A ");
+      }
+      break;
+   case SECCOMP:
+      switch (lp->seccomp) {
+      case 0:
+         attr = CRT_colors[PROCESS_SHADOW];
+         xSnprintf(buffer, n, "off     ");
+         break;
+      case 1:
+         xSnprintf(buffer, n, "strict  ");
+         break;
+      case 2:
+         xSnprintf(buffer, n, "filter  ");
+         break;
+      default:
+         attr = CRT_colors[PROCESS_SHADOW];
+         xSnprintf(buffer, n, "N/A     ");
+      }
+      break;
+   case NO_NEW_PRIVS:
+      switch (lp->no_new_privs) {
+      case TRI_ON:
+         xSnprintf(buffer, n, "YES ");
+         break;
+      case TRI_OFF:
+         attr = CRT_colors[PROCESS_SHADOW];
+         xSnprintf(buffer, n, "NO  ");
+         break;
+      default:
+         attr = CRT_colors[PROCESS_SHADOW];
+         xSnprintf(buffer, n, "N/A ");
+      }
+      break;
    case ISCONTAINER:
       switch (this->isRunningInContainer) {
       case TRI_ON:
@@ -391,6 +512,16 @@ static int LinuxProcess_compareByKey(const Process* v1, const Process* v2, Proce
       return SPACESHIP_NUMBER(p1->m_swap, p2->m_swap);
    case M_PSSWP:
       return SPACESHIP_NUMBER(p1->m_psswp, p2->m_psswp);
+   case M_VMSWAP:
+      return SPACESHIP_NUMBER(p1->m_vmswap, p2->m_vmswap);
+   case M_HWM:
+      return SPACESHIP_NUMBER(p1->m_hwm, p2->m_hwm);
+   case CPUS_ALLOWED:
+      return SPACESHIP_NUMBER(p1->cpus_allowed, p2->cpus_allowed);
+   case SECCOMP:
+      return SPACESHIP_NUMBER(p1->seccomp, p2->seccomp);
+   case NO_NEW_PRIVS:
+      return SPACESHIP_NUMBER(p1->no_new_privs, p2->no_new_privs);
    case UTIME:
       return SPACESHIP_NUMBER(p1->utime, p2->utime);
    case CUTIME:
@@ -430,11 +561,11 @@ static int LinuxProcess_compareByKey(const Process* v1, const Process* v2, Proce
       return SPACESHIP_NUMBER(p1->vxid, p2->vxid);
    #endif
    case CGROUP:
-      return SPACESHIP_NULLSTR(p1->cgroup, p2->cgroup);
+      return SPACESHIP_NULLSTR(p1->shared->cgroup, p2->shared->cgroup);
    case CCGROUP:
-      return SPACESHIP_NULLSTR(p1->cgroup_short, p2->cgroup_short);
+      return SPACESHIP_NULLSTR(p1->shared->cgroup_short, p2->shared->cgroup_short);
    case CONTAINER:
-      return SPACESHIP_NULLSTR(p1->container_short, p2->container_short);
+      return SPACESHIP_NULLSTR(p1->shared->container_short, p2->shared->container_short);
    case OOM:
       return SPACESHIP_NUMBER(p1->oom, p2->oom);
    #ifdef HAVE_DELAYACCT
@@ -450,7 +581,7 @@ static int LinuxProcess_compareByKey(const Process* v1, const Process* v2, Proce
    case CTXT:
       return SPACESHIP_NUMBER(p1->ctxt_diff, p2->ctxt_diff);
    case SECATTR:
-      return SPACESHIP_NULLSTR(p1->secattr, p2->secattr);
+      return SPACESHIP_NULLSTR(p1->shared->secattr, p2->shared->secattr);
    case AUTOGROUP_ID:
       return SPACESHIP_NUMBER(p1->autogroup_id, p2->autogroup_id);
    case AUTOGROUP_NICE:
@@ -464,6 +595,15 @@ static int LinuxProcess_compareByKey(const Process* v1, const Process* v2, Proce
    }
    case GPU_TIME:
       return SPACESHIP_NUMBER(p1->gpu_time, p2->gpu_time);
+   case PERCENT_SPU: {
+      int r = compareRealNumbers(p1->spu_percent, p2->spu_percent);
+      if (r)
+         return r;
+
+      return SPACESHIP_NUMBER(p1->spu_time, p2->spu_time);
+   }
+   case SPU_TIME:
+      return SPACESHIP_NUMBER(p1->spu_time, p2->spu_time);
    case ISCONTAINER:
       return SPACESHIP_NUMBER(v1->isRunningInContainer, v2->isRunningInContainer);
    default:
@@ -471,6 +611,83 @@ static int LinuxProcess_compareByKey(const Process* v1, const Process* v2, Proce
    }
 }
 
+static bool LinuxProcess_rowGroupKey(const Row* super, RowField field, char* buffer, size_t size) {
+   const LinuxProcess* this = (const LinuxProcess*) super;
+
+   switch (field) {
+   case CGROUP:
+      String_safeStrncpy(buffer, this->shared->cgroup ? this->shared->cgroup : "N/A", size);
+      return true;
+   case CONTAINER:
+      String_safeStrncpy(buffer, this->shared->container_short ? this->shared->container_short : "N/A", size);
+      return true;
+   default:
+      return Process_rowGroupKey(super, field, buffer, size);
+   }
+}
+
+static Row* LinuxProcess_rowNewGroup(const Row* member, const char* key) {
+   return Process_newGroup(member, key, LinuxProcess_new);
+}
+
+static void LinuxProcess_rowResetGroup(Row* super) {
+   LinuxProcess* this = (LinuxProcess*) super;
+
+   Process_rowResetGroup(super);
+   this->m_share = 0;
+   this->m_priv = 0;
+   this->m_pss = 0;
+   this->m_swap = 0;
+   this->m_psswp = 0;
+   this->m_vmswap = 0;
+   this->utime = 0;
+   this->stime = 0;
+   this->io_read_bytes = ULLONG_MAX;
+   this->io_write_bytes = ULLONG_MAX;
+   this->io_rate_read_bps = NAN;
+   this->io_rate_write_bps = NAN;
+   this->ctxt_diff = 0;
+   this->gpu_time = 0;
+   this->gpu_percent = 0.0F;
+}
+
+/* Counters and rates may be unknown for some members, the sum is unknown only without any */
+static void LinuxProcess_addCount(unsigned long long* total, unsigned long long value) {
+   if (value != ULLONG_MAX)
+      *total = (*total == ULLONG_MAX) ? value : *total + value;
+}
+
+static void LinuxProcess_addRate(double* total, double value) {
+   if (isNonnegative(value))
+      *total = isNonnegative(*total) ? *total + value : value;
+}
+
+static void LinuxProcess_rowAccumulate(Row* super, const Row* memberRow) {
+   LinuxProcess* this = (LinuxProcess*) super;
+   const LinuxProcess* member = (const LinuxProcess*) memberRow;
+
+   Process_rowAccumulate(super, memberRow);
+   if (Process_isUserlandThread(&member->super))
+      return;
+
+   this->m_share += member->m_share;
+   this->m_priv += member->m_priv;
+   this->m_pss += member->m_pss;
+   this->m_swap += member->m_swap;
+   this->m_psswp += member->m_psswp;
+   this->m_vmswap += member->m_vmswap;
+   this->utime += member->utime;
+   this->stime += member->stime;
+   LinuxProcess_addCount(&this->io_read_bytes, member->io_read_bytes);
+   LinuxProcess_addCount(&this->io_write_bytes, member->io_write_bytes);
+   LinuxProcess_addRate(&this->io_rate_read_bps, member->io_rate_read_bps);
+   LinuxProcess_addRate(&this->io_rate_write_bps, member->io_rate_write_bps);
+   this->ctxt_diff += member->ctxt_diff;
+   this->gpu_time += member->gpu_time;
+   if (isNonnegative(member->gpu_percent))
+      this->gpu_percent += member->gpu_percent;
+}
+
 const ProcessClass LinuxProcess_class = {
    .super = {
       .super = {
@@ -484,7 +701,11 @@ const ProcessClass LinuxProcess_class = {
       .matchesFilter = Process_rowMatchesFilter,
       .compareByParent = Process_compareByParent,
       .sortKeyString = Process_rowGetSortKey,
-      .writeField = LinuxProcess_rowWriteField
+      .writeField = LinuxProcess_rowWriteField,
+      .groupKey = LinuxProcess_rowGroupKey,
+      .newGroup = LinuxProcess_rowNewGroup,
+      .accumulate = LinuxProcess_rowAccumulate,
+      .resetGroup = LinuxProcess_rowResetGroup
    },
    .compareByKey = LinuxProcess_compareByKey
 };
@@ -9,6 +9,7 @@ in the source distribution for its full text.
 */
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #include "Machine.h"
 #include "Object.h"
@@ -31,6 +32,22 @@ in the source distribution for its full text.
 #define PROCESS_FLAG_LINUX_AUTOGROUP 0x00080000
 #define PROCESS_FLAG_LINUX_GPU       0x00100000
 #define PROCESS_FLAG_LINUX_CONTAINER 0x00200000
+#define PROCESS_FLAG_LINUX_SPU       0x00400000
+#define PROCESS_FLAG_LINUX_STATUS    0x00800000
+
+/*
+ * Process-shared data of a thread group that is kept as strings. It is read
+ * for the main task only, and its threads reference the same block instead
+ * of reading or copying it; the last reference frees it.
+ */
+typedef struct LinuxProcessShared_ {
+   unsigned int refs;
+   pid_t owner;          /* main task the block belongs to, 0 until claimed */
+   char* cgroup;
+   char* cgroup_short;
+   char* container_short;
+   char* secattr;
+} LinuxProcessShared;
 
 typedef struct LinuxProcess_ {
    Process super;
@@ -46,6 +63,7 @@ typedef struct LinuxProcess_ {
    long m_pss;
    long m_swap;
    long m_psswp;
+   uint64_t smapsNextMs;      /* when to read the full smaps file again */
    long m_trs;
    long m_drs;
    long m_lrs;
@@ -90,9 +108,7 @@ typedef struct LinuxProcess_ {
    #ifdef HAVE_VSERVER
    unsigned int vxid;
    #endif
-   char* cgroup;
-   char* cgroup_short;
-   char* container_short;
+   LinuxProcessShared* shared;
    unsigned int oom;
    #ifdef HAVE_DELAYACCT
    unsigned long long int delay_read_time;
@@ -105,7 +121,16 @@ typedef struct LinuxProcess_ {
    #endif
    unsigned long ctxt_total;
    unsigned long ctxt_diff;
-   char* secattr;
+
+   /* From /proc/<pid>/status: swapped out and peak resident memory in kB */
+   long m_vmswap;
+   long m_hwm;
+   /* Number of CPUs the task may run on */
+   unsigned int cpus_allowed;
+   /* Seccomp mode (SECCOMP_MODE_*), -1 if unknown */
+   int seccomp;
+   Tristate no_new_privs;
+
    unsigned long long int last_mlrs_calctime;
 
    /* Total GPU time used in nano seconds */
@@ -115,6 +140,11 @@ typedef struct LinuxProcess_ {
    /* Activity of GPU: 0 if active, otherwise time of last scan in milliseconds */
    uint64_t gpu_activityMs;
 
+   /* Total SPU time of the owned spufs contexts in nano seconds */
+   unsigned long long int spu_time;
+   /* SPU utilization in percent */
+   float spu_percent;
+
    /* Autogroup scheduling (CFS) information */
    long int autogroup_id;
    int autogroup_nice;
@@ -130,6 +160,12 @@ extern const ProcessClass LinuxProcess_class;
 
 Process* LinuxProcess_new(const Machine* host);
 
+/* Makes a thread reference the process-shared data of its main task */
+void LinuxProcess_shareWith(LinuxProcess* this, const LinuxProcess* mainTask);
+
+/* Makes a main task own its process-shared data, e.g. when its PID was a thread before */
+void LinuxProcess_ownShared(LinuxProcess* this);
+
 void Process_delete(Object* cast);
 
 IOPriority LinuxProcess_updateIOPriority(Process* proc);
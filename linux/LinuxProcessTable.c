@@ -25,6 +25,10 @@ in the source distribution for its full text.
 #include <linux/capability.h> // raw syscall, no libcap  // IWYU pragma: keep // IWYU pragma: no_include <sys/capability.h>
 #include <sys/stat.h>
 
+#ifdef HAVE_SYS_INOTIFY_H
+#include <sys/inotify.h>
+#endif
+
 #include "Compat.h"
 #include "GPUMeter.h"
 #include "Hashtable.h"
@@ -32,8 +36,10 @@ in the source distribution for its full text.
 #include "Macros.h"
 #include "Object.h"
 #include "Process.h"
+#include "Profile.h"
 #include "Row.h"
 #include "RowField.h"
+#include "SPUMeter.h"
 #include "Scheduling.h"
 #include "Settings.h"
 #include "Table.h"
@@ -44,6 +50,8 @@ in the source distribution for its full text.
 #include "linux/LinuxMachine.h"
 #include "linux/LinuxProcess.h"
 #include "linux/Platform.h" // needed for GNU/hurd to get PATH_MAX  // IWYU pragma: keep
+#include "linux/SPU.h"
+#include "linux/SmapsReader.h"
 
 #ifdef HAVE_DELAYACCT
 #include "linux/LibNl.h"
@@ -237,6 +245,96 @@ finish:
    this->ttyDrivers = ttyDrivers;
 }
 
+/* Encodes a device number the way the kernel reports tty_nr in /proc/<pid>/stat */
+static inline ht_key_t LinuxProcessTable_ttyKey(unsigned int maj, unsigned int min) {
+   return (ht_key_t)((min & 0xff) | ((maj & 0xfff) << 8) | ((min & ~0xffU) << 12));
+}
+
+static bool LinuxProcessTable_isTtyMajor(const LinuxProcessTable* this, unsigned int maj) {
+   for (const TtyDriver* driver = this->ttyDrivers; driver->path; driver++) {
+      if (driver->major == maj)
+         return true;
+      if (driver->major > maj)
+         break;
+   }
+
+   return false;
+}
+
+static void LinuxProcessTable_indexTtyDir(LinuxProcessTable* this, const char* dirPath) {
+   DIR* dir = opendir(dirPath);
+   if (!dir)
+      return;
+
+   const struct dirent* entry;
+   while ((entry = readdir(dir)) != NULL) {
+      if (entry->d_name[0] == '.')
+         continue;
+      if (entry->d_type != DT_CHR && entry->d_type != DT_UNKNOWN)
+         continue;
+
+      struct stat sb;
+      if (fstatat(dirfd(dir), entry->d_name, &sb, AT_SYMLINK_NOFOLLOW) != 0 || !S_ISCHR(sb.st_mode))
+         continue;
+
+      unsigned int maj = major(sb.st_rdev);
+      if (!LinuxProcessTable_isTtyMajor(this, maj))
+         continue;
+
+      /* Keep the first name seen, processes may already share it */
+      ht_key_t key = LinuxProcessTable_ttyKey(maj, minor(sb.st_rdev));
+      if (Hashtable_get(this->ttyIndex, key))
+         continue;
+
+      char* path;
+      xAsprintf(&path, "%s/%s", dirPath, entry->d_name);
+      Hashtable_put(this->ttyIndex, key, path);
+   }
+
+   closedir(dir);
+}
+
+static void LinuxProcessTable_initTtyIndex(LinuxProcessTable* this) {
+   this->ttyIndex = Hashtable_new(64, true);
+
+#ifdef HAVE_SYS_INOTIFY_H
+   /* Pseudo terminals come and go with sessions, pick them up as they are created */
+   int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+   if (fd >= 0) {
+      if (inotify_add_watch(fd, "/dev/pts", IN_CREATE) >= 0) {
+         this->ttyWatchFd = fd;
+      } else {
+         close(fd);
+      }
+   }
+#endif
+
+   LinuxProcessTable_indexTtyDir(this, "/dev");
+   LinuxProcessTable_indexTtyDir(this, "/dev/pts");
+}
+
+/* Returns whether new pseudo terminals were added to the index */
+static bool LinuxProcessTable_refreshTtyIndex(LinuxProcessTable* this) {
+#ifdef HAVE_SYS_INOTIFY_H
+   if (this->ttyWatchFd < 0)
+      return false;
+
+   bool created = false;
+   char buffer[sizeof(struct inotify_event) + NAME_MAX + 1];
+   /* Any event, including a queue overflow, means the directory has to be walked again */
+   while (read(this->ttyWatchFd, buffer, sizeof(buffer)) > 0)
+      created = true;
+
+   if (created)
+      LinuxProcessTable_indexTtyDir(this, "/dev/pts");
+
+   return created;
+#else
+   (void)this;
+   return false;
+#endif
+}
+
 ProcessTable* ProcessTable_new(Machine* host, Hashtable* pidMatchList) {
    LinuxProcessTable* this = xCalloc(1, sizeof(LinuxProcessTable));
    Object_setClass(this, Class(ProcessTable));
@@ -244,7 +342,10 @@ ProcessTable* ProcessTable_new(Machine* host, Hashtable* pidMatchList) {
    ProcessTable* super = &this->super;
    ProcessTable_init(super, Class(LinuxProcess), host, pidMatchList);
 
+   this->ttyWatchFd = -1;
    LinuxProcessTable_initTtyDrivers(this);
+   if (this->ttyDrivers)
+      LinuxProcessTable_initTtyIndex(this);
 
    // Test /proc/PID/smaps_rollup availability (faster to parse, Linux 4.14+)
    this->haveSmapsRollup = (access(PROCDIR "/self/smaps_rollup", R_OK) == 0);
@@ -272,6 +373,11 @@ void ProcessTable_delete(Object* cast) {
       }
       free(this->ttyDrivers);
    }
+   if (this->ttyIndex)
+      Hashtable_delete(this->ttyIndex);
+   if (this->ttyWatchFd >= 0)
+      close(this->ttyWatchFd);
+   SmapsReader_delete(this->smapsReader);
    #ifdef HAVE_DELAYACCT
    LibNl_destroyNetlinkSocket(this);
    #endif
@@ -522,78 +628,169 @@ static bool LinuxProcessTable_readStatFile(LinuxProcess* lp, openat_arg_t procFd
    return true;
 }
 
+typedef enum LinuxStatusKey_ {
+   STATUS_NONE = 0,
+   STATUS_NSPID,
+   STATUS_VMHWM,
+   STATUS_VMSWAP,
+   STATUS_CPUS_ALLOWED,
+   STATUS_SECCOMP,
+   STATUS_NONEWPRIVS,
+   STATUS_VOLUNTARY_CTXT,
+   STATUS_NONVOLUNTARY_CTXT,
+   STATUS_VXID,
+   STATUS_S_CONTEXT,
+} LinuxStatusKey;
+
+typedef struct LinuxStatusField_ {
+   const char* name;
+   size_t length;
+   LinuxStatusKey key;
+} LinuxStatusField;
+
+#define LINUX_STATUS_HASH_SIZE 32
+
+/* Collision free for the keys below; other keys fail the comparison */
+static inline unsigned int LinuxProcessTable_statusHash(const char* name, size_t length) {
+   return (unsigned int)(length + (unsigned char)name[0] + (unsigned char)name[length - 1]) % LINUX_STATUS_HASH_SIZE;
+}
+
+#define STATUS_FIELD(n_, k_) { .name = (n_), .length = sizeof(n_) - 1, .key = (k_) }
+
+/* Indexed by LinuxProcessTable_statusHash of the name */
+static const LinuxStatusField LinuxProcessTable_statusFields[LINUX_STATUS_HASH_SIZE] = {
+   [ 0] = STATUS_FIELD("voluntary_ctxt_switches", STATUS_VOLUNTARY_CTXT),
+   [ 8] = STATUS_FIELD("VmHWM", STATUS_VMHWM),
+   [10] = STATUS_FIELD("Seccomp", STATUS_SECCOMP),
+   [11] = STATUS_FIELD("NoNewPrivs", STATUS_NONEWPRIVS),
+   [12] = STATUS_FIELD("VmSwap", STATUS_VMSWAP),
+   [16] = STATUS_FIELD("s_context", STATUS_S_CONTEXT),
+   [19] = STATUS_FIELD("Cpus_allowed", STATUS_CPUS_ALLOWED),
+   [23] = STATUS_FIELD("NSpid", STATUS_NSPID),
+   [27] = STATUS_FIELD("nonvoluntary_ctxt_switches", STATUS_NONVOLUNTARY_CTXT),
+   [30] = STATUS_FIELD("VxID", STATUS_VXID),
+};
+
+#undef STATUS_FIELD
+
+static LinuxStatusKey LinuxProcessTable_statusKey(const char* name, size_t length) {
+   if (!length)
+      return STATUS_NONE;
+
+   const LinuxStatusField* field = &LinuxProcessTable_statusFields[LinuxProcessTable_statusHash(name, length)];
+   if (field->length != length || memcmp(field->name, name, length) != 0)
+      return STATUS_NONE;
+
+   return field->key;
+}
+
+/* Counts the set bits of a mask like "ff,ffffffff" */
+static unsigned int LinuxProcessTable_countMaskBits(const char* mask) {
+   static const unsigned char nibbleBits[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+
+   unsigned int count = 0;
+   for (; *mask && *mask != '\n'; mask++) {
+      if (*mask >= '0' && *mask <= '9') {
+         count += nibbleBits[*mask - '0'];
+      } else if (*mask >= 'a' && *mask <= 'f') {
+         count += nibbleBits[*mask - 'a' + 10];
+      }
+   }
+   return count;
+}
+
+/* Whether the task has more than one PID, i.e. is seen from a child PID namespace */
+static bool LinuxProcessTable_hasNestedPid(const char* ptr) {
+   int pid_ns_count = 0;
+   while (*ptr && *ptr != '\n' && !isdigit((unsigned char)*ptr))
+      ++ptr;
+
+   while (*ptr && *ptr != '\n') {
+      if (isdigit((unsigned char)*ptr))
+         pid_ns_count++;
+      while (isdigit((unsigned char)*ptr))
+         ++ptr;
+      while (*ptr && *ptr != '\n' && !isdigit((unsigned char)*ptr))
+         ++ptr;
+   }
+
+   return pid_ns_count > 1;
+}
+
 /*
  * Read /proc/<pid>/status (thread-specific data)
+ *
+ * The file is read at once and each line is dispatched on its key through
+ * LinuxProcessTable_statusFields, so all fields come from a single read.
  */
 static bool LinuxProcessTable_readStatusFile(Process* process, openat_arg_t procFd) {
    LinuxProcess* lp = (LinuxProcess*) process;
 
+   char buffer[8192];
+   ssize_t r = xReadfileat(procFd, "status", buffer, sizeof(buffer));
+   if (r <= 0)
+      return false;
+
    unsigned long ctxt = 0;
    process->isRunningInContainer = TRI_OFF;
 #ifdef HAVE_VSERVER
    lp->vxid = 0;
 #endif
+   lp->m_vmswap = 0;
+   lp->m_hwm = 0;
+   lp->cpus_allowed = 0;
+   lp->seccomp = -1;
+   lp->no_new_privs = TRI_INITIAL;
+
+   for (const char* line = buffer; *line; ) {
+      const char* colon = strchr(line, ':');
+      if (!colon)
+         break;
 
-   FILE* statusfile = fopenat(procFd, "status", "r");
-   if (!statusfile)
-      return false;
-
-   char buffer[PROC_LINE_LENGTH + 1] = {0};
-
-   while (fgets(buffer, sizeof(buffer), statusfile)) {
-
-      if (String_startsWith(buffer, "NSpid:")) {
-         const char* ptr = buffer;
-         int pid_ns_count = 0;
-         while (*ptr && *ptr != '\n' && !isdigit((unsigned char)*ptr))
-            ++ptr;
-
-         while (*ptr && *ptr != '\n') {
-            if (isdigit(*ptr))
-               pid_ns_count++;
-            while (isdigit((unsigned char)*ptr))
-               ++ptr;
-            while (*ptr && *ptr != '\n' && !isdigit((unsigned char)*ptr))
-               ++ptr;
-         }
-
-         if (pid_ns_count > 1)
+      const char* value = colon + 1;
+      switch (LinuxProcessTable_statusKey(line, (size_t)(colon - line))) {
+      case STATUS_NSPID:
+         if (LinuxProcessTable_hasNestedPid(value))
             process->isRunningInContainer = TRI_ON;
-
-      } else if (String_startsWith(buffer, "voluntary_ctxt_switches:")) {
-         unsigned long vctxt;
-         int ok = sscanf(buffer, "voluntary_ctxt_switches:\t%lu", &vctxt);
-         if (ok == 1) {
-            ctxt += vctxt;
-         }
-
-      } else if (String_startsWith(buffer, "nonvoluntary_ctxt_switches:")) {
-         unsigned long nvctxt;
-         int ok = sscanf(buffer, "nonvoluntary_ctxt_switches:\t%lu", &nvctxt);
-         if (ok == 1) {
-            ctxt += nvctxt;
-         }
-
+         break;
+      case STATUS_VMHWM:
+         lp->m_hwm = strtol(value, NULL, 10);
+         break;
+      case STATUS_VMSWAP:
+         lp->m_vmswap = strtol(value, NULL, 10);
+         break;
+      case STATUS_CPUS_ALLOWED:
+         lp->cpus_allowed = LinuxProcessTable_countMaskBits(value);
+         break;
+      case STATUS_SECCOMP:
+         lp->seccomp = (int)strtol(value, NULL, 10);
+         break;
+      case STATUS_NONEWPRIVS:
+         lp->no_new_privs = strtol(value, NULL, 10) ? TRI_ON : TRI_OFF;
+         break;
+      case STATUS_VOLUNTARY_CTXT:
+      case STATUS_NONVOLUNTARY_CTXT:
+         ctxt += strtoul(value, NULL, 10);
+         break;
 #ifdef HAVE_VSERVER
-      } else if (String_startsWith(buffer, "VxID:")) {
-         int vxid;
-         int ok = sscanf(buffer, "VxID:\t%32d", &vxid);
-         if (ok == 1) {
-            lp->vxid = vxid;
-         }
+      case STATUS_VXID:
+         lp->vxid = (unsigned int)strtoul(value, NULL, 10);
+         break;
 #ifdef HAVE_ANCIENT_VSERVER
-      } else if (String_startsWith(buffer, "s_context:")) {
-         int vxid;
-         int ok = sscanf(buffer, "s_context:\t%32d", &vxid);
-         if (ok == 1) {
-            lp->vxid = vxid;
-         }
+      case STATUS_S_CONTEXT:
+         lp->vxid = (unsigned int)strtoul(value, NULL, 10);
+         break;
 #endif /* HAVE_ANCIENT_VSERVER */
 #endif /* HAVE_VSERVER */
+      default:
+         break;
       }
-   }
 
-   fclose(statusfile);
+      line = strchr(value, '\n');
+      if (!line)
+         break;
+      line++;
+   }
 
    lp->ctxt_diff = (ctxt > lp->ctxt_total) ? (ctxt - lp->ctxt_total) : 0;
    lp->ctxt_total = ctxt;
@@ -620,7 +817,7 @@ static bool LinuxProcessTable_updateUser(const Machine* host, Process* process,
    if (statok == -1)
       return false;
 
-   if (process->st_uid != sb.st_uid) {
+   if (process->st_uid != sb.st_uid || !process->user) {
       process->st_uid = sb.st_uid;
       process->user = UsersTable_getRef(host->usersTable, sb.st_uid);
    }
@@ -871,43 +1068,86 @@ static bool LinuxProcessTable_readStatmFile(LinuxProcess* process, openat_arg_t
 }
 
 /*
- * Read /proc/<pid>/smaps (process-shared data)
+ * Read /proc/<pid>/smaps_rollup (process-shared data)
+ *
+ * The file is a header line followed by one "Name:   value kB" line per
+ * field, well below a page, so it is read at once and the values are taken
+ * right after the colon of the three fields of interest.
  */
-static bool LinuxProcessTable_readSmapsFile(LinuxProcess* process, openat_arg_t procFd, bool haveSmapsRollup) {
-   //http://elixir.free-electrons.com/linux/v4.10/source/fs/proc/task_mmu.c#L719
-   //kernel will return data in chunks of size PAGE_SIZE or less.
-   FILE* fp = fopenat(procFd, haveSmapsRollup ? "smaps_rollup" : "smaps", "r");
-   if (!fp)
+static bool LinuxProcessTable_readSmapsRollup(LinuxProcess* process, openat_arg_t procFd) {
+   char buffer[2048];
+   ssize_t r = xReadfileat(procFd, "smaps_rollup", buffer, sizeof(buffer));
+   if (r <= 0)
       return false;
 
-   process->m_pss   = 0;
-   process->m_swap  = 0;
-   process->m_psswp = 0;
+   long pss = 0;
+   long swap = 0;
+   long psswp = 0;
+   unsigned int found = 0;
 
-   char buffer[256];
-   while (fgets(buffer, sizeof(buffer), fp)) {
-      if (!strchr(buffer, '\n')) {
-         // Partial line, skip to end of this line
-         if (!skipEndOfLine(fp)) {
-            fclose(fp);
-            return false;
+   const char* line = strchr(buffer, '\n');
+   while (line && found < 3) {
+      line++;
+      switch (line[0]) {
+      case 'P':
+         if (line[1] == 's' && line[2] == 's' && line[3] == ':') {
+            pss = strtol(line + 4, NULL, 10);
+            found++;
          }
-
-      }
-
-      if (String_startsWith(buffer, "Pss:")) {
-         process->m_pss += strtol(buffer + 4, NULL, 10);
-      } else if (String_startsWith(buffer, "Swap:")) {
-         process->m_swap += strtol(buffer + 5, NULL, 10);
-      } else if (String_startsWith(buffer, "SwapPss:")) {
-         process->m_psswp += strtol(buffer + 8, NULL, 10);
+         break;
+      case 'S':
+         if (String_startsWith(line, "Swap:")) {
+            swap = strtol(line + 5, NULL, 10);
+            found++;
+         } else if (String_startsWith(line, "SwapPss:")) {
+            psswp = strtol(line + 8, NULL, 10);
+            found++;
+         }
+         break;
+      default:
+         break;
       }
+      line = strchr(line, '\n');
    }
 
-   fclose(fp);
+   process->m_pss   = pss;
+   process->m_swap  = swap;
+   process->m_psswp = psswp;
    return true;
 }
 
+/*
+ * Pick up /proc/<pid>/smaps data read in the background, and queue the next
+ * read once the interval derived from the number of mappings has passed
+ */
+static void LinuxProcessTable_updateSmaps(LinuxProcessTable* this, LinuxProcess* process) {
+   const Machine* host = this->super.super.host;
+   pid_t pid = Process_getPid(&process->super);
+   uint64_t starttime = (uint64_t)process->super.starttime_ctime;
+
+   if (!this->smapsReader)
+      this->smapsReader = SmapsReader_new();
+
+   SmapsUsage usage;
+   bool ok;
+   if (SmapsReader_take(this->smapsReader, pid, starttime, &usage, &ok)) {
+      uint64_t interval = SMAPS_READER_MAX_INTERVAL;
+      if (ok) {
+         process->m_pss   = usage.pss;
+         process->m_swap  = usage.swap;
+         process->m_psswp = usage.psswp;
+         interval = SmapsReader_interval(&usage);
+      }
+      process->smapsNextMs = host->monotonicMs + interval;
+   }
+
+   if (host->monotonicMs >= process->smapsNextMs) {
+      SmapsReader_request(this->smapsReader, pid, starttime, host->monotonicMs);
+      /* asks again should the result get lost, e.g. with the PID reused */
+      process->smapsNextMs = host->monotonicMs + SMAPS_READER_MAX_INTERVAL;
+   }
+}
+
 #ifdef HAVE_OPENVZ
 
 static void LinuxProcessTable_readOpenVZData(LinuxProcess* process, openat_arg_t procFd) {
@@ -998,22 +1238,22 @@ static void LinuxProcessTable_readOpenVZData(LinuxProcess* process, openat_arg_t
 #endif /* HAVE_OPENVZ */
 
 /*
- * Read /proc/<pid>/cgroup (thread-specific data)
+ * Read /proc/<pid>/cgroup (process-shared data)
  */
-static void LinuxProcessTable_readCGroupFile(LinuxProcess* process, openat_arg_t procFd) {
+static void LinuxProcessTable_readCGroupFile(LinuxProcessShared* shared, openat_arg_t procFd) {
    FILE* file = fopenat(procFd, "cgroup", "r");
    if (!file) {
-      if (process->cgroup) {
-         free(process->cgroup);
-         process->cgroup = NULL;
+      if (shared->cgroup) {
+         free(shared->cgroup);
+         shared->cgroup = NULL;
       }
-      if (process->cgroup_short) {
-         free(process->cgroup_short);
-         process->cgroup_short = NULL;
+      if (shared->cgroup_short) {
+         free(shared->cgroup_short);
+         shared->cgroup_short = NULL;
       }
-      if (process->container_short) {
-         free(process->container_short);
-         process->container_short = NULL;
+      if (shared->container_short) {
+         free(shared->container_short);
+         shared->container_short = NULL;
       }
       return;
    }
@@ -1048,48 +1288,48 @@ static void LinuxProcessTable_readCGroupFile(LinuxProcess* process, openat_arg_t
    }
    fclose(file);
 
-   bool changed = !process->cgroup || !String_eq(process->cgroup, output);
+   bool changed = !shared->cgroup || !String_eq(shared->cgroup, output);
 
    Row_updateFieldWidth(CGROUP, strlen(output));
-   free_and_xStrdup(&process->cgroup, output);
+   free_and_xStrdup(&shared->cgroup, output);
 
    if (!changed) {
-      if (process->cgroup_short) {
-         Row_updateFieldWidth(CCGROUP, strlen(process->cgroup_short));
+      if (shared->cgroup_short) {
+         Row_updateFieldWidth(CCGROUP, strlen(shared->cgroup_short));
       } else {
          //CCGROUP is alias to normal CGROUP if shortening fails
-         Row_updateFieldWidth(CCGROUP, strlen(process->cgroup));
+         Row_updateFieldWidth(CCGROUP, strlen(shared->cgroup));
       }
-      if (process->container_short) {
-         Row_updateFieldWidth(CONTAINER, strlen(process->container_short));
+      if (shared->container_short) {
+         Row_updateFieldWidth(CONTAINER, strlen(shared->container_short));
       } else {
          Row_updateFieldWidth(CONTAINER, strlen("N/A"));
       }
       return;
    }
 
-   char* cgroup_short = CGroup_filterName(process->cgroup);
+   char* cgroup_short = CGroup_filterName(shared->cgroup);
    if (cgroup_short) {
       Row_updateFieldWidth(CCGROUP, strlen(cgroup_short));
-      free_and_xStrdup(&process->cgroup_short, cgroup_short);
+      free_and_xStrdup(&shared->cgroup_short, cgroup_short);
       free(cgroup_short);
    } else {
       //CCGROUP is alias to normal CGROUP if shortening fails
-      Row_updateFieldWidth(CCGROUP, strlen(process->cgroup));
-      free(process->cgroup_short);
-      process->cgroup_short = NULL;
+      Row_updateFieldWidth(CCGROUP, strlen(shared->cgroup));
+      free(shared->cgroup_short);
+      shared->cgroup_short = NULL;
    }
 
-   char* container_short = CGroup_filterContainer(process->cgroup);
+   char* container_short = CGroup_filterContainer(shared->cgroup);
    if (container_short) {
       Row_updateFieldWidth(CONTAINER, strlen(container_short));
-      free_and_xStrdup(&process->container_short, container_short);
+      free_and_xStrdup(&shared->container_short, container_short);
       free(container_short);
    } else {
       //CONTAINER is just "N/A" if shortening fails
       Row_updateFieldWidth(CONTAINER, strlen("N/A"));
-      free(process->container_short);
-      process->container_short = NULL;
+      free(shared->container_short);
+      shared->container_short = NULL;
    }
 }
 
@@ -1150,24 +1390,13 @@ static void LinuxProcessTable_readAutogroup(LinuxProcess* process, openat_arg_t
 /*
  * Read /proc/<pid>/attr/current (process-shared data)
  */
-static void LinuxProcessTable_readSecattrData(LinuxProcess* process, openat_arg_t procFd, const LinuxProcess* mainTask) {
-   if (mainTask) {
-      const char* mainSecAttr = mainTask->secattr;
-      if (mainSecAttr) {
-         free_and_xStrdup(&process->secattr, mainSecAttr);
-      } else {
-         free(process->secattr);
-         process->secattr = NULL;
-      }
-      return;
-   }
-
+static void LinuxProcessTable_readSecattrData(LinuxProcessShared* shared, openat_arg_t procFd) {
    char buffer[PROC_LINE_LENGTH + 1] = {0};
 
    ssize_t attrdata = xReadfileat(procFd, "attr/current", buffer, sizeof(buffer));
    if (attrdata < 1) {
-      free(process->secattr);
-      process->secattr = NULL;
+      free(shared->secattr);
+      shared->secattr = NULL;
       return;
    }
 
@@ -1178,7 +1407,7 @@ static void LinuxProcessTable_readSecattrData(LinuxProcess* process, openat_arg_
 
    Row_updateFieldWidth(SECATTR, strlen(buffer));
 
-   free_and_xStrdup(&process->secattr, buffer);
+   free_and_xStrdup(&shared->secattr, buffer);
 }
 
 /*
@@ -1188,7 +1417,8 @@ static void LinuxProcessTable_readCwd(LinuxProcess* process, openat_arg_t procFd
    if (mainTask) {
       const char* mainCwd = mainTask->super.procCwd;
       if (mainCwd) {
-         free_and_xStrdup(&process->super.procCwd, mainCwd);
+         if (!process->super.procCwd || !String_eq(process->super.procCwd, mainCwd))
+            free_and_xStrdup(&process->super.procCwd, mainCwd);
       } else {
          free(process->super.procCwd);
          process->super.procCwd = NULL;
@@ -1268,6 +1498,12 @@ static void LinuxProcessList_readExe(Process* process, openat_arg_t procFd, cons
 static bool LinuxProcessTable_readCmdlineFile(Process* process, openat_arg_t procFd, const LinuxProcess* mainTask) {
    LinuxProcessList_readExe(process, procFd, mainTask);
 
+   /* the cmdline of a thread is the one of its main task, read with it */
+   if (mainTask && mainTask->super.cmdline) {
+      Process_updateCmdline(process, mainTask->super.cmdline, mainTask->super.cmdlineBasenameStart, mainTask->super.cmdlineBasenameEnd);
+      return true;
+   }
+
    char command[4096 + 1]; // max cmdline length on Linux
    ssize_t amtRead = xReadfileat(procFd, "cmdline", command, sizeof(command));
    if (amtRead <= 0)
@@ -1452,7 +1688,7 @@ static void LinuxProcessList_readComm(Process* process, openat_arg_t procFd) {
    }
 }
 
-static char* LinuxProcessTable_updateTtyDevice(TtyDriver* ttyDrivers, unsigned long int tty_nr) {
+static char* LinuxProcessTable_resolveTtyDevice(const TtyDriver* ttyDrivers, unsigned long int tty_nr) {
    unsigned int maj = major(tty_nr);
    unsigned int min = minor(tty_nr);
 
@@ -1505,6 +1741,25 @@ static char* LinuxProcessTable_updateTtyDevice(TtyDriver* ttyDrivers, unsigned l
    return out;
 }
 
+static char* LinuxProcessTable_updateTtyDevice(LinuxProcessTable* this, unsigned long int tty_nr) {
+   ht_key_t key = LinuxProcessTable_ttyKey(major(tty_nr), minor(tty_nr));
+
+   char* name = Hashtable_get(this->ttyIndex, key);
+   if (name)
+      return name;
+
+   if (LinuxProcessTable_refreshTtyIndex(this)) {
+      name = Hashtable_get(this->ttyIndex, key);
+      if (name)
+         return name;
+   }
+
+   /* Not a device node found in /dev or /dev/pts, resolve it once via the drivers */
+   name = LinuxProcessTable_resolveTtyDevice(this->ttyDrivers, tty_nr);
+   Hashtable_put(this->ttyIndex, key, name);
+   return name;
+}
+
 static bool isOlderThan(const Process* proc, unsigned int seconds) {
    const Machine* host = proc->super.host;
 
@@ -1522,6 +1777,21 @@ static bool isOlderThan(const Process* proc, unsigned int seconds) {
    return realtime - proc->starttime_ctime > seconds;
 }
 
+/*
+ * Threads are scanned through /proc/<pid>/task with their main task passed
+ * as mainTask. What a reader gathers is either
+ *
+ *  - thread-specific: stat, status, io, comm, capabilities, I/O priority and
+ *    delay accounting are read for every task;
+ *  - process-shared: statm, maps, smaps, the owner, the PID namespace,
+ *    oom_score, autogroup and GPU time are read for the main task only, and
+ *    its threads copy the numbers. cgroup and attr/current are kept in
+ *    LinuxProcessShared, which the threads reference. exe, cwd and cmdline
+ *    belong to the generic Process, the threads copy them only when changed.
+ *
+ * Threads are scanned before their main task, so the numbers they copy are
+ * from the previous scan, while the referenced data is always current.
+ */
 static bool LinuxProcessTable_recurseProcTree(LinuxProcessTable* this, openat_arg_t parentFd, const LinuxMachine* lhost, const char* dirname, const LinuxProcess* mainTask) {
    ProcessTable* pt = (ProcessTable*) this;
    const Machine* host = &lhost->super;
@@ -1550,9 +1820,14 @@ static bool LinuxProcessTable_recurseProcTree(LinuxProcessTable* this, openat_ar
    const bool hideKernelThreads = settings->hideKernelThreads;
    const bool hideUserlandThreads = settings->hideUserlandThreads;
    const bool hideRunningInContainer = settings->hideRunningInContainer;
+   const bool scanSPU = ss->flags & PROCESS_FLAG_LINUX_SPU || SPUMeter_active();
    while ((entry = readdir(dir)) != NULL) {
       const char* name = entry->d_name;
 
+      // Let the UI in, which may switch screens meanwhile
+      Machine_yield(host);
+      ss = settings->ss;
+
       // Ignore all non-directories
       if (entry->d_type != DT_DIR && entry->d_type != DT_UNKNOWN) {
          continue;
@@ -1600,8 +1875,20 @@ static bool LinuxProcessTable_recurseProcTree(LinuxProcessTable* this, openat_ar
       proc->isUserlandThread = Process_getPid(proc) != Process_getThreadGroup(proc);
       assert(proc->isUserlandThread == (mainTask != NULL));
 
+      /* see the classification of the readers above */
+      if (mainTask)
+         LinuxProcess_shareWith(lp, mainTask);
+      else
+         LinuxProcess_ownShared(lp);
+
       LinuxProcessTable_recurseProcTree(this, procFd, lhost, "task", lp);
 
+      /* SPU values are summed up from the owned contexts after the scan */
+      if (scanSPU) {
+         lp->spu_time = 0;
+         lp->spu_percent = 0.0F;
+      }
+
       /*
        * These conditions will not trigger on first occurrence, cause we need to
        * add the process to the ProcessTable and do all one time scans
@@ -1633,7 +1920,10 @@ static bool LinuxProcessTable_recurseProcTree(LinuxProcessTable* this, openat_ar
 
       const bool scanMainThread = !hideUserlandThreads && !Process_isKernelThread(proc) && !mainTask;
 
-      if (!LinuxProcessTable_readStatmFile(lp, procFd, lhost, mainTask))
+      PROFILE_BEGIN(PROFILE_READ_STATM);
+      bool statmOk = LinuxProcessTable_readStatmFile(lp, procFd, lhost, mainTask);
+      PROFILE_END(PROFILE_READ_STATM);
+      if (!statmOk)
          goto errorReadingProcess;
 
       {
@@ -1649,7 +1939,9 @@ static bool LinuxProcessTable_recurseProcTree(LinuxProcessTable* this, openat_ar
 
             if (passedTimeInMs > recheck) {
                lp->last_mlrs_calctime = host->realtimeMs;
+               PROFILE_BEGIN(PROFILE_READ_MAPS);
                LinuxProcessTable_readMaps(lp, procFd, lhost, ss->flags & PROCESS_FLAG_LINUX_LRS_FIX, settings->highlightDeletedExe);
+               PROFILE_END(PROFILE_READ_MAPS);
             }
          } else {
             /* Copy from process structure in threads and reset if setting got disabled */
@@ -1664,7 +1956,10 @@ static bool LinuxProcessTable_recurseProcTree(LinuxProcessTable* this, openat_ar
       char statCommand[MAX_NAME + 1];
       unsigned long long int lasttimes = (lp->utime + lp->stime);
       unsigned long int last_tty_nr = proc->tty_nr;
-      if (!LinuxProcessTable_readStatFile(lp, procFd, lhost, scanMainThread, statCommand, sizeof(statCommand)))
+      PROFILE_BEGIN(PROFILE_READ_STAT);
+      bool statOk = LinuxProcessTable_readStatFile(lp, procFd, lhost, scanMainThread, statCommand, sizeof(statCommand));
+      PROFILE_END(PROFILE_READ_STAT);
+      if (!statOk)
          goto errorReadingProcess;
 
       if (lp->flags & PF_KTHREAD) {
@@ -1672,8 +1967,7 @@ static bool LinuxProcessTable_recurseProcTree(LinuxProcessTable* this, openat_ar
       }
 
       if (last_tty_nr != proc->tty_nr && this->ttyDrivers) {
-         free(proc->tty_name);
-         proc->tty_name = LinuxProcessTable_updateTtyDevice(this->ttyDrivers, proc->tty_nr);
+         proc->tty_name = LinuxProcessTable_updateTtyDevice(this, proc->tty_nr);
       }
 
       proc->percent_cpu = NAN;
@@ -1689,6 +1983,9 @@ static bool LinuxProcessTable_recurseProcTree(LinuxProcessTable* this, openat_ar
          goto errorReadingProcess;
 
       /* Check if the process is inside a different PID namespace. */
+      if (proc->isRunningInContainer == TRI_INITIAL && mainTask) {
+         proc->isRunningInContainer = mainTask->super.isRunningInContainer;
+      }
       if (proc->isRunningInContainer == TRI_INITIAL && rootPidNs != (ino_t)-1) {
          struct stat sb;
 #if defined(HAVE_OPENAT) && defined(HAVE_FSTATAT)
@@ -1703,14 +2000,17 @@ static bool LinuxProcessTable_recurseProcTree(LinuxProcessTable* this, openat_ar
          }
       }
 
-      if (ss->flags & PROCESS_FLAG_LINUX_CTXT
+      if (ss->flags & (PROCESS_FLAG_LINUX_CTXT | PROCESS_FLAG_LINUX_STATUS)
          || ((hideRunningInContainer || ss->flags & PROCESS_FLAG_LINUX_CONTAINER) && proc->isRunningInContainer == TRI_INITIAL)
 #ifdef HAVE_VSERVER
          || ss->flags & PROCESS_FLAG_LINUX_VSERVER
 #endif
       ) {
          proc->isRunningInContainer = TRI_OFF;
-         if (!LinuxProcessTable_readStatusFile(proc, procFd))
+         PROFILE_BEGIN(PROFILE_READ_STATUS);
+         bool statusOk = LinuxProcessTable_readStatusFile(proc, procFd);
+         PROFILE_END(PROFILE_READ_STATUS);
+         if (!statusOk)
             goto errorReadingProcess;
       }
 
@@ -1725,10 +2025,12 @@ static bool LinuxProcessTable_recurseProcTree(LinuxProcessTable* this, openat_ar
          if (proc->isKernelThread) {
             Process_updateCmdline(proc, NULL, 0, 0);
          } else {
+            PROFILE_BEGIN(PROFILE_READ_CMDLINE);
             if (!LinuxProcessTable_readCmdlineFile(proc, procFd, mainTask)) {
                Process_updateCmdline(proc, statCommand, 0, strlen(statCommand));
             }
             LinuxProcessList_readComm(proc, procFd);
+            PROFILE_END(PROFILE_READ_CMDLINE);
          }
 
          Process_fillStarttimeBuffer(proc);
@@ -1739,10 +2041,12 @@ static bool LinuxProcessTable_recurseProcTree(LinuxProcessTable* this, openat_ar
             if (proc->isKernelThread) {
                Process_updateCmdline(proc, NULL, 0, 0);
             } else {
+               PROFILE_BEGIN(PROFILE_READ_CMDLINE);
                if (!LinuxProcessTable_readCmdlineFile(proc, procFd, mainTask)) {
                   Process_updateCmdline(proc, statCommand, 0, strlen(statCommand));
                }
                LinuxProcessList_readComm(proc, procFd);
+               PROFILE_END(PROFILE_READ_CMDLINE);
             }
          }
       }
@@ -1765,19 +2069,21 @@ static bool LinuxProcessTable_recurseProcTree(LinuxProcessTable* this, openat_ar
          }
       }
 
-      if (ss->flags & PROCESS_FLAG_LINUX_CGROUP)
-         LinuxProcessTable_readCGroupFile(lp, procFd);
+      if ((ss->flags & PROCESS_FLAG_LINUX_CGROUP) && !mainTask) {
+         PROFILE_BEGIN(PROFILE_READ_CGROUP);
+         LinuxProcessTable_readCGroupFile(lp->shared, procFd);
+         PROFILE_END(PROFILE_READ_CGROUP);
+      }
 
       if ((ss->flags & PROCESS_FLAG_LINUX_SMAPS) && !Process_isKernelThread(proc)) {
          if (!mainTask) {
-            // Read smaps file of each process only every second pass to improve performance
-            static int smaps_flag = 0;
-            if ((pid & 1) == smaps_flag) {
-               LinuxProcessTable_readSmapsFile(lp, procFd, this->haveSmapsRollup);
-            }
-            if (pid == 1) {
-               smaps_flag = !smaps_flag;
+            PROFILE_BEGIN(PROFILE_READ_SMAPS);
+            if (this->haveSmapsRollup) {
+               LinuxProcessTable_readSmapsRollup(lp, procFd);
+            } else {
+               LinuxProcessTable_updateSmaps(this, lp);
             }
+            PROFILE_END(PROFILE_READ_SMAPS);
          } else {
             lp->m_pss   = mainTask->m_pss;
             lp->m_swap  = mainTask->m_swap;
@@ -1786,12 +2092,16 @@ static bool LinuxProcessTable_recurseProcTree(LinuxProcessTable* this, openat_ar
       }
 
       if (ss->flags & PROCESS_FLAG_IO) {
+         PROFILE_BEGIN(PROFILE_READ_IO);
          LinuxProcessTable_readIoFile(lp, procFd, scanMainThread);
+         PROFILE_END(PROFILE_READ_IO);
       }
 
       #ifdef HAVE_DELAYACCT
       if (ss->flags & PROCESS_FLAG_LINUX_DELAYACCT) {
+         PROFILE_BEGIN(PROFILE_READ_DELAYACCT);
          LibNl_readDelayAcctData(this, lp);
+         PROFILE_END(PROFILE_READ_DELAYACCT);
       }
       #endif
 
@@ -1803,8 +2113,8 @@ static bool LinuxProcessTable_recurseProcTree(LinuxProcessTable* this, openat_ar
          LinuxProcess_updateIOPriority(proc);
       }
 
-      if (ss->flags & PROCESS_FLAG_LINUX_SECATTR) {
-         LinuxProcessTable_readSecattrData(lp, procFd, mainTask);
+      if ((ss->flags & PROCESS_FLAG_LINUX_SECATTR) && !mainTask) {
+         LinuxProcessTable_readSecattrData(lp->shared, procFd);
       }
 
       if (ss->flags & PROCESS_FLAG_CWD) {
@@ -1825,10 +2135,16 @@ static bool LinuxProcessTable_recurseProcTree(LinuxProcessTable* this, openat_ar
          if (mainTask) {
             lp->gpu_time = mainTask->gpu_time;
          } else {
+            PROFILE_BEGIN(PROFILE_READ_GPU);
             GPU_readProcessData(this, lp, procFd);
+            PROFILE_END(PROFILE_READ_GPU);
          }
       }
 
+      if (scanSPU && !mainTask) {
+         SPU_readProcessData(this, lp, procFd);
+      }
+
       /*
        * Final section after all data has been gathered
        */
@@ -1920,5 +2236,15 @@ void ProcessTable_goThroughEntries(ProcessTable* super) {
    openat_arg_t rootFd = "";
 #endif
 
+   const bool scanSPU = settings->ss->flags & PROCESS_FLAG_LINUX_SPU || SPUMeter_active();
+   if (scanSPU)
+      SPU_scanContexts(lhost);
+
    LinuxProcessTable_recurseProcTree(this, rootFd, lhost, PROCDIR, NULL);
+
+   if (this->smapsReader)
+      SmapsReader_expire(this->smapsReader, host->monotonicMs);
+
+   if (scanSPU)
+      SPU_attributeContexts(this);
 }
@@ -9,8 +9,11 @@ in the source distribution for its full text.
 
 #include <stdbool.h>
 
+#include "Hashtable.h"
 #include "ProcessTable.h"
 
+#include "linux/SmapsReader.h"
+
 
 typedef struct TtyDriver_ {
    char* path;
@@ -23,7 +26,10 @@ typedef struct LinuxProcessTable_ {
    ProcessTable super;
 
    TtyDriver* ttyDrivers;
+   Hashtable* ttyIndex;       /* tty_nr -> device path, names are shared by processes */
+   int ttyWatchFd;            /* inotify descriptor watching /dev/pts, or -1 */
    bool haveSmapsRollup;
+   SmapsReader* smapsReader;  /* reads full smaps files without smaps_rollup, created on demand */
    bool haveAutogroup;
 
    #ifdef HAVE_DELAYACCT
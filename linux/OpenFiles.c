@@ -0,0 +1,485 @@
+/*
+htop - linux/OpenFiles.c
+(C) 2024 htop dev team
+Released under the GNU GPLv2+, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "config.h" // IWYU pragma: keep
+
+#include "linux/OpenFiles.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+
+#include "Compat.h"
+#include "Hashtable.h"
+#include "Macros.h"
+#include "Profile.h"
+#include "XUtils.h"
+
+#include "linux/Platform.h" // needed for GNU/hurd to get PATH_MAX  // IWYU pragma: keep
+
+
+typedef struct OpenFiles_Socket_ {
+   unsigned long int inode;
+   const char* type;
+   const char* protocol;
+   char name[];
+} OpenFiles_Socket;
+
+typedef struct OpenFiles_Mapping_ {
+   unsigned int maj;
+   unsigned int min;
+   unsigned long int inode;
+   char path[];
+} OpenFiles_Mapping;
+
+typedef struct OpenFiles_Scan_ {
+   pid_t pid;
+   Hashtable* sockets;   /* socket inode index, built on the first socket seen */
+   Hashtable* mapped;    /* OpenFiles_Mapping of the files already listed, to report each once */
+   OpenFiles_EntryCallback callback;
+   void* context;
+} OpenFiles_Scan;
+
+static const char* const tcpStates[] = {
+   [0x01] = "ESTABLISHED",
+   [0x02] = "SYN_SENT",
+   [0x03] = "SYN_RECV",
+   [0x04] = "FIN_WAIT1",
+   [0x05] = "FIN_WAIT2",
+   [0x06] = "TIME_WAIT",
+   [0x07] = "CLOSE",
+   [0x08] = "CLOSE_WAIT",
+   [0x09] = "LAST_ACK",
+   [0x0A] = "LISTEN",
+   [0x0B] = "CLOSING",
+};
+
+/* Inodes are wider than the keys, so probe on from the truncated one until the
+ * socket or a free slot is found, as Table_findGroup does */
+static const OpenFiles_Socket* OpenFiles_probeSocket(Hashtable* index, unsigned long int inode, ht_key_t* key) {
+   for (*key = (ht_key_t)inode; ; (*key)++) {
+      const OpenFiles_Socket* sock = Hashtable_get(index, *key);
+      if (!sock || sock->inode == inode)
+         return sock;
+   }
+}
+
+static void OpenFiles_addSocket(Hashtable* index, unsigned long int inode, const char* type, const char* protocol, const char* name) {
+   size_t len = strlen(name);
+   OpenFiles_Socket* sock = xMalloc(sizeof(OpenFiles_Socket) + len + 1);
+   sock->inode = inode;
+   sock->type = type;
+   sock->protocol = protocol;
+   memcpy(sock->name, name, len + 1);
+
+   /* replaces, and frees, a socket listed twice */
+   ht_key_t key;
+   OpenFiles_probeSocket(index, inode, &key);
+   Hashtable_put(index, key, sock);
+}
+
+/* Addresses are printed by the kernel as native endian 32 bit words */
+static bool OpenFiles_formatAddress(char* buffer, size_t size, int family, const char* hex, unsigned int port) {
+   char text[INET6_ADDRSTRLEN];
+   bool any = true;
+
+   if (family == AF_INET) {
+      if (strlen(hex) != 8)
+         return false;
+
+      struct in_addr addr;
+      addr.s_addr = (uint32_t)strtoul(hex, NULL, 16);
+      any = addr.s_addr == 0;
+      if (!inet_ntop(AF_INET, &addr, text, sizeof(text)))
+         return false;
+   } else {
+      if (strlen(hex) != 32)
+         return false;
+
+      struct in6_addr addr;
+      for (size_t i = 0; i < 4; i++) {
+         char word[9];
+         memcpy(word, hex + 8 * i, 8);
+         word[8] = '\0';
+         uint32_t value = (uint32_t)strtoul(word, NULL, 16);
+         memcpy(&addr.s6_addr[4 * i], &value, sizeof(value));
+         any = any && value == 0;
+      }
+      if (!inet_ntop(AF_INET6, &addr, text, sizeof(text)))
+         return false;
+   }
+
+   char portText[8] = "*";
+   if (port)
+      xSnprintf(portText, sizeof(portText), "%u", port);
+
+   if (any)
+      xSnprintf(buffer, size, "*:%s", portText);
+   else if (family == AF_INET6)
+      xSnprintf(buffer, size, "[%s]:%s", text, portText);
+   else
+      xSnprintf(buffer, size, "%s:%s", text, portText);
+
+   return true;
+}
+
+static void OpenFiles_indexInetSockets(OpenFiles_Scan* scan, const char* file, int family, const char* protocol, bool tcp) {
+   char path[64];
+   xSnprintf(path, sizeof(path), PROCDIR "/%d/net/%s", scan->pid, file);
+   PROFILE_COUNT_CALLS(1);
+   FILE* fp = fopen(path, "r");
+   if (!fp)
+      return;
+
+   const char* type = (family == AF_INET) ? "IPv4" : "IPv6";
+
+   char line[512];
+   while (fgets(line, sizeof(line), fp)) {
+      char local[33], remote[33];
+      unsigned int localPort, remotePort, state;
+      unsigned long int inode;
+      if (sscanf(line, "%*u: %32[0-9A-Fa-f]:%x %32[0-9A-Fa-f]:%x %x %*x:%*x %*x:%*x %*x %*u %*u %lu",
+                 local, &localPort, remote, &remotePort, &state, &inode) != 6 || inode == 0)
+         continue;
+
+      char localText[64], remoteText[64];
+      if (!OpenFiles_formatAddress(localText, sizeof(localText), family, local, localPort) ||
+          !OpenFiles_formatAddress(remoteText, sizeof(remoteText), family, remote, remotePort))
+         continue;
+
+      char name[192];
+      if (remotePort == 0)
+         xSnprintf(name, sizeof(name), "%s", localText);
+      else
+         xSnprintf(name, sizeof(name), "%s->%s", localText, remoteText);
+
+      if (tcp && state < ARRAYSIZE(tcpStates) && tcpStates[state]) {
+         size_t len = strlen(name);
+         xSnprintf(name + len, sizeof(name) - len, " (%s)", tcpStates[state]);
+      }
+
+      OpenFiles_addSocket(scan->sockets, inode, type, protocol, name);
+   }
+
+   PROFILE_COUNT_CALLS(1);
+   fclose(fp);
+}
+
+static void OpenFiles_indexUnixSockets(OpenFiles_Scan* scan) {
+   char path[64];
+   xSnprintf(path, sizeof(path), PROCDIR "/%d/net/unix", scan->pid);
+   PROFILE_COUNT_CALLS(1);
+   FILE* fp = fopen(path, "r");
+   if (!fp)
+      return;
+
+   char line[PATH_MAX + 128];
+   while (fgets(line, sizeof(line), fp)) {
+      unsigned int type;
+      unsigned long int inode;
+      int pathStart = 0;
+      if (sscanf(line, "%*x: %*x %*x %*x %x %*x %lu %n", &type, &inode, &pathStart) != 2 || inode == 0)
+         continue;
+
+      char* name = line + pathStart;
+      name[strcspn(name, "\n")] = '\0';
+
+      char typeName[32];
+      if (!name[0]) {
+         switch (type) {
+            case 1: xSnprintf(typeName, sizeof(typeName), "type=STREAM"); break;
+            case 2: xSnprintf(typeName, sizeof(typeName), "type=DGRAM"); break;
+            case 5: xSnprintf(typeName, sizeof(typeName), "type=SEQPACKET"); break;
+            default: xSnprintf(typeName, sizeof(typeName), "type=%u", type); break;
+         }
+         name = typeName;
+      }
+
+      OpenFiles_addSocket(scan->sockets, inode, "unix", "", name);
+   }
+
+   PROFILE_COUNT_CALLS(1);
+   fclose(fp);
+}
+
+/* One pass over the socket tables of the process' network namespace */
+static const OpenFiles_Socket* OpenFiles_findSocket(OpenFiles_Scan* scan, unsigned long int inode) {
+   if (!scan->sockets) {
+      scan->sockets = Hashtable_new(64, true);
+      OpenFiles_indexInetSockets(scan, "tcp", AF_INET, "TCP", true);
+      OpenFiles_indexInetSockets(scan, "tcp6", AF_INET6, "TCP", true);
+      OpenFiles_indexInetSockets(scan, "udp", AF_INET, "UDP", false);
+      OpenFiles_indexInetSockets(scan, "udp6", AF_INET6, "UDP", false);
+      OpenFiles_indexUnixSockets(scan);
+   }
+
+   ht_key_t key;
+   return OpenFiles_probeSocket(scan->sockets, inode, &key);
+}
+
+static const char* OpenFiles_fileType(const struct stat* st) {
+   if (S_ISREG(st->st_mode))
+      return "REG";
+   if (S_ISDIR(st->st_mode))
+      return "DIR";
+   if (S_ISCHR(st->st_mode))
+      return "CHR";
+   if (S_ISBLK(st->st_mode))
+      return "BLK";
+   if (S_ISFIFO(st->st_mode))
+      return "FIFO";
+   if (S_ISSOCK(st->st_mode))
+      return "sock";
+   if (S_ISLNK(st->st_mode))
+      return "LINK";
+
+   return "unknown";
+}
+
+static void OpenFiles_readFdinfo(openat_arg_t fdinfoFd, const char* name, OpenFiles_Entry* entry, char* offset, size_t offsetSize) {
+   char buffer[256];
+   ssize_t r = xReadfileat(fdinfoFd, name, buffer, sizeof(buffer));
+   if (r <= 0)
+      return;
+
+   unsigned long long int pos;
+   unsigned int flags;
+   if (sscanf(buffer, "pos: %llu flags: %o", &pos, &flags) != 2)
+      return;
+
+   xSnprintf(offset, offsetSize, "%llu", pos);
+   entry->offset = offset;
+
+   switch (flags & O_ACCMODE) {
+      case O_RDONLY: entry->mode = "r"; break;
+      case O_WRONLY: entry->mode = "w"; break;
+      case O_RDWR:   entry->mode = "u"; break;
+   }
+}
+
+static void OpenFiles_readLink(OpenFiles_Scan* scan, int dirFd, const char* dirPath, const char* linkName, const char* fdName, const openat_arg_t* fdinfoFd) {
+   char target[PATH_MAX];
+   ssize_t r = Compat_readlinkat(dirFd, dirPath, linkName, target, sizeof(target) - 1);
+   if (r < 0) {
+      /* closed in the meantime */
+      if (errno == ENOENT)
+         return;
+
+      xSnprintf(target, sizeof(target), "(readlink: %s)", strerror(errno));
+   } else {
+      target[r] = '\0';
+   }
+
+   OpenFiles_Entry entry = {
+      .fd = fdName,
+      .name = target,
+   };
+
+   char device[32], size[24], offset[24], node[24];
+
+   struct stat st;
+   if (Compat_fstatat(dirFd, dirPath, linkName, &st, 0) == 0) {
+      entry.type = OpenFiles_fileType(&st);
+
+      dev_t dev = (S_ISCHR(st.st_mode) || S_ISBLK(st.st_mode)) ? st.st_rdev : st.st_dev;
+      xSnprintf(device, sizeof(device), "%u,%u", major(dev), minor(dev));
+      entry.device = device;
+
+      if (S_ISREG(st.st_mode)) {
+         xSnprintf(size, sizeof(size), "%"PRIu64, (uint64_t)st.st_size);
+         entry.size = size;
+      }
+
+      xSnprintf(node, sizeof(node), "%"PRIu64, (uint64_t)st.st_ino);
+      entry.node = node;
+
+      if (S_ISSOCK(st.st_mode)) {
+         const OpenFiles_Socket* sock = OpenFiles_findSocket(scan, st.st_ino);
+         if (sock) {
+            entry.type = sock->type;
+            if (sock->protocol[0])
+               entry.node = sock->protocol;
+            entry.name = sock->name;
+         }
+      }
+   }
+
+   if (String_startsWith(target, "anon_inode:"))
+      entry.type = "a_inode";
+
+   if (fdinfoFd)
+      OpenFiles_readFdinfo(*fdinfoFd, linkName, &entry, offset, sizeof(offset));
+
+   scan->callback(&entry, scan->context);
+}
+
+/* Records a mapped file, false if it was listed already; colliding keys are probed past */
+static bool OpenFiles_markMapped(Hashtable* mapped, unsigned int maj, unsigned int min, unsigned long int inode, const char* path) {
+   ht_key_t key = (ht_key_t)(inode ^ ((unsigned long int)maj << 20) ^ min);
+   for (;; key++) {
+      const OpenFiles_Mapping* mapping = Hashtable_get(mapped, key);
+      if (!mapping)
+         break;
+      if (mapping->inode == inode && mapping->maj == maj && mapping->min == min && String_eq(mapping->path, path))
+         return false;
+   }
+
+   size_t len = strlen(path);
+   OpenFiles_Mapping* mapping = xMalloc(sizeof(OpenFiles_Mapping) + len + 1);
+   mapping->maj = maj;
+   mapping->min = min;
+   mapping->inode = inode;
+   memcpy(mapping->path, path, len + 1);
+   Hashtable_put(mapped, key, mapping);
+   return true;
+}
+
+static void OpenFiles_readMaps(OpenFiles_Scan* scan, openat_arg_t procFd) {
+   int fd = Compat_openat(procFd, "maps", O_RDONLY | O_CLOEXEC);
+   if (fd < 0)
+      return;
+
+   FILE* fp = fdopen(fd, "r");
+   if (!fp) {
+      close(fd);
+      return;
+   }
+
+   char line[PATH_MAX + 128];
+   while (fgets(line, sizeof(line), fp)) {
+      unsigned int maj, min;
+      unsigned long int inode;
+      int pathStart = 0;
+      if (sscanf(line, "%*x-%*x %*s %*x %x:%x %lu %n", &maj, &min, &inode, &pathStart) != 3 || inode == 0)
+         continue;
+
+      char* path = line + pathStart;
+      path[strcspn(path, "\n")] = '\0';
+      if (path[0] != '/')
+         continue;
+
+      if (!OpenFiles_markMapped(scan->mapped, maj, min, inode, path))
+         continue;
+
+      char device[32], node[24];
+      xSnprintf(device, sizeof(device), "%u,%u", maj, min);
+      xSnprintf(node, sizeof(node), "%lu", inode);
+
+      OpenFiles_Entry entry = {
+         .fd = "mem",
+         .type = "REG",
+         .device = device,
+         .node = node,
+         .name = path,
+      };
+      scan->callback(&entry, scan->context);
+   }
+
+   PROFILE_COUNT_CALLS(1);
+   fclose(fp);
+}
+
+int OpenFiles_readProcess(pid_t pid, OpenFiles_EntryCallback callback, void* context) {
+   char procPath[32];
+   xSnprintf(procPath, sizeof(procPath), PROCDIR "/%d", pid);
+   char fdPath[40];
+   xSnprintf(fdPath, sizeof(fdPath), "%s/fd", procPath);
+
+#ifdef HAVE_OPENAT
+   openat_arg_t procFd = Compat_openat(AT_FDCWD, procPath, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+   if (procFd < 0)
+      return errno;
+
+   int fdFd = Compat_openat(procFd, "fd", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+   if (fdFd < 0) {
+      int err = errno;
+      Compat_openatArgClose(procFd);
+      return err;
+   }
+
+   DIR* fdDir = fdopendir(fdFd);
+   if (!fdDir) {
+      int err = errno;
+      Compat_openatArgClose(fdFd);
+      Compat_openatArgClose(procFd);
+      return err;
+   }
+
+   openat_arg_t fdinfoFd = Compat_openat(procFd, "fdinfo", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+   const openat_arg_t* fdinfoArg = fdinfoFd >= 0 ? &fdinfoFd : NULL;
+   int procDirFd = procFd;
+#else
+   openat_arg_t procFd = procPath;
+
+   DIR* fdDir = opendir(fdPath);
+   if (!fdDir)
+      return errno;
+
+   char fdinfoPath[40];
+   xSnprintf(fdinfoPath, sizeof(fdinfoPath), "%s/fdinfo", procPath);
+   openat_arg_t fdinfoFd = fdinfoPath;
+   const openat_arg_t* fdinfoArg = &fdinfoFd;
+   int procDirFd = AT_FDCWD; /* the path based fallbacks of readlinkat() and fstatat() use procPath */
+#endif
+
+   OpenFiles_Scan scan = {
+      .pid = pid,
+      .sockets = NULL,
+      .mapped = Hashtable_new(64, true),
+      .callback = callback,
+      .context = context,
+   };
+
+   OpenFiles_readLink(&scan, procDirFd, procPath, "cwd", "cwd", NULL);
+   OpenFiles_readLink(&scan, procDirFd, procPath, "root", "rtd", NULL);
+   OpenFiles_readLink(&scan, procDirFd, procPath, "exe", "txt", NULL);
+
+   /* The executable is listed as txt already */
+   struct stat exeSt;
+   char exePath[PATH_MAX];
+   ssize_t exeLen = Compat_readlinkat(procDirFd, procPath, "exe", exePath, sizeof(exePath) - 1);
+   if (exeLen > 0 && Compat_fstatat(procDirFd, procPath, "exe", &exeSt, 0) == 0) {
+      exePath[exeLen] = '\0';
+      OpenFiles_markMapped(scan.mapped, major(exeSt.st_dev), minor(exeSt.st_dev), exeSt.st_ino, exePath);
+   }
+
+   OpenFiles_readMaps(&scan, procFd);
+
+   const struct dirent* de;
+   while ((de = readdir(fdDir)) != NULL) {
+      if (de->d_name[0] < '0' || de->d_name[0] > '9')
+         continue;
+
+      OpenFiles_readLink(&scan, dirfd(fdDir), fdPath, de->d_name, de->d_name, fdinfoArg);
+   }
+
+   if (scan.sockets)
+      Hashtable_delete(scan.sockets);
+   Hashtable_delete(scan.mapped);
+
+#ifdef HAVE_OPENAT
+   if (fdinfoArg)
+      Compat_openatArgClose(fdinfoFd);
+#endif
+   PROFILE_COUNT_CALLS(1);
+   closedir(fdDir);
+   Compat_openatArgClose(procFd);
+
+   return 0;
+}
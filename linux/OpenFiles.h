@@ -0,0 +1,17 @@
+#ifndef HEADER_OpenFiles
+#define HEADER_OpenFiles
+/*
+htop - linux/OpenFiles.h
+(C) 2024 htop dev team
+Released under the GNU GPLv2+, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include <sys/types.h>
+
+#include "OpenFilesScreen.h"
+
+
+int OpenFiles_readProcess(pid_t pid, OpenFiles_EntryCallback callback, void* context);
+
+#endif /* HEADER_OpenFiles */
@@ -45,7 +45,9 @@ in the source distribution for its full text.
 #include "Object.h"
 #include "Panel.h"
 #include "PressureStallMeter.h"
+#include "ProfileMeter.h"
 #include "ProvideCurses.h"
+#include "SelfMeter.h"
 #include "Settings.h"
 #include "SPUMeter.h"
 #include "SwapMeter.h"
@@ -53,11 +55,15 @@ in the source distribution for its full text.
 #include "TasksMeter.h"
 #include "UptimeMeter.h"
 #include "XUtils.h"
+#include "linux/CGroupScreen.h"
 #include "linux/IOPriority.h"
 #include "linux/IOPriorityPanel.h"
 #include "linux/LinuxMachine.h"
 #include "linux/LinuxProcess.h"
+#include "linux/OpenFiles.h"
 #include "linux/SELinuxMeter.h"
+#include "linux/SysfsSensors.h"
+#include "linux/SyscallSampler.h"
 #include "linux/SystemdMeter.h"
 #include "linux/ZramMeter.h"
 #include "linux/ZramStats.h"
@@ -225,6 +231,10 @@ const MeterClass* const Platform_meterTypes[] = {
    &HugePageMeter_class,
    &TasksMeter_class,
    &UptimeMeter_class,
+   &SelfMeter_class,
+#ifdef BUILD_WITH_PROFILING
+   &ProfileMeter_class,
+#endif
    &BatteryMeter_class,
    &HostnameMeter_class,
    &AllCPUsMeter_class,
@@ -239,6 +249,7 @@ const MeterClass* const Platform_meterTypes[] = {
    &RightCPUs4Meter_class,
    &LeftCPUs8Meter_class,
    &RightCPUs8Meter_class,
+   &CPUHeatmapMeter_class,
    &AllSPUsMeter_class,
    &AllSPUs2Meter_class,
    &AllSPUs4Meter_class,
@@ -251,6 +262,8 @@ const MeterClass* const Platform_meterTypes[] = {
    &RightSPUs4Meter_class,
    &LeftSPUs8Meter_class,
    &RightSPUs8Meter_class,
+   &SPUNodesMeter_class,
+   &TopSPUsMeter_class,
    &BlankMeter_class,
    &PressureStallCPUSomeMeter_class,
    &PressureStallIOSomeMeter_class,
@@ -374,41 +387,41 @@ double Platform_setCPUValues(Meter* this, unsigned int cpu) {
 
    v[CPU_METER_FREQUENCY] = cpuData->frequency;
 
-#ifdef HAVE_SENSORS_SENSORS_H
    v[CPU_METER_TEMPERATURE] = cpuData->temperature;
-#else
-   v[CPU_METER_TEMPERATURE] = NAN;
-#endif
 
    return percent;
 }
 
-double Platform_setSPUValues(Meter* this, unsigned int spu) {
+static double Platform_setSPUDataValues(Meter* this, const CPUData* spuData, bool average) {
    const LinuxMachine* lhost = (const LinuxMachine*) this->host;
    const Settings* settings = this->host->settings;
-   const CPUData* spuData = &(lhost->spuData[spu]);
    double total = (double) ( spuData->totalPeriod == 0 ? 1 : spuData->totalPeriod);
    double percent;
    double* v = this->values;
 
-   v[CPU_METER_NICE] = spuData->nicePeriod / total * 100.0;
-   v[CPU_METER_NORMAL] = spuData->userPeriod / total * 100.0;
+   if (!spuData->online) {
+      this->curItems = 0;
+      return NAN;
+   }
+
+   v[SPU_METER_NICE] = spuData->nicePeriod / total * 100.0;
+   v[SPU_METER_NORMAL] = spuData->userPeriod / total * 100.0;
    if (settings->detailedSPUTime) {
-      v[CPU_METER_KERNEL]  = spuData->systemPeriod / total * 100.0;
-      v[CPU_METER_IRQ]     = spuData->irqPeriod / total * 100.0;
-      v[CPU_METER_SOFTIRQ] = spuData->softIrqPeriod / total * 100.0;
+      v[SPU_METER_KERNEL]  = spuData->systemPeriod / total * 100.0;
+      v[SPU_METER_IRQ]     = spuData->irqPeriod / total * 100.0;
+      v[SPU_METER_SOFTIRQ] = spuData->softIrqPeriod / total * 100.0;
       this->curItems = 5;
 
-      v[CPU_METER_STEAL]   = spuData->stealPeriod / total * 100.0;
-      v[CPU_METER_GUEST]   = spuData->guestPeriod / total * 100.0;
+      v[SPU_METER_STEAL]   = spuData->stealPeriod / total * 100.0;
+      v[SPU_METER_GUEST]   = spuData->guestPeriod / total * 100.0;
       if (settings->accountGuestInSPUMeter) {
          this->curItems = 7;
       }
 
-      v[CPU_METER_IOWAIT]  = spuData->ioWaitPeriod / total * 100.0;
+      v[SPU_METER_IOWAIT]  = spuData->ioWaitPeriod / total * 100.0;
    } else {
-      v[CPU_METER_KERNEL] = spuData->systemAllPeriod / total * 100.0;
-      v[CPU_METER_IRQ] = (spuData->stealPeriod + spuData->guestPeriod) / total * 100.0;
+      v[SPU_METER_KERNEL] = spuData->systemAllPeriod / total * 100.0;
+      v[SPU_METER_IRQ] = (spuData->stealPeriod + spuData->guestPeriod) / total * 100.0;
       this->curItems = 4;
    }
 
@@ -419,17 +432,45 @@ double Platform_setSPUValues(Meter* this, unsigned int spu) {
       this->curItems = 8;
    }
 
-   v[CPU_METER_FREQUENCY] = spuData->frequency;
+   /* Busy time of the average meter not accounted to any process owning a spufs context,
+      taken from the user and system parts so the total stays unchanged */
+   v[SPU_METER_RESIDUE] = NAN;
+   if (average && lhost->spufsMount && SPUMeter_active()) {
+      double residue = saturatingSub(spuData->userPeriod + spuData->systemPeriod, lhost->spuAttributedPeriod) / total * 100.0;
+      double fromUser = MINIMUM(residue, v[SPU_METER_NORMAL]);
+      v[SPU_METER_NORMAL] -= fromUser;
+      v[SPU_METER_KERNEL] -= MINIMUM(residue - fromUser, v[SPU_METER_KERNEL]);
+      v[SPU_METER_RESIDUE] = residue;
+
+      for (unsigned int i = this->curItems; i < SPU_METER_RESIDUE; i++)
+         v[i] = 0.0;
+      this->curItems = SPU_METER_RESIDUE + 1;
+   }
 
-#ifdef HAVE_SENSORS_SENSORS_H
-   v[CPU_METER_TEMPERATURE] = spuData->temperature;
-#else
-   v[CPU_METER_TEMPERATURE] = NAN;
-#endif
+   v[SPU_METER_FREQUENCY] = spuData->frequency;
+
+   v[SPU_METER_TEMPERATURE] = spuData->temperature;
 
    return percent;
 }
 
+double Platform_setSPUValues(Meter* this, unsigned int spu) {
+   const LinuxMachine* lhost = (const LinuxMachine*) this->host;
+
+   return Platform_setSPUDataValues(this, &lhost->spuData[spu], spu == 0);
+}
+
+double Platform_setSPUNodeValues(Meter* this, unsigned int node) {
+   const LinuxMachine* lhost = (const LinuxMachine*) this->host;
+
+   if (node >= this->host->existingSPUNodes) {
+      this->curItems = 0;
+      return NAN;
+   }
+
+   return Platform_setSPUDataValues(this, &lhost->spuNodeData[node], false);
+}
+
 void Platform_setGPUValues(Meter* this, double* totalUsage, unsigned long long* totalGPUTimeDiff) {
    const Machine* host = this->host;
    const LinuxMachine* lhost = (const LinuxMachine*) host;
@@ -677,6 +718,27 @@ err:
    return pdata;
 }
 
+int Platform_getOpenFiles(pid_t pid, OpenFiles_EntryCallback callback, void* context) {
+   return OpenFiles_readProcess(pid, callback, context);
+}
+
+int Platform_newSyscallSampler(pid_t pid, SyscallSampler** sampler) {
+   *sampler = SyscallSampler_new(pid);
+   return *sampler ? 0 : errno;
+}
+
+void Platform_deleteSyscallSampler(SyscallSampler* sampler) {
+   SyscallSampler_delete(sampler);
+}
+
+int Platform_sampleSyscalls(SyscallSampler* sampler) {
+   return SyscallSampler_sample(sampler);
+}
+
+SyscallSampler_Entry** Platform_getSyscallSamples(SyscallSampler* sampler, size_t* count) {
+   return SyscallSampler_collect(sampler, count);
+}
+
 void Platform_getPressureStall(const char* file, bool some, double* ten, double* sixty, double* threehundred) {
    *ten = *sixty = *threehundred = 0;
    char procname[128];
@@ -1163,6 +1225,42 @@ static int dropCapabilities(enum CapMode mode) {
 }
 #endif
 
+Hashtable* Platform_dynamicColumns(void) {
+   return CGroupScreen_columns();
+}
+
+void Platform_dynamicColumnsDone(Hashtable* columns) {
+   CGroupScreen_columnsDone(columns);
+}
+
+const char* Platform_dynamicColumnName(unsigned int key) {
+   return CGroupScreen_columnName(key);
+}
+
+Hashtable* Platform_dynamicScreens(void) {
+   return CGroupScreen_screens();
+}
+
+void Platform_defaultDynamicScreens(Settings* settings) {
+   CGroupScreen_appendScreens(settings);
+}
+
+void Platform_addDynamicScreen(ScreenSettings* ss) {
+   CGroupScreen_addDynamicScreen(ss);
+}
+
+void Platform_addDynamicScreenAvailableColumns(Panel* availableColumns, const char* screen) {
+   CGroupScreen_addAvailableColumns(availableColumns, screen);
+}
+
+void Platform_dynamicScreensDone(Hashtable* screens) {
+   CGroupScreen_screensDone(screens);
+}
+
+void Platform_updateTables(Machine* host) {
+   CGroupScreen_appendTables(host);
+}
+
 bool Platform_init(void) {
 #ifdef HAVE_LIBCAP
    if (dropCapabilities(Platform_capabilitiesMode) < 0)
@@ -1206,6 +1304,8 @@ bool Platform_init(void) {
 }
 
 void Platform_done(void) {
+   SysfsSensors_cleanup();
+
 #ifdef HAVE_SENSORS_SENSORS_H
    LibSensors_cleanup();
 #endif
@@ -21,6 +21,7 @@ in the source distribution for its full text.
 #include "Macros.h"
 #include "Meter.h"
 #include "NetworkIOMeter.h"
+#include "OpenFilesScreen.h"
 #include "Panel.h"
 #include "Process.h"
 #include "ProcessLocksScreen.h"
@@ -28,6 +29,7 @@ in the source distribution for its full text.
 #include "Settings.h"
 #include "SignalsPanel.h"
 #include "CommandLine.h"
+#include "TraceScreen.h"
 #include "generic/gettime.h"
 #include "generic/hostname.h"
 #include "generic/uname.h"
@@ -66,6 +68,8 @@ double Platform_setCPUValues(Meter* this, unsigned int cpu);
 
 double Platform_setSPUValues(Meter* this, unsigned int spu);
 
+double Platform_setSPUNodeValues(Meter* this, unsigned int node);
+
 void Platform_setGPUValues(Meter* this, double* totalUsage, unsigned long long* totalGPUTimeDiff);
 
 void Platform_setMemoryValues(Meter* this);
@@ -82,6 +86,21 @@ char* Platform_getProcessEnv(pid_t pid);
 
 FileLocks_ProcessData* Platform_getProcessLocks(pid_t pid);
 
+/* Returns 0 on success, -1 without native support (lsof is used then) or an errno value */
+int Platform_getOpenFiles(pid_t pid, OpenFiles_EntryCallback callback, void* context);
+
+/* Starts sampling the system calls the threads of a process are in, without stopping them.
+   Returns 0 on success, -1 without support on this platform or an errno value */
+int Platform_newSyscallSampler(pid_t pid, SyscallSampler** sampler);
+
+void Platform_deleteSyscallSampler(SyscallSampler* sampler);
+
+/* Takes one sample of every thread; returns 0 or an errno value */
+int Platform_sampleSyscalls(SyscallSampler* sampler);
+
+/* Returns a newly allocated, unsorted array of the entries, to be released with free() */
+SyscallSampler_Entry** Platform_getSyscallSamples(SyscallSampler* sampler, size_t* count);
+
 void Platform_getPressureStall(const char* file, bool some, double* ten, double* sixty, double* threehundred);
 
 void Platform_getFileDescriptors(double* used, double* max);
@@ -131,30 +150,26 @@ static inline void Platform_dynamicMeterUpdateValues(ATTR_UNUSED Meter* meter) {
 
 static inline void Platform_dynamicMeterDisplay(ATTR_UNUSED const Meter* meter, ATTR_UNUSED RichString* out) { }
 
-static inline Hashtable* Platform_dynamicColumns(void) {
-   return NULL;
-}
+Hashtable* Platform_dynamicColumns(void);
 
-static inline void Platform_dynamicColumnsDone(ATTR_UNUSED Hashtable* table) { }
+void Platform_dynamicColumnsDone(Hashtable* columns);
 
-static inline const char* Platform_dynamicColumnName(ATTR_UNUSED unsigned int key) {
-   return NULL;
-}
+const char* Platform_dynamicColumnName(unsigned int key);
 
 static inline bool Platform_dynamicColumnWriteField(ATTR_UNUSED const Process* proc, ATTR_UNUSED RichString* str, ATTR_UNUSED unsigned int key) {
    return false;
 }
 
-static inline Hashtable* Platform_dynamicScreens(void) {
-   return NULL;
-}
+Hashtable* Platform_dynamicScreens(void);
+
+void Platform_defaultDynamicScreens(Settings* settings);
 
-static inline void Platform_defaultDynamicScreens(ATTR_UNUSED Settings* settings) { }
+void Platform_addDynamicScreen(ScreenSettings* ss);
 
-static inline void Platform_addDynamicScreen(ATTR_UNUSED ScreenSettings* ss) { }
+void Platform_addDynamicScreenAvailableColumns(Panel* availableColumns, const char* screen);
 
-static inline void Platform_addDynamicScreenAvailableColumns(ATTR_UNUSED Panel* availableColumns, ATTR_UNUSED const char* screen) { }
+void Platform_dynamicScreensDone(Hashtable* screens);
 
-static inline void Platform_dynamicScreensDone(ATTR_UNUSED Hashtable* screens) { }
+void Platform_updateTables(Machine* host);
 
 #endif
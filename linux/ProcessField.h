@@ -51,6 +51,13 @@ in the source distribution for its full text.
    GPU_TIME = 132,               \
    GPU_PERCENT = 133,            \
    ISCONTAINER = 134,            \
+   SPU_TIME = 135,               \
+   PERCENT_SPU = 136,            \
+   M_VMSWAP = 137,               \
+   M_HWM = 138,                  \
+   CPUS_ALLOWED = 139,           \
+   SECCOMP = 140,                \
+   NO_NEW_PRIVS = 141,           \
    // End of list
 
 
@@ -0,0 +1,309 @@
+/*
+htop - SPU.c
+(C) 2024 htop dev team
+Released under the GNU GPLv2+, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "config.h" // IWYU pragma: keep
+
+#include "linux/SPU.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Machine.h"
+#include "Macros.h"
+#include "Process.h"
+#include "ProcessTable.h"
+#include "XUtils.h"
+
+#include "linux/Platform.h" // needed for GNU/hurd to get PATH_MAX  // IWYU pragma: keep
+
+
+/* Interval to retry the owner lookup of contexts no process could be found for */
+#define SPU_RESOLVE_RETRY_MS 5000
+
+/*
+ * Documentation reference:
+ * https://www.kernel.org/doc/Documentation/filesystems/spufs/spufs.rst
+ */
+static char* SPU_findMountPoint(void) {
+   FILE* fp = fopen(PROCDIR "/self/mounts", "r");
+   if (!fp)
+      return NULL;
+
+   char* mountPoint = NULL;
+   char lineBuffer[PATH_MAX + 128];
+   while (fgets(lineBuffer, sizeof(lineBuffer), fp)) {
+      if (!String_startsWith(lineBuffer, "spufs "))
+         continue;
+
+      char* path = lineBuffer + strlen("spufs ");
+      char* end = strchr(path, ' ');
+      if (!end || !String_startsWith(end, " spufs "))
+         continue;
+
+      mountPoint = xStrndup(path, end - path);
+      break;
+   }
+
+   fclose(fp);
+   return mountPoint;
+}
+
+static SPUContextData* SPU_findContext(SPUContextData* list, const char* name) {
+   for (; list; list = list->next) {
+      if (String_eq(list->name, name))
+         return list;
+   }
+
+   return NULL;
+}
+
+static bool SPU_readContextTime(openat_arg_t mountFd, const char* name, unsigned long long int* time) {
+   char path[PATH_MAX];
+   xSnprintf(path, sizeof(path), "%s/stat", name);
+
+   char buffer[256];
+   ssize_t r = xReadfileat(mountFd, path, buffer, sizeof(buffer));
+   if (r <= 0)
+      return false;
+
+   /* <state> <user> <system> <iowait> <loaded> ..., times in milli seconds */
+   char* p = strchr(buffer, ' ');
+   if (!p)
+      return false;
+
+   char* endptr;
+   unsigned long long int user = strtoull(p, &endptr, 10);
+   if (endptr == p)
+      return false;
+
+   p = endptr;
+   unsigned long long int system = strtoull(p, &endptr, 10);
+   if (endptr == p)
+      return false;
+
+   *time = user + system;
+   return true;
+}
+
+static void SPU_updateContext(LinuxMachine* lhost, const char* name, unsigned long long int time) {
+   SPUContextData* ctx = SPU_findContext(lhost->spuContextData, name);
+   if (!ctx) {
+      ctx = xMalloc(sizeof(*ctx));
+      *ctx = (SPUContextData) {
+         .name      = xStrdup(name),
+         .pid       = 0,
+         .prevTime  = time,
+         .curTime   = time,
+         .resolveMs = 0,
+         .next      = lhost->spuContextData,
+      };
+      lhost->spuContextData = ctx;
+   }
+
+   ctx->prevTime = ctx->curTime;
+   ctx->curTime = time;
+   ctx->seen = true;
+}
+
+static void SPU_scanDirectory(LinuxMachine* lhost, openat_arg_t mountFd, DIR* dir, const char* prefix) {
+   const struct dirent* entry;
+   while ((entry = readdir(dir)) != NULL) {
+      const char* ename = entry->d_name;
+
+      if (ename[0] == '.')
+         continue;
+
+      if (entry->d_type != DT_DIR && entry->d_type != DT_UNKNOWN)
+         continue;
+
+      char name[PATH_MAX];
+      xSnprintf(name, sizeof(name), "%s%s%s", prefix, prefix[0] ? "/" : "", ename);
+
+      unsigned long long int time;
+      if (SPU_readContextTime(mountFd, name, &time)) {
+         SPU_updateContext(lhost, name, time);
+         continue;
+      }
+
+      /* Gang directories hold their member contexts one level below */
+      if (prefix[0])
+         continue;
+
+      int gangFd = Compat_openat(mountFd, name, O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+      if (gangFd < 0)
+         continue;
+
+      DIR* gangDir = fdopendir(gangFd);
+      if (!gangDir) {
+         close(gangFd);
+         continue;
+      }
+
+      SPU_scanDirectory(lhost, mountFd, gangDir, name);
+      closedir(gangDir);
+   }
+}
+
+void SPU_scanContexts(LinuxMachine* lhost) {
+   const Machine* host = &lhost->super;
+
+   lhost->spuUnresolvedContexts = 0;
+
+   if (!lhost->spufsChecked) {
+      lhost->spufsMount = SPU_findMountPoint();
+      lhost->spufsChecked = true;
+   }
+
+   if (!lhost->spufsMount)
+      return;
+
+   DIR* dir = opendir(lhost->spufsMount);
+   if (!dir)
+      return;
+
+#ifdef HAVE_OPENAT
+   openat_arg_t mountFd = dirfd(dir);
+#else
+   openat_arg_t mountFd = lhost->spufsMount;
+#endif
+
+   for (SPUContextData* ctx = lhost->spuContextData; ctx; ctx = ctx->next)
+      ctx->seen = false;
+
+   SPU_scanDirectory(lhost, mountFd, dir, "");
+
+   closedir(dir);
+
+   /* Drop destroyed contexts and schedule owner lookups */
+   SPUContextData** ctxPtr = &lhost->spuContextData;
+   while (*ctxPtr) {
+      SPUContextData* ctx = *ctxPtr;
+
+      if (!ctx->seen) {
+         *ctxPtr = ctx->next;
+         free(ctx->name);
+         free(ctx);
+         continue;
+      }
+
+      if (ctx->pid == 0 && (ctx->resolveMs == 0 || host->monotonicMs - ctx->resolveMs >= SPU_RESOLVE_RETRY_MS)) {
+         ctx->resolveMs = host->monotonicMs;
+         lhost->spuUnresolvedContexts++;
+      }
+
+      ctxPtr = &ctx->next;
+   }
+}
+
+/*
+ * Contexts are owned by the process holding the file descriptor returned by
+ * spu_create(2), which links to the context directory below the spufs mount.
+ */
+void SPU_readProcessData(LinuxProcessTable* lpt, LinuxProcess* lp, openat_arg_t procFd) {
+   LinuxMachine* lhost = (LinuxMachine*) lpt->super.super.host;
+
+   if (!lhost->spufsMount || lhost->spuUnresolvedContexts == 0)
+      return;
+
+   int fdFd = Compat_openat(procFd, "fd", O_RDONLY | O_NOFOLLOW | O_DIRECTORY | O_CLOEXEC);
+   if (fdFd == -1)
+      return;
+
+   DIR* fdDir = fdopendir(fdFd);
+   if (!fdDir) {
+      close(fdFd);
+      return;
+   }
+
+#ifndef HAVE_OPENAT
+   char fdPathBuf[32];
+   xSnprintf(fdPathBuf, sizeof(fdPathBuf), PROCDIR "/%d/fd", Process_getPid(&lp->super));
+#endif
+
+   size_t mountLen = strlen(lhost->spufsMount);
+
+   const struct dirent* entry;
+   while (lhost->spuUnresolvedContexts > 0 && (entry = readdir(fdDir)) != NULL) {
+      const char* ename = entry->d_name;
+
+      if (ename[0] == '.')
+         continue;
+
+      char target[PATH_MAX];
+#ifdef HAVE_OPENAT
+      ssize_t r = readlinkat(dirfd(fdDir), ename, target, sizeof(target) - 1);
+#else
+      ssize_t r = Compat_readlink(fdPathBuf, ename, target, sizeof(target) - 1);
+#endif
+      if (r <= 0)
+         continue;
+
+      target[r] = '\0';
+
+      if (strncmp(target, lhost->spufsMount, mountLen) != 0 || target[mountLen] != '/')
+         continue;
+
+      const char* name = target + mountLen + 1;
+      SPUContextData* ctx = SPU_findContext(lhost->spuContextData, name);
+      if (!ctx || ctx->pid != 0)
+         continue;
+
+      ctx->pid = Process_getPid(&lp->super);
+      lhost->spuUnresolvedContexts--;
+   }
+
+   closedir(fdDir);
+}
+
+void SPU_attributeContexts(LinuxProcessTable* lpt) {
+   ProcessTable* pt = &lpt->super;
+   Machine* host = pt->super.host;
+   LinuxMachine* lhost = (LinuxMachine*) host;
+   uint64_t monotonicTimeDelta = host->monotonicMs - host->prevMonotonicMs;
+
+   lhost->spuAttributedPeriod = 0;
+
+   for (SPUContextData* ctx = lhost->spuContextData; ctx; ctx = ctx->next) {
+      if (ctx->pid == 0)
+         continue;
+
+      Process* proc = ProcessTable_findProcess(pt, ctx->pid);
+      if (!proc || !proc->super.updated) {
+         /* Owner went away, the context might have been inherited */
+         ctx->pid = 0;
+         ctx->resolveMs = 0;
+         continue;
+      }
+
+      LinuxProcess* lp = (LinuxProcess*) proc;
+      unsigned long long int timeDelta = saturatingSub(ctx->curTime, ctx->prevTime);
+
+      lp->spu_time += ctx->curTime * 1000 * 1000;
+      if (monotonicTimeDelta > 0)
+         lp->spu_percent += 100.0F * timeDelta / monotonicTimeDelta;
+
+      lhost->spuAttributedPeriod += timeDelta;
+   }
+}
+
+void SPU_freeContexts(LinuxMachine* lhost) {
+   SPUContextData* ctx = lhost->spuContextData;
+   while (ctx) {
+      SPUContextData* next = ctx->next;
+      free(ctx->name);
+      free(ctx);
+      ctx = next;
+   }
+
+   lhost->spuContextData = NULL;
+   free(lhost->spufsMount);
+   lhost->spufsMount = NULL;
+}
@@ -0,0 +1,24 @@
+#ifndef HEADER_SPU
+#define HEADER_SPU
+/*
+htop - SPU.h
+(C) 2024 htop dev team
+Released under the GNU GPLv2+, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "Compat.h"
+#include "linux/LinuxMachine.h"
+#include "linux/LinuxProcess.h"
+#include "linux/LinuxProcessTable.h"
+
+
+void SPU_scanContexts(LinuxMachine* lhost);
+
+void SPU_readProcessData(LinuxProcessTable* lpt, LinuxProcess* lp, openat_arg_t procFd);
+
+void SPU_attributeContexts(LinuxProcessTable* lpt);
+
+void SPU_freeContexts(LinuxMachine* lhost);
+
+#endif /* HEADER_SPU */
@@ -0,0 +1,385 @@
+/*
+htop - linux/SmapsReader.c
+(C) 2024 htop dev team
+Released under the GNU GPLv2+, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "config.h" // IWYU pragma: keep
+
+#include "linux/SmapsReader.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#endif
+
+#include "Hashtable.h"
+#include "Macros.h"
+#include "Profile.h"
+#include "XUtils.h"
+#include "linux/LinuxMachine.h"
+
+
+/* Size of the read buffer, lines are carried over between two reads */
+#define SMAPS_READER_BUFFER_SIZE 65536
+
+typedef struct SmapsEntry_ {
+   pid_t pid;
+   uint64_t starttime;
+   uint64_t requestMs;
+   bool done;
+   bool ok;
+   SmapsUsage usage;
+} SmapsEntry;
+
+struct SmapsReader_ {
+#ifdef HAVE_PTHREAD
+   /*
+    * The thread is detached, as a read might wait for the mmap lock of a
+    * process when htop exits, so whichever side lets go last frees the reader.
+    */
+   pthread_mutex_t lock;
+   pthread_cond_t wakeup;
+   unsigned int refs;
+   bool stop;
+   bool threaded;
+   bool threadFailed;
+#endif
+
+   /* Shared state, guarded by the lock when threaded */
+   Hashtable* entries;           /* pid -> SmapsEntry, pending or done */
+   pid_t* queue;                 /* ring of the pending PIDs */
+   size_t queueSize;
+   size_t queueHead;
+   size_t queueCount;
+
+   /* Only touched by the reading side */
+   char* buffer;
+};
+
+SmapsReader* SmapsReader_new(void) {
+   SmapsReader* this = xCalloc(1, sizeof(SmapsReader));
+   this->entries = Hashtable_new(64, true);
+#ifdef HAVE_PTHREAD
+   pthread_mutex_init(&this->lock, NULL);
+   pthread_cond_init(&this->wakeup, NULL);
+   this->refs = 1;
+#endif
+   return this;
+}
+
+static void SmapsReader_free(SmapsReader* this) {
+#ifdef HAVE_PTHREAD
+   pthread_cond_destroy(&this->wakeup);
+   pthread_mutex_destroy(&this->lock);
+#endif
+   Hashtable_delete(this->entries);
+   free(this->queue);
+   free(this->buffer);
+   free(this);
+}
+
+static void SmapsReader_parseLine(const char* line, SmapsUsage* usage) {
+   /* mapping headers start with the address in lowercase hex, fields with a capital */
+   if ((*line >= '0' && *line <= '9') || (*line >= 'a' && *line <= 'f')) {
+      usage->vmas++;
+      return;
+   }
+
+   switch (*line) {
+   case 'P':
+      if (String_startsWith(line, "Pss:"))
+         usage->pss += strtol(line + 4, NULL, 10);
+      break;
+   case 'S':
+      if (String_startsWith(line, "Swap:"))
+         usage->swap += strtol(line + 5, NULL, 10);
+      else if (String_startsWith(line, "SwapPss:"))
+         usage->psswp += strtol(line + 8, NULL, 10);
+      break;
+   default:
+      break;
+   }
+}
+
+static bool SmapsReader_read(SmapsReader* this, pid_t pid, SmapsUsage* usage) {
+   *usage = (SmapsUsage) { 0 };
+
+   char path[32];
+   xSnprintf(path, sizeof(path), PROCDIR "/%d/smaps", (int)pid);
+   PROFILE_COUNT_CALLS(1);
+   int fd = open(path, O_RDONLY | O_CLOEXEC);
+   if (fd < 0)
+      return false;
+
+   if (!this->buffer)
+      this->buffer = xMalloc(SMAPS_READER_BUFFER_SIZE);
+   char* buffer = this->buffer;
+
+   size_t kept = 0;
+   for (;;) {
+      PROFILE_COUNT_CALLS(1);
+      ssize_t r = read(fd, buffer + kept, SMAPS_READER_BUFFER_SIZE - 1 - kept);
+      if (r < 0) {
+         if (errno == EINTR)
+            continue;
+
+         PROFILE_COUNT_CALLS(1);
+         close(fd);
+         return false;
+      }
+      if (r == 0)
+         break;
+
+      size_t len = kept + (size_t)r;
+      buffer[len] = '\0';
+
+      char* line = buffer;
+      char* eol;
+      while ((eol = memchr(line, '\n', (size_t)(buffer + len - line))) != NULL) {
+         *eol = '\0';
+         SmapsReader_parseLine(line, usage);
+         line = eol + 1;
+      }
+
+      kept = (size_t)(buffer + len - line);
+      if (kept == SMAPS_READER_BUFFER_SIZE - 1) {
+         /* no line is that long, but do not loop forever on one */
+         kept = 0;
+      }
+      memmove(buffer, line, kept);
+   }
+
+   if (kept) {
+      buffer[kept] = '\0';
+      SmapsReader_parseLine(buffer, usage);
+   }
+
+   PROFILE_COUNT_CALLS(1);
+   close(fd);
+   return true;
+}
+
+static void SmapsReader_finish(SmapsReader* this, pid_t pid, const SmapsUsage* usage, bool ok) {
+   SmapsEntry* entry = Hashtable_get(this->entries, (ht_key_t)pid);
+   if (!entry)
+      return;
+
+   entry->usage = *usage;
+   entry->ok = ok;
+   entry->done = true;
+}
+
+static bool SmapsReader_dequeue(SmapsReader* this, pid_t* pid) {
+   if (!this->queueCount)
+      return false;
+
+   *pid = this->queue[this->queueHead];
+   this->queueHead = (this->queueHead + 1) % this->queueSize;
+   this->queueCount--;
+   return true;
+}
+
+static void SmapsReader_enqueue(SmapsReader* this, pid_t pid) {
+   if (this->queueCount == this->queueSize) {
+      size_t size = this->queueSize ? this->queueSize * 2 : 64;
+      pid_t* queue = xMallocArray(size, sizeof(pid_t));
+      for (size_t i = 0; i < this->queueCount; i++)
+         queue[i] = this->queue[(this->queueHead + i) % this->queueSize];
+
+      free(this->queue);
+      this->queue = queue;
+      this->queueSize = size;
+      this->queueHead = 0;
+   }
+
+   this->queue[(this->queueHead + this->queueCount) % this->queueSize] = pid;
+   this->queueCount++;
+}
+
+#ifdef HAVE_PTHREAD
+
+static void SmapsReader_release(SmapsReader* this) {
+   pthread_mutex_lock(&this->lock);
+   bool last = --this->refs == 0;
+   pthread_mutex_unlock(&this->lock);
+
+   if (last)
+      SmapsReader_free(this);
+}
+
+static void* SmapsReader_thread(void* arg) {
+   SmapsReader* this = arg;
+
+   pthread_mutex_lock(&this->lock);
+   while (!this->stop) {
+      pid_t pid;
+      if (!SmapsReader_dequeue(this, &pid)) {
+         pthread_cond_wait(&this->wakeup, &this->lock);
+         continue;
+      }
+
+      /* Never hold the lock while reading, that is what the thread is for */
+      pthread_mutex_unlock(&this->lock);
+      SmapsUsage usage;
+      bool ok = SmapsReader_read(this, pid, &usage);
+      pthread_mutex_lock(&this->lock);
+
+      SmapsReader_finish(this, pid, &usage, ok);
+   }
+   pthread_mutex_unlock(&this->lock);
+
+   SmapsReader_release(this);
+   return NULL;
+}
+
+static void SmapsReader_start(SmapsReader* this) {
+   this->refs = 2;
+
+   pthread_t thread;
+   if (pthread_create(&thread, NULL, SmapsReader_thread, this) != 0) {
+      this->refs = 1;
+      this->threadFailed = true;
+      return;
+   }
+
+   pthread_detach(thread);
+   this->threaded = true;
+}
+
+#endif /* HAVE_PTHREAD */
+
+void SmapsReader_delete(SmapsReader* this) {
+   if (!this)
+      return;
+
+#ifdef HAVE_PTHREAD
+   pthread_mutex_lock(&this->lock);
+   this->stop = true;
+   pthread_cond_signal(&this->wakeup);
+   pthread_mutex_unlock(&this->lock);
+   SmapsReader_release(this);
+#else
+   SmapsReader_free(this);
+#endif
+}
+
+void SmapsReader_request(SmapsReader* this, pid_t pid, uint64_t starttime, uint64_t nowMs) {
+#ifdef HAVE_PTHREAD
+   if (!this->threaded && !this->threadFailed)
+      SmapsReader_start(this);
+
+   if (this->threaded)
+      pthread_mutex_lock(&this->lock);
+#endif
+
+   SmapsEntry* entry = Hashtable_get(this->entries, (ht_key_t)pid);
+   bool queue = false;
+   if (!entry) {
+      entry = xCalloc(1, sizeof(SmapsEntry));
+      entry->pid = pid;
+      Hashtable_put(this->entries, (ht_key_t)pid, entry);
+      queue = true;
+   } else if (entry->done) {
+      /* an untaken result of a previous process with this PID */
+      queue = true;
+   }
+
+   if (queue) {
+      entry->starttime = starttime;
+      entry->requestMs = nowMs;
+      entry->done = false;
+      SmapsReader_enqueue(this, pid);
+   }
+
+#ifdef HAVE_PTHREAD
+   if (this->threaded) {
+      if (queue)
+         pthread_cond_signal(&this->wakeup);
+      pthread_mutex_unlock(&this->lock);
+      return;
+   }
+#endif
+
+   /* no thread, read right away */
+   pid_t next;
+   while (SmapsReader_dequeue(this, &next)) {
+      SmapsUsage usage;
+      bool ok = SmapsReader_read(this, next, &usage);
+      SmapsReader_finish(this, next, &usage, ok);
+   }
+}
+
+bool SmapsReader_take(SmapsReader* this, pid_t pid, uint64_t starttime, SmapsUsage* usage, bool* ok) {
+#ifdef HAVE_PTHREAD
+   if (this->threaded)
+      pthread_mutex_lock(&this->lock);
+#endif
+
+   bool taken = false;
+   const SmapsEntry* entry = Hashtable_get(this->entries, (ht_key_t)pid);
+   if (entry && entry->done) {
+      if (entry->starttime == starttime) {
+         *usage = entry->usage;
+         *ok = entry->ok;
+         taken = true;
+      }
+      Hashtable_remove(this->entries, (ht_key_t)pid);
+   }
+
+#ifdef HAVE_PTHREAD
+   if (this->threaded)
+      pthread_mutex_unlock(&this->lock);
+#endif
+   return taken;
+}
+
+typedef struct SmapsReaderExpiry_ {
+   uint64_t nowMs;
+   pid_t* pids;
+   size_t count;
+   size_t size;
+} SmapsReaderExpiry;
+
+static void SmapsReader_collectExpired(ATTR_UNUSED ht_key_t key, void* value, void* data) {
+   const SmapsEntry* entry = value;
+   SmapsReaderExpiry* expiry = data;
+
+   if (!entry->done || expiry->nowMs - entry->requestMs < SMAPS_READER_EXPIRY)
+      return;
+
+   if (expiry->count == expiry->size) {
+      expiry->size = expiry->size ? expiry->size * 2 : 16;
+      expiry->pids = xReallocArray(expiry->pids, expiry->size, sizeof(pid_t));
+   }
+   expiry->pids[expiry->count++] = entry->pid;
+}
+
+void SmapsReader_expire(SmapsReader* this, uint64_t nowMs) {
+#ifdef HAVE_PTHREAD
+   if (this->threaded)
+      pthread_mutex_lock(&this->lock);
+#endif
+
+   SmapsReaderExpiry expiry = { .nowMs = nowMs };
+   Hashtable_foreach(this->entries, SmapsReader_collectExpired, &expiry);
+   for (size_t i = 0; i < expiry.count; i++)
+      Hashtable_remove(this->entries, (ht_key_t)expiry.pids[i]);
+   free(expiry.pids);
+
+#ifdef HAVE_PTHREAD
+   if (this->threaded)
+      pthread_mutex_unlock(&this->lock);
+#endif
+}
+
+uint64_t SmapsReader_interval(const SmapsUsage* usage) {
+   uint64_t interval = (uint64_t)usage->vmas * SMAPS_READER_MS_PER_VMA;
+   return CLAMP(interval, SMAPS_READER_MIN_INTERVAL, SMAPS_READER_MAX_INTERVAL);
+}
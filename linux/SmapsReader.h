@@ -0,0 +1,60 @@
+#ifndef HEADER_SmapsReader
+#define HEADER_SmapsReader
+/*
+htop - linux/SmapsReader.h
+(C) 2024 htop dev team
+Released under the GNU GPLv2+, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/types.h>
+
+
+/* Milliseconds added to the interval between two reads for every mapping of a process */
+#define SMAPS_READER_MS_PER_VMA 10
+
+/* Bounds of the interval between two reads of the smaps file of a process */
+#define SMAPS_READER_MIN_INTERVAL 1000
+#define SMAPS_READER_MAX_INTERVAL 60000
+
+/* Results not taken by the scan within this many milliseconds are dropped */
+#define SMAPS_READER_EXPIRY 120000
+
+typedef struct SmapsUsage_ {
+   long pss;                     /* kB */
+   long swap;                    /* kB */
+   long psswp;                   /* kB */
+   unsigned int vmas;            /* mappings summed up, the cost of the read */
+} SmapsUsage;
+
+/*
+ * Reads /proc/<pid>/smaps on kernels without smaps_rollup. The file has one
+ * block per mapping, megabytes for large processes, and reading it takes the
+ * mmap lock of the process. Where threads are available this happens in the
+ * background, so the scan only picks up finished results.
+ */
+typedef struct SmapsReader_ SmapsReader;
+
+SmapsReader* SmapsReader_new(void);
+
+void SmapsReader_delete(SmapsReader* this);
+
+/* Queues a read; requests for a process with a read pending are ignored */
+void SmapsReader_request(SmapsReader* this, pid_t pid, uint64_t starttime, uint64_t nowMs);
+
+/*
+ * Takes the finished read of a process, if any. Returns false when there is
+ * none yet, or when it belongs to a previous process with the same PID.
+ * 'ok' is cleared when the file could not be read.
+ */
+bool SmapsReader_take(SmapsReader* this, pid_t pid, uint64_t starttime, SmapsUsage* usage, bool* ok);
+
+/* Drops results of processes that are gone; called once per scan */
+void SmapsReader_expire(SmapsReader* this, uint64_t nowMs);
+
+/* Milliseconds to wait before reading the smaps file of a process again */
+uint64_t SmapsReader_interval(const SmapsUsage* usage);
+
+#endif
@@ -0,0 +1,519 @@
+/*
+htop - linux/SyscallSampler.c
+(C) 2024 htop dev team
+Released under the GNU GPLv2+, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "config.h" // IWYU pragma: keep
+
+#include "linux/SyscallSampler.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+#include "Macros.h"
+#include "Profile.h"
+#include "XUtils.h"
+
+#include "linux/Platform.h" // needed for GNU/hurd to get PATH_MAX  // IWYU pragma: keep
+
+
+/* Number of sampling passes after which the task directory is re-read for new threads */
+#define SYSCALL_SAMPLER_RESCAN_PASSES 50
+
+typedef struct SyscallSampler_Thread_ {
+   pid_t tid;
+   int syscallFd;
+   int wchanFd;
+   bool seen;
+   unsigned int samples;
+   size_t used;
+   size_t size;
+   SyscallSampler_Entry* entries;
+} SyscallSampler_Thread;
+
+static const struct {
+   long nr;
+   const char* name;
+} SyscallSampler_names[] = {
+#ifdef SYS_read
+   { SYS_read, "read" },
+#endif
+#ifdef SYS_write
+   { SYS_write, "write" },
+#endif
+#ifdef SYS_open
+   { SYS_open, "open" },
+#endif
+#ifdef SYS_openat
+   { SYS_openat, "openat" },
+#endif
+#ifdef SYS_close
+   { SYS_close, "close" },
+#endif
+#ifdef SYS_stat
+   { SYS_stat, "stat" },
+#endif
+#ifdef SYS_fstat
+   { SYS_fstat, "fstat" },
+#endif
+#ifdef SYS_newfstatat
+   { SYS_newfstatat, "newfstatat" },
+#endif
+#ifdef SYS_statx
+   { SYS_statx, "statx" },
+#endif
+#ifdef SYS_poll
+   { SYS_poll, "poll" },
+#endif
+#ifdef SYS_ppoll
+   { SYS_ppoll, "ppoll" },
+#endif
+#ifdef SYS_select
+   { SYS_select, "select" },
+#endif
+#ifdef SYS_pselect6
+   { SYS_pselect6, "pselect6" },
+#endif
+#ifdef SYS_epoll_wait
+   { SYS_epoll_wait, "epoll_wait" },
+#endif
+#ifdef SYS_epoll_pwait
+   { SYS_epoll_pwait, "epoll_pwait" },
+#endif
+#ifdef SYS_epoll_pwait2
+   { SYS_epoll_pwait2, "epoll_pwait2" },
+#endif
+#ifdef SYS_epoll_ctl
+   { SYS_epoll_ctl, "epoll_ctl" },
+#endif
+#ifdef SYS_lseek
+   { SYS_lseek, "lseek" },
+#endif
+#ifdef SYS_mmap
+   { SYS_mmap, "mmap" },
+#endif
+#ifdef SYS_mprotect
+   { SYS_mprotect, "mprotect" },
+#endif
+#ifdef SYS_munmap
+   { SYS_munmap, "munmap" },
+#endif
+#ifdef SYS_madvise
+   { SYS_madvise, "madvise" },
+#endif
+#ifdef SYS_brk
+   { SYS_brk, "brk" },
+#endif
+#ifdef SYS_ioctl
+   { SYS_ioctl, "ioctl" },
+#endif
+#ifdef SYS_pread64
+   { SYS_pread64, "pread64" },
+#endif
+#ifdef SYS_pwrite64
+   { SYS_pwrite64, "pwrite64" },
+#endif
+#ifdef SYS_readv
+   { SYS_readv, "readv" },
+#endif
+#ifdef SYS_writev
+   { SYS_writev, "writev" },
+#endif
+#ifdef SYS_sched_yield
+   { SYS_sched_yield, "sched_yield" },
+#endif
+#ifdef SYS_pause
+   { SYS_pause, "pause" },
+#endif
+#ifdef SYS_nanosleep
+   { SYS_nanosleep, "nanosleep" },
+#endif
+#ifdef SYS_clock_nanosleep
+   { SYS_clock_nanosleep, "clock_nanosleep" },
+#endif
+#ifdef SYS_accept
+   { SYS_accept, "accept" },
+#endif
+#ifdef SYS_accept4
+   { SYS_accept4, "accept4" },
+#endif
+#ifdef SYS_connect
+   { SYS_connect, "connect" },
+#endif
+#ifdef SYS_sendto
+   { SYS_sendto, "sendto" },
+#endif
+#ifdef SYS_recvfrom
+   { SYS_recvfrom, "recvfrom" },
+#endif
+#ifdef SYS_sendmsg
+   { SYS_sendmsg, "sendmsg" },
+#endif
+#ifdef SYS_recvmsg
+   { SYS_recvmsg, "recvmsg" },
+#endif
+#ifdef SYS_sendmmsg
+   { SYS_sendmmsg, "sendmmsg" },
+#endif
+#ifdef SYS_recvmmsg
+   { SYS_recvmmsg, "recvmmsg" },
+#endif
+#ifdef SYS_clone
+   { SYS_clone, "clone" },
+#endif
+#ifdef SYS_clone3
+   { SYS_clone3, "clone3" },
+#endif
+#ifdef SYS_fork
+   { SYS_fork, "fork" },
+#endif
+#ifdef SYS_execve
+   { SYS_execve, "execve" },
+#endif
+#ifdef SYS_exit
+   { SYS_exit, "exit" },
+#endif
+#ifdef SYS_exit_group
+   { SYS_exit_group, "exit_group" },
+#endif
+#ifdef SYS_wait4
+   { SYS_wait4, "wait4" },
+#endif
+#ifdef SYS_waitid
+   { SYS_waitid, "waitid" },
+#endif
+#ifdef SYS_kill
+   { SYS_kill, "kill" },
+#endif
+#ifdef SYS_rt_sigaction
+   { SYS_rt_sigaction, "rt_sigaction" },
+#endif
+#ifdef SYS_rt_sigprocmask
+   { SYS_rt_sigprocmask, "rt_sigprocmask" },
+#endif
+#ifdef SYS_rt_sigsuspend
+   { SYS_rt_sigsuspend, "rt_sigsuspend" },
+#endif
+#ifdef SYS_rt_sigtimedwait
+   { SYS_rt_sigtimedwait, "rt_sigtimedwait" },
+#endif
+#ifdef SYS_fcntl
+   { SYS_fcntl, "fcntl" },
+#endif
+#ifdef SYS_flock
+   { SYS_flock, "flock" },
+#endif
+#ifdef SYS_fsync
+   { SYS_fsync, "fsync" },
+#endif
+#ifdef SYS_fdatasync
+   { SYS_fdatasync, "fdatasync" },
+#endif
+#ifdef SYS_sync_file_range
+   { SYS_sync_file_range, "sync_file_range" },
+#endif
+#ifdef SYS_getdents64
+   { SYS_getdents64, "getdents64" },
+#endif
+#ifdef SYS_readlink
+   { SYS_readlink, "readlink" },
+#endif
+#ifdef SYS_futex
+   { SYS_futex, "futex" },
+#endif
+#ifdef SYS_futex_waitv
+   { SYS_futex_waitv, "futex_waitv" },
+#endif
+#ifdef SYS_io_getevents
+   { SYS_io_getevents, "io_getevents" },
+#endif
+#ifdef SYS_io_submit
+   { SYS_io_submit, "io_submit" },
+#endif
+#ifdef SYS_io_uring_enter
+   { SYS_io_uring_enter, "io_uring_enter" },
+#endif
+#ifdef SYS_sendfile
+   { SYS_sendfile, "sendfile" },
+#endif
+#ifdef SYS_splice
+   { SYS_splice, "splice" },
+#endif
+#ifdef SYS_msgrcv
+   { SYS_msgrcv, "msgrcv" },
+#endif
+#ifdef SYS_semop
+   { SYS_semop, "semop" },
+#endif
+#ifdef SYS_semtimedop
+   { SYS_semtimedop, "semtimedop" },
+#endif
+#ifdef SYS_mq_timedreceive
+   { SYS_mq_timedreceive, "mq_timedreceive" },
+#endif
+#ifdef SYS_getrandom
+   { SYS_getrandom, "getrandom" },
+#endif
+#ifdef SYS_inotify_add_watch
+   { SYS_inotify_add_watch, "inotify_add_watch" },
+#endif
+#ifdef SYS_unlink
+   { SYS_unlink, "unlink" },
+#endif
+#ifdef SYS_unlinkat
+   { SYS_unlinkat, "unlinkat" },
+#endif
+#ifdef SYS_rename
+   { SYS_rename, "rename" },
+#endif
+#ifdef SYS_renameat2
+   { SYS_renameat2, "renameat2" },
+#endif
+#ifdef SYS_ftruncate
+   { SYS_ftruncate, "ftruncate" },
+#endif
+#ifdef SYS_fallocate
+   { SYS_fallocate, "fallocate" },
+#endif
+#ifdef SYS_msync
+   { SYS_msync, "msync" },
+#endif
+#ifdef SYS_ptrace
+   { SYS_ptrace, "ptrace" },
+#endif
+};
+
+/* The table only covers the calls threads commonly wait in, others show their number */
+static void SyscallSampler_name(long syscall, char* buffer, size_t size) {
+   if (syscall == SYSCALL_SAMPLER_RUNNING) {
+      xSnprintf(buffer, size, "<running>");
+      return;
+   }
+   if (syscall == SYSCALL_SAMPLER_BLOCKED) {
+      xSnprintf(buffer, size, "<in kernel>");
+      return;
+   }
+
+   for (size_t i = 0; i < ARRAYSIZE(SyscallSampler_names); i++) {
+      if (SyscallSampler_names[i].nr == syscall) {
+         xSnprintf(buffer, size, "%s", SyscallSampler_names[i].name);
+         return;
+      }
+   }
+
+   xSnprintf(buffer, size, "<syscall %ld>", syscall);
+}
+
+static void SyscallSampler_closeThread(SyscallSampler_Thread* thread) {
+   if (thread->syscallFd >= 0) {
+      PROFILE_COUNT_CALLS(1);
+      close(thread->syscallFd);
+   }
+   if (thread->wchanFd >= 0) {
+      PROFILE_COUNT_CALLS(1);
+      close(thread->wchanFd);
+   }
+
+   thread->syscallFd = -1;
+   thread->wchanFd = -1;
+}
+
+static void SyscallSampler_openThread(SyscallSampler* this, SyscallSampler_Thread* thread) {
+   char path[32];
+   int taskFd = dirfd(this->taskDir);
+
+   PROFILE_COUNT_CALLS(2);
+   xSnprintf(path, sizeof(path), "%d/syscall", thread->tid);
+   thread->syscallFd = openat(taskFd, path, O_RDONLY | O_CLOEXEC);
+
+   xSnprintf(path, sizeof(path), "%d/wchan", thread->tid);
+   thread->wchanFd = openat(taskFd, path, O_RDONLY | O_CLOEXEC);
+}
+
+static void SyscallSampler_rescan(SyscallSampler* this) {
+   rewinddir(this->taskDir);
+
+   const struct dirent* entry;
+   while ((entry = readdir(this->taskDir)) != NULL) {
+      char* endptr;
+      long tid = strtol(entry->d_name, &endptr, 10);
+      if (endptr == entry->d_name || *endptr != '\0' || tid <= 0)
+         continue;
+
+      SyscallSampler_Thread* thread = Hashtable_get(this->threads, (ht_key_t) tid);
+      if (!thread) {
+         thread = xCalloc(1, sizeof(SyscallSampler_Thread));
+         thread->tid = (pid_t) tid;
+         thread->syscallFd = -1;
+         thread->wchanFd = -1;
+         Hashtable_put(this->threads, (ht_key_t) tid, thread);
+      }
+
+      /* Threads which exited keep their histogram; reopen if the TID got reused */
+      if (thread->syscallFd < 0)
+         SyscallSampler_openThread(this, thread);
+   }
+
+   this->sinceRescan = 0;
+}
+
+SyscallSampler* SyscallSampler_new(pid_t pid) {
+   char path[32];
+   xSnprintf(path, sizeof(path), PROCDIR "/%d/task", pid);
+
+   DIR* taskDir = opendir(path);
+   if (!taskDir)
+      return NULL;
+
+   SyscallSampler* this = xCalloc(1, sizeof(SyscallSampler));
+   this->pid = pid;
+   this->taskDir = taskDir;
+   this->threads = Hashtable_new(16, false);
+   SyscallSampler_rescan(this);
+   return this;
+}
+
+static void SyscallSampler_freeThread(ATTR_UNUSED ht_key_t key, void* value, ATTR_UNUSED void* userdata) {
+   SyscallSampler_Thread* thread = value;
+   SyscallSampler_closeThread(thread);
+   free(thread->entries);
+   free(thread);
+}
+
+void SyscallSampler_delete(SyscallSampler* this) {
+   if (!this)
+      return;
+
+   Hashtable_foreach(this->threads, SyscallSampler_freeThread, NULL);
+   Hashtable_delete(this->threads);
+   closedir(this->taskDir);
+   free(this);
+}
+
+static SyscallSampler_Entry* SyscallSampler_findEntry(SyscallSampler* this, SyscallSampler_Thread* thread, long syscall) {
+   for (size_t i = 0; i < thread->used; i++) {
+      if (thread->entries[i].syscall == syscall)
+         return &thread->entries[i];
+   }
+
+   if (thread->used == thread->size) {
+      thread->size = thread->size ? thread->size * 2 : 8;
+      thread->entries = xReallocArray(thread->entries, thread->size, sizeof(SyscallSampler_Entry));
+   }
+
+   SyscallSampler_Entry* entry = &thread->entries[thread->used++];
+   *entry = (SyscallSampler_Entry) {
+      .tid = thread->tid,
+      .syscall = syscall,
+   };
+   this->entryCount++;
+   return entry;
+}
+
+/*
+ * /proc/<tid>/syscall contains "running" for threads in user space, "-1 <sp> <pc>"
+ * for threads blocked in the kernel outside of a system call, and otherwise the
+ * system call number followed by its arguments. Reading it does not stop the thread.
+ */
+static void SyscallSampler_sampleThread(ATTR_UNUSED ht_key_t key, void* value, void* userdata) {
+   SyscallSampler* this = userdata;
+   SyscallSampler_Thread* thread = value;
+
+   if (thread->syscallFd < 0)
+      return;
+
+   char buffer[256];
+   PROFILE_COUNT_CALLS(1);
+   ssize_t r = pread(thread->syscallFd, buffer, sizeof(buffer) - 1, 0);
+   if (r <= 0) {
+      if (r < 0 && (errno == EACCES || errno == EPERM))
+         this->error = errno;
+
+      /* The thread exited or cannot be inspected */
+      SyscallSampler_closeThread(thread);
+      return;
+   }
+   buffer[r] = '\0';
+
+   long syscall;
+   if (String_startsWith(buffer, "running")) {
+      syscall = SYSCALL_SAMPLER_RUNNING;
+   } else {
+      char* endptr;
+      syscall = strtol(buffer, &endptr, 10);
+      if (endptr == buffer)
+         return;
+      if (syscall < 0)
+         syscall = SYSCALL_SAMPLER_BLOCKED;
+   }
+
+   thread->samples++;
+
+   SyscallSampler_Entry* entry = SyscallSampler_findEntry(this, thread, syscall);
+   entry->count++;
+
+   if (syscall == SYSCALL_SAMPLER_RUNNING || thread->wchanFd < 0)
+      return;
+
+   PROFILE_COUNT_CALLS(1);
+   r = pread(thread->wchanFd, entry->wchan, sizeof(entry->wchan) - 1, 0);
+   if (r < 0)
+      r = 0;
+   entry->wchan[r] = '\0';
+
+   /* Kernels hiding the wait channel report "0" */
+   if (String_eq(entry->wchan, "0"))
+      entry->wchan[0] = '\0';
+}
+
+int SyscallSampler_sample(SyscallSampler* this) {
+   if (this->sinceRescan >= SYSCALL_SAMPLER_RESCAN_PASSES)
+      SyscallSampler_rescan(this);
+
+   this->error = 0;
+   Hashtable_foreach(this->threads, SyscallSampler_sampleThread, this);
+
+   this->sinceRescan++;
+   return this->error;
+}
+
+typedef struct SyscallSampler_Collect_ {
+   SyscallSampler_Entry** entries;
+   size_t count;
+} SyscallSampler_Collect;
+
+static void SyscallSampler_collectThread(ATTR_UNUSED ht_key_t key, void* value, void* userdata) {
+   SyscallSampler_Collect* collect = userdata;
+   SyscallSampler_Thread* thread = value;
+
+   for (size_t i = 0; i < thread->used; i++) {
+      SyscallSampler_Entry* entry = &thread->entries[i];
+      entry->samples = thread->samples;
+      if (!entry->name[0])
+         SyscallSampler_name(entry->syscall, entry->name, sizeof(entry->name));
+      collect->entries[collect->count++] = entry;
+   }
+}
+
+SyscallSampler_Entry** SyscallSampler_collect(SyscallSampler* this, size_t* count) {
+   *count = 0;
+   if (this->entryCount == 0)
+      return NULL;
+
+   SyscallSampler_Collect collect = {
+      .entries = xMallocArray(this->entryCount, sizeof(SyscallSampler_Entry*)),
+      .count = 0,
+   };
+   Hashtable_foreach(this->threads, SyscallSampler_collectThread, &collect);
+
+   *count = collect.count;
+   return collect.entries;
+}
@@ -0,0 +1,37 @@
+#ifndef HEADER_SyscallSampler
+#define HEADER_SyscallSampler
+/*
+htop - linux/SyscallSampler.h
+(C) 2024 htop dev team
+Released under the GNU GPLv2+, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include <dirent.h>
+#include <stddef.h>
+#include <sys/types.h>
+
+#include "Hashtable.h"
+#include "TraceScreen.h"
+
+
+struct SyscallSampler_ {
+   pid_t pid;
+   DIR* taskDir;
+   Hashtable* threads;       /* tid -> SyscallSampler_Thread */
+   unsigned int sinceRescan;
+   size_t entryCount;
+   int error;                /* errno of the last failed read, 0 if none */
+};
+
+SyscallSampler* SyscallSampler_new(pid_t pid);
+
+void SyscallSampler_delete(SyscallSampler* this);
+
+/* Takes one sample of every thread; returns 0 or an errno value */
+int SyscallSampler_sample(SyscallSampler* this);
+
+/* Returns a newly allocated, unsorted array of entries, to be released with free() */
+SyscallSampler_Entry** SyscallSampler_collect(SyscallSampler* this, size_t* count);
+
+#endif /* HEADER_SyscallSampler */
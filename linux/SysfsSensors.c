@@ -0,0 +1,403 @@
+/*
+htop - linux/SysfsSensors.c
+(C) 2024 htop dev team
+Released under the GNU GPLv2+, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include "config.h" // IWYU pragma: keep
+
+#include "linux/SysfsSensors.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "Macros.h"
+#include "Profile.h"
+#include "XUtils.h"
+
+
+#define SYSCPUDIR     "/sys/devices/system/cpu"
+#define SYSSPUDIR     "/sys/devices/system/spu"
+#define SYSHWMONDIR   "/sys/class/hwmon"
+#define SYSTHERMALDIR "/sys/class/thermal"
+
+#define NO_SENSOR (-1)
+
+typedef struct SysfsSensor_ {
+   int fd;
+   int divisor;      /* 1 for degree Celsius, 1000 for milli degree Celsius */
+   double value;     /* reading of the current scan */
+} SysfsSensor;
+
+typedef struct HwmonLabel_ {
+   unsigned int index;
+   char label[32];
+} HwmonLabel;
+
+/*
+ * The sensor files are discovered once and kept open, so each scan only
+ * costs a single pread(2) per sensor. The discovery is repeated whenever
+ * the number of CPUs or SPUs changes or a reload was requested.
+ */
+static SysfsSensor* sensors;
+static size_t sensorCount;
+
+/* Sensor index per CPU and SPU, NO_SENSOR if there is none */
+static int* cpuSensors;
+static int* spuSensors;
+
+static unsigned int mappedCPUs;   /* 0 when the CPU sensors were not wanted */
+static unsigned int mappedSPUs;
+static bool haveCPUSensors;
+static bool discovered;
+
+static int SysfsSensors_add(const char* path, int divisor) {
+   PROFILE_COUNT_CALLS(1);
+   int fd = open(path, O_RDONLY | O_CLOEXEC);
+   if (fd < 0)
+      return NO_SENSOR;
+
+   sensors = xReallocArray(sensors, sensorCount + 1, sizeof(SysfsSensor));
+   sensors[sensorCount] = (SysfsSensor) {
+      .fd      = fd,
+      .divisor = divisor,
+      .value   = NAN,
+   };
+
+   return (int)sensorCount++;
+}
+
+static bool SysfsSensors_readString(const char* path, char* buffer, size_t size) {
+   ssize_t r = xReadfile(path, buffer, size);
+   if (r <= 0)
+      return false;
+
+   buffer[strcspn(buffer, "\n")] = '\0';
+   return true;
+}
+
+static int SysfsSensors_readTopology(unsigned int cpu, const char* name) {
+   char path[128];
+   char buffer[16];
+
+   xSnprintf(path, sizeof(path), SYSCPUDIR "/cpu%u/topology/%s", cpu, name);
+   if (!SysfsSensors_readString(path, buffer, sizeof(buffer)))
+      return -1;
+
+   return atoi(buffer);
+}
+
+/* Cell Broadband Engine (cbe_thermal), readings in degree Celsius */
+static void SysfsSensors_scanCell(unsigned int existingCPUs, unsigned int existingSPUs) {
+   char path[128];
+
+   if (access(SYSCPUDIR "/cpu0/thermal", F_OK) == 0) {
+      for (unsigned int i = 0; i < existingCPUs; i++) {
+         xSnprintf(path, sizeof(path), SYSCPUDIR "/cpu%u/thermal/temperature0", i);
+         cpuSensors[i] = SysfsSensors_add(path, 1);
+      }
+   }
+
+   for (unsigned int i = 0; i < existingSPUs; i++) {
+      xSnprintf(path, sizeof(path), SYSSPUDIR "/spu%u/thermal/temperature", i);
+      spuSensors[i] = SysfsSensors_add(path, 1);
+   }
+}
+
+static size_t SysfsSensors_readHwmonLabels(const char* hwmonPath, HwmonLabel** labels) {
+   DIR* dir = opendir(hwmonPath);
+   if (!dir)
+      return 0;
+
+   size_t count = 0;
+   const struct dirent* entry;
+   while ((entry = readdir(dir)) != NULL) {
+      unsigned int index;
+      int len = 0;
+      if (sscanf(entry->d_name, "temp%u_label%n", &index, &len) != 1 || len == 0 || entry->d_name[len] != '\0')
+         continue;
+
+      char path[PATH_MAX];
+      char label[32];
+      xSnprintf(path, sizeof(path), "%s/%s", hwmonPath, entry->d_name);
+      if (!SysfsSensors_readString(path, label, sizeof(label)))
+         continue;
+
+      *labels = xReallocArray(*labels, count + 1, sizeof(HwmonLabel));
+      (*labels)[count].index = index;
+      String_safeStrncpy((*labels)[count].label, label, sizeof((*labels)[count].label));
+      count++;
+   }
+
+   closedir(dir);
+   return count;
+}
+
+static int SysfsSensors_addHwmonInput(const char* hwmonPath, unsigned int index) {
+   char path[PATH_MAX];
+   xSnprintf(path, sizeof(path), "%s/temp%u_input", hwmonPath, index);
+   return SysfsSensors_add(path, 1000);
+}
+
+/* Intel coretemp: one instance per package with a sensor per physical core */
+static void SysfsSensors_scanCoretemp(const char* hwmonPath, int* packageSensors, const int* cpuPackages, const int* cpuCores, unsigned int existingCPUs) {
+   HwmonLabel* labels = NULL;
+   size_t count = SysfsSensors_readHwmonLabels(hwmonPath, &labels);
+
+   int package = -1;
+   for (size_t l = 0; l < count; l++) {
+      if (sscanf(labels[l].label, "Package id %d", &package) != 1)
+         continue;
+
+      int sensor = SysfsSensors_addHwmonInput(hwmonPath, labels[l].index);
+      for (unsigned int i = 0; i < existingCPUs; i++) {
+         if (cpuPackages[i] == package)
+            packageSensors[i] = sensor;
+      }
+      break;
+   }
+
+   for (size_t l = 0; l < count; l++) {
+      int core;
+      if (sscanf(labels[l].label, "Core %d", &core) != 1)
+         continue;
+
+      int sensor = NO_SENSOR;
+      for (unsigned int i = 0; i < existingCPUs; i++) {
+         /* Without a package sensor assume a single package */
+         if (cpuCores[i] != core || (package >= 0 && cpuPackages[i] != package))
+            continue;
+
+         if (sensor == NO_SENSOR)
+            sensor = SysfsSensors_addHwmonInput(hwmonPath, labels[l].index);
+
+         cpuSensors[i] = sensor;
+         haveCPUSensors |= sensor != NO_SENSOR;
+      }
+   }
+
+   free(labels);
+}
+
+/* AMD k10temp/zenpower: the die temperature applies to all cores of the package */
+static void SysfsSensors_scanK10temp(const char* hwmonPath, int* packageSensors, unsigned int existingCPUs) {
+   HwmonLabel* labels = NULL;
+   size_t count = SysfsSensors_readHwmonLabels(hwmonPath, &labels);
+
+   const HwmonLabel* die = NULL;
+   for (size_t l = 0; l < count; l++) {
+      if (String_eq(labels[l].label, "Tdie")) {
+         die = &labels[l];
+         break;
+      }
+
+      if (String_eq(labels[l].label, "Tctl"))
+         die = &labels[l];
+   }
+
+   int sensor = die ? SysfsSensors_addHwmonInput(hwmonPath, die->index) : NO_SENSOR;
+   for (unsigned int i = 0; sensor != NO_SENSOR && i < existingCPUs; i++) {
+      if (packageSensors[i] == NO_SENSOR)
+         packageSensors[i] = sensor;
+   }
+
+   free(labels);
+}
+
+static void SysfsSensors_scanHwmon(int* packageSensors, const int* cpuPackages, const int* cpuCores, unsigned int existingCPUs) {
+   DIR* dir = opendir(SYSHWMONDIR);
+   if (!dir)
+      return;
+
+   const struct dirent* entry;
+   while ((entry = readdir(dir)) != NULL) {
+      if (!String_startsWith(entry->d_name, "hwmon"))
+         continue;
+
+      char hwmonPath[PATH_MAX];
+      char path[PATH_MAX];
+      char name[32];
+      xSnprintf(hwmonPath, sizeof(hwmonPath), SYSHWMONDIR "/%s", entry->d_name);
+      xSnprintf(path, sizeof(path), "%s/name", hwmonPath);
+      if (!SysfsSensors_readString(path, name, sizeof(name)))
+         continue;
+
+      if (String_eq(name, "coretemp"))
+         SysfsSensors_scanCoretemp(hwmonPath, packageSensors, cpuPackages, cpuCores, existingCPUs);
+      else if (String_eq(name, "k10temp") || String_eq(name, "zenpower"))
+         SysfsSensors_scanK10temp(hwmonPath, packageSensors, existingCPUs);
+   }
+
+   closedir(dir);
+}
+
+/* Last resort: a thermal zone covering the CPU package, readings in milli degree Celsius */
+static void SysfsSensors_scanThermalZones(int* packageSensors, unsigned int existingCPUs) {
+   DIR* dir = opendir(SYSTHERMALDIR);
+   if (!dir)
+      return;
+
+   int sensor = NO_SENSOR;
+   const struct dirent* entry;
+   while (sensor == NO_SENSOR && (entry = readdir(dir)) != NULL) {
+      if (!String_startsWith(entry->d_name, "thermal_zone"))
+         continue;
+
+      char path[PATH_MAX];
+      char type[32];
+      xSnprintf(path, sizeof(path), SYSTHERMALDIR "/%s/type", entry->d_name);
+      if (!SysfsSensors_readString(path, type, sizeof(type)))
+         continue;
+
+      if (!String_eq(type, "x86_pkg_temp") && !String_startsWith(type, "cpu"))
+         continue;
+
+      xSnprintf(path, sizeof(path), SYSTHERMALDIR "/%s/temp", entry->d_name);
+      sensor = SysfsSensors_add(path, 1000);
+   }
+
+   closedir(dir);
+
+   for (unsigned int i = 0; sensor != NO_SENSOR && i < existingCPUs; i++)
+      packageSensors[i] = sensor;
+}
+
+static int* SysfsSensors_newMap(unsigned int existing) {
+   int* map = xMallocArray(MAXIMUM(existing, 1U), sizeof(int));
+   for (unsigned int i = 0; i < existing; i++)
+      map[i] = NO_SENSOR;
+
+   return map;
+}
+
+/* Only sensors that are read are kept open, e.g. none for the CPUs when libsensors covers them */
+static void SysfsSensors_discover(unsigned int existingCPUs, unsigned int existingSPUs) {
+   SysfsSensors_cleanup();
+
+   cpuSensors = SysfsSensors_newMap(existingCPUs);
+   spuSensors = SysfsSensors_newMap(existingSPUs);
+
+   SysfsSensors_scanCell(existingCPUs, existingSPUs);
+   for (unsigned int i = 0; i < existingCPUs; i++)
+      haveCPUSensors |= cpuSensors[i] != NO_SENSOR;
+
+   if (!haveCPUSensors && existingCPUs > 0) {
+      int* packageSensors = SysfsSensors_newMap(existingCPUs);
+      int* cpuPackages = xMallocArray(MAXIMUM(existingCPUs, 1U), sizeof(int));
+      int* cpuCores = xMallocArray(MAXIMUM(existingCPUs, 1U), sizeof(int));
+
+      for (unsigned int i = 0; i < existingCPUs; i++) {
+         cpuPackages[i] = SysfsSensors_readTopology(i, "physical_package_id");
+         cpuCores[i] = SysfsSensors_readTopology(i, "core_id");
+      }
+
+      SysfsSensors_scanHwmon(packageSensors, cpuPackages, cpuCores, existingCPUs);
+
+      bool havePackageSensors = false;
+      for (unsigned int i = 0; i < existingCPUs; i++)
+         havePackageSensors |= packageSensors[i] != NO_SENSOR;
+
+      if (!haveCPUSensors && !havePackageSensors)
+         SysfsSensors_scanThermalZones(packageSensors, existingCPUs);
+
+      /* Cores without a sensor of their own report the package temperature */
+      for (unsigned int i = 0; i < existingCPUs; i++) {
+         if (cpuSensors[i] == NO_SENSOR)
+            cpuSensors[i] = packageSensors[i];
+
+         haveCPUSensors |= cpuSensors[i] != NO_SENSOR;
+      }
+
+      free(cpuCores);
+      free(cpuPackages);
+      free(packageSensors);
+   }
+
+   mappedCPUs = existingCPUs;
+   mappedSPUs = existingSPUs;
+   discovered = true;
+}
+
+static void SysfsSensors_read(SysfsSensor* sensor) {
+   char buffer[24];
+   PROFILE_COUNT_CALLS(1);
+   ssize_t r = pread(sensor->fd, buffer, sizeof(buffer) - 1, 0);
+   if (r <= 0) {
+      /* e.g. the core went offline */
+      sensor->value = NAN;
+      return;
+   }
+
+   buffer[r] = '\0';
+
+   char* endp;
+   long int value = strtol(buffer, &endp, 10);
+   sensor->value = (endp == buffer) ? NAN : (double)value / sensor->divisor;
+}
+
+/* Fills the entries 1..existing, entry 0 gets the maximum temperature */
+static void SysfsSensors_fill(CPUData* data, const int* map, unsigned int existing) {
+   double maxTemp = -HUGE_VAL;
+   bool found = false;
+
+   for (unsigned int i = 0; i < existing; i++) {
+      double temp = (map[i] == NO_SENSOR) ? NAN : sensors[map[i]].value;
+      data[i + 1].temperature = temp;
+
+      if (isgreater(temp, maxTemp)) {
+         maxTemp = temp;
+         found = true;
+      }
+   }
+
+   data[0].temperature = found ? maxTemp : NAN;
+}
+
+void SysfsSensors_getTemperatures(CPUData* cpus, unsigned int existingCPUs, CPUData* spus, unsigned int existingSPUs) {
+   unsigned int wantedCPUs = cpus ? existingCPUs : 0;
+   if (!discovered || wantedCPUs != mappedCPUs || existingSPUs != mappedSPUs)
+      SysfsSensors_discover(wantedCPUs, existingSPUs);
+
+   for (size_t i = 0; i < sensorCount; i++)
+      SysfsSensors_read(&sensors[i]);
+
+   if (!cpus) {
+      /* covered by libsensors */
+   } else if (haveCPUSensors) {
+      SysfsSensors_fill(cpus, cpuSensors, existingCPUs);
+   } else {
+      for (unsigned int i = 0; i <= existingCPUs; i++)
+         cpus[i].temperature = NAN;
+   }
+
+   if (existingSPUs > 0)
+      SysfsSensors_fill(spus, spuSensors, existingSPUs);
+}
+
+void SysfsSensors_reload(void) {
+   discovered = false;
+}
+
+void SysfsSensors_cleanup(void) {
+   PROFILE_COUNT_CALLS((unsigned int)sensorCount);
+   for (size_t i = 0; i < sensorCount; i++)
+      close(sensors[i].fd);
+
+   free(sensors);
+   sensors = NULL;
+   sensorCount = 0;
+
+   free(cpuSensors);
+   cpuSensors = NULL;
+   free(spuSensors);
+   spuSensors = NULL;
+
+   haveCPUSensors = false;
+   discovered = false;
+}
@@ -0,0 +1,21 @@
+#ifndef HEADER_SysfsSensors
+#define HEADER_SysfsSensors
+/*
+htop - linux/SysfsSensors.h
+(C) 2024 htop dev team
+Released under the GNU GPLv2+, see the COPYING file
+in the source distribution for its full text.
+*/
+
+#include <stdbool.h>
+
+#include "linux/LinuxMachine.h"
+
+
+void SysfsSensors_cleanup(void);
+void SysfsSensors_reload(void);
+
+/* Fills the CPU temperatures too unless 'cpus' is NULL, with NAN if there is no sensor */
+void SysfsSensors_getTemperatures(CPUData* cpus, unsigned int existingCPUs, CPUData* spus, unsigned int existingSPUs);
+
+#endif /* HEADER_SysfsSensors */
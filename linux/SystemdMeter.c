@@ -10,8 +10,10 @@ in the source distribution for its full text.
 #include "linux/SystemdMeter.h"
 
 #include <dlfcn.h>
+#include <errno.h>
 #include <fcntl.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -19,6 +21,7 @@ in the source distribution for its full text.
 #include <sys/wait.h>
 
 #include "CRT.h"
+#include "Machine.h"
 #include "Macros.h"
 #include "Object.h"
 #include "RichString.h"
@@ -34,18 +37,33 @@ in the source distribution for its full text.
 
 #define sym_sd_bus_open_system sd_bus_open_system
 #define sym_sd_bus_open_user sd_bus_open_user
-#define sym_sd_bus_get_property_string sd_bus_get_property_string
-#define sym_sd_bus_get_property_trivial sd_bus_get_property_trivial
+#define sym_sd_bus_call_method_async sd_bus_call_method_async
+#define sym_sd_bus_match_signal_async sd_bus_match_signal_async
+#define sym_sd_bus_process sd_bus_process
+#define sym_sd_bus_message_is_method_error sd_bus_message_is_method_error
+#define sym_sd_bus_message_enter_container sd_bus_message_enter_container
+#define sym_sd_bus_message_exit_container sd_bus_message_exit_container
+#define sym_sd_bus_message_read sd_bus_message_read
+#define sym_sd_bus_message_skip sd_bus_message_skip
 #define sym_sd_bus_unref sd_bus_unref
 
 #else
 
 typedef void sd_bus;
 typedef void sd_bus_error;
+typedef void sd_bus_message;
+typedef void sd_bus_slot;
+typedef int (*sd_bus_message_handler_t)(sd_bus_message*, void*, sd_bus_error*);
 static int (*sym_sd_bus_open_system)(sd_bus**);
 static int (*sym_sd_bus_open_user)(sd_bus**);
-static int (*sym_sd_bus_get_property_string)(sd_bus*, const char*, const char*, const char*, const char*, sd_bus_error*, char**);
-static int (*sym_sd_bus_get_property_trivial)(sd_bus*, const char*, const char*, const char*, const char*, sd_bus_error*, char, void*);
+static int (*sym_sd_bus_call_method_async)(sd_bus*, sd_bus_slot**, const char*, const char*, const char*, const char*, sd_bus_message_handler_t, void*, const char*, ...);
+static int (*sym_sd_bus_match_signal_async)(sd_bus*, sd_bus_slot**, const char*, const char*, const char*, const char*, sd_bus_message_handler_t, sd_bus_message_handler_t, void*);
+static int (*sym_sd_bus_process)(sd_bus*, sd_bus_message**);
+static int (*sym_sd_bus_message_is_method_error)(sd_bus_message*, const char*);
+static int (*sym_sd_bus_message_enter_container)(sd_bus_message*, char, const char*);
+static int (*sym_sd_bus_message_exit_container)(sd_bus_message*);
+static int (*sym_sd_bus_message_read)(sd_bus_message*, const char*, ...);
+static int (*sym_sd_bus_message_skip)(sd_bus_message*, const char*);
 static sd_bus* (*sym_sd_bus_unref)(sd_bus*);
 static void* dlopenHandle = NULL;
 
@@ -54,10 +72,32 @@ static void* dlopenHandle = NULL;
 
 #define INVALID_VALUE ((unsigned int)-1)
 
+/* Milliseconds between two full property queries, not all properties announce their changes */
+#define SYSTEMD_REFRESH_INTERVAL 10000
+
+/* Milliseconds between two runs of systemctl, when the bus cannot be used */
+#define SYSTEMD_EXEC_INTERVAL 10000
+
+/* Milliseconds after which the values shown are marked with their age */
+#define SYSTEMD_STALE_AGE 15000
+
 typedef struct SystemdMeterContext {
 #if !defined(BUILD_STATIC) || defined(HAVE_LIBSYSTEMD)
    sd_bus* bus;
+   bool subscribed;           /* PropertiesChanged match installed */
+   bool callPending;          /* GetAll query in flight */
+   bool refreshRequested;     /* properties changed since the last query */
+   bool busFailed;            /* the last query failed, drop the connection */
+   uint64_t lastCallMs;
+   uint64_t busRetryMs;       /* no connection attempt before this time */
 #endif /* !BUILD_STATIC || HAVE_LIBSYSTEMD */
+   pid_t execChild;           /* running systemctl, 0 if none */
+   int execFd;                /* its output, -1 once at end of file */
+   char* execOutput;
+   size_t execOutputLen;
+   uint64_t lastExecMs;
+   uint64_t nowMs;
+   uint64_t updatedMs;        /* time the values were last refreshed, 0 if never */
    char* systemState;
    unsigned int nFailedUnits;
    unsigned int nInstalledJobs;
@@ -65,14 +105,33 @@ typedef struct SystemdMeterContext {
    unsigned int nJobs;
 } SystemdMeterContext_t;
 
-static SystemdMeterContext_t ctx_system;
-static SystemdMeterContext_t ctx_user;
+static SystemdMeterContext_t ctx_system = { .execFd = -1, .nFailedUnits = INVALID_VALUE, .nInstalledJobs = INVALID_VALUE, .nNames = INVALID_VALUE, .nJobs = INVALID_VALUE };
+static SystemdMeterContext_t ctx_user = { .execFd = -1, .nFailedUnits = INVALID_VALUE, .nInstalledJobs = INVALID_VALUE, .nNames = INVALID_VALUE, .nJobs = INVALID_VALUE };
+
+static void SystemdMeter_stopExec(SystemdMeterContext_t* ctx) {
+   if (ctx->execFd >= 0)
+      close(ctx->execFd);
+   ctx->execFd = -1;
+
+   /* systemctl exits on its own, the zombie is reaped if it already did */
+   if (ctx->execChild > 0)
+      (void) waitpid(ctx->execChild, NULL, WNOHANG);
+   ctx->execChild = 0;
+
+   free(ctx->execOutput);
+   ctx->execOutput = NULL;
+   ctx->execOutputLen = 0;
+}
 
 static void SystemdMeter_done(ATTR_UNUSED Meter* this) {
    SystemdMeterContext_t* ctx = String_eq(Meter_name(this), "SystemdUser") ? &ctx_user : &ctx_system;
 
    free(ctx->systemState);
    ctx->systemState = NULL;
+   ctx->nFailedUnits = ctx->nInstalledJobs = ctx->nNames = ctx->nJobs = INVALID_VALUE;
+   ctx->updatedMs = 0;
+
+   SystemdMeter_stopExec(ctx);
 
 #ifdef BUILD_STATIC
 # ifdef HAVE_LIBSYSTEMD
@@ -87,7 +146,7 @@ static void SystemdMeter_done(ATTR_UNUSED Meter* this) {
    }
    ctx->bus = NULL;
 
-   if (!ctx_system.systemState && !ctx_user.systemState && dlopenHandle) {
+   if (!ctx_system.bus && !ctx_user.bus && dlopenHandle) {
       dlclose(dlopenHandle);
       dlopenHandle = NULL;
    }
@@ -95,6 +154,76 @@ static void SystemdMeter_done(ATTR_UNUSED Meter* this) {
 }
 
 #if !defined(BUILD_STATIC) || defined(HAVE_LIBSYSTEMD)
+
+static const char* const busServiceName = "org.freedesktop.systemd1";
+static const char* const busObjectPath = "/org/freedesktop/systemd1";
+static const char* const busInterfaceName = "org.freedesktop.systemd1.Manager";
+static const char* const busPropertiesInterfaceName = "org.freedesktop.DBus.Properties";
+
+/* Reads the a{sv} property dictionary of a GetAll reply or PropertiesChanged signal */
+static int SystemdMeter_readProperties(SystemdMeterContext_t* ctx, sd_bus_message* m) {
+   int r = sym_sd_bus_message_enter_container(m, 'a', "{sv}");
+   if (r < 0)
+      return r;
+
+   while ((r = sym_sd_bus_message_enter_container(m, 'e', "sv")) > 0) {
+      const char* name;
+      r = sym_sd_bus_message_read(m, "s", &name);
+      if (r < 0)
+         return r;
+
+      unsigned int* counter =
+         String_eq(name, "NFailedUnits") ? &ctx->nFailedUnits :
+         String_eq(name, "NInstalledJobs") ? &ctx->nInstalledJobs :
+         String_eq(name, "NNames") ? &ctx->nNames :
+         String_eq(name, "NJobs") ? &ctx->nJobs :
+         NULL;
+
+      if (String_eq(name, "SystemState")) {
+         const char* state;
+         r = sym_sd_bus_message_read(m, "v", "s", &state);
+         if (r >= 0)
+            free_and_xStrdup(&ctx->systemState, state);
+      } else if (counter) {
+         r = sym_sd_bus_message_read(m, "v", "u", counter);
+      } else {
+         r = sym_sd_bus_message_skip(m, "v");
+      }
+      if (r < 0)
+         return r;
+
+      r = sym_sd_bus_message_exit_container(m);
+      if (r < 0)
+         return r;
+   }
+   if (r < 0)
+      return r;
+
+   return sym_sd_bus_message_exit_container(m);
+}
+
+static int SystemdMeter_onProperties(sd_bus_message* m, void* userdata, ATTR_UNUSED sd_bus_error* error) {
+   SystemdMeterContext_t* ctx = userdata;
+
+   ctx->callPending = false;
+
+   if (sym_sd_bus_message_is_method_error(m, NULL) || SystemdMeter_readProperties(ctx, m) < 0) {
+      ctx->busFailed = true;
+      return 0;
+   }
+
+   ctx->updatedMs = ctx->nowMs;
+   return 0;
+}
+
+static int SystemdMeter_onPropertiesChanged(ATTR_UNUSED sd_bus_message* m, void* userdata, ATTR_UNUSED sd_bus_error* error) {
+   SystemdMeterContext_t* ctx = userdata;
+
+   /* Changed properties may only be announced as invalidated, query them all */
+   ctx->refreshRequested = true;
+   return 0;
+}
+
 static int updateViaLib(bool user) {
    SystemdMeterContext_t* ctx = user ? &ctx_user : &ctx_system;
 #ifndef BUILD_STATIC
@@ -114,8 +243,14 @@ static int updateViaLib(bool user) {
 
       resolve(sd_bus_open_system);
       resolve(sd_bus_open_user);
-      resolve(sd_bus_get_property_string);
-      resolve(sd_bus_get_property_trivial);
+      resolve(sd_bus_call_method_async);
+      resolve(sd_bus_match_signal_async);
+      resolve(sd_bus_process);
+      resolve(sd_bus_message_is_method_error);
+      resolve(sd_bus_message_enter_container);
+      resolve(sd_bus_message_exit_container);
+      resolve(sd_bus_message_read);
+      resolve(sd_bus_message_skip);
       resolve(sd_bus_unref);
 
       #undef resolve
@@ -123,81 +258,78 @@ static int updateViaLib(bool user) {
 #endif /* !BUILD_STATIC */
 
    int r;
-   /* Connect to the system bus */
+   /* Connect to the bus; the handshake completes while processing */
    if (!ctx->bus) {
+      if (ctx->nowMs < ctx->busRetryMs)
+         return -2;
+
       if (user) {
          r = sym_sd_bus_open_user(&ctx->bus);
       } else {
          r = sym_sd_bus_open_system(&ctx->bus);
       }
-      if (r < 0)
+      if (r < 0) {
+         ctx->bus = NULL;
          goto busfailure;
+      }
+
+      ctx->subscribed = false;
+      ctx->callPending = false;
+      ctx->busFailed = false;
    }
 
-   static const char* const busServiceName = "org.freedesktop.systemd1";
-   static const char* const busObjectPath = "/org/freedesktop/systemd1";
-   static const char* const busInterfaceName = "org.freedesktop.systemd1.Manager";
-
-   r = sym_sd_bus_get_property_string(ctx->bus,
-                                      busServiceName,        /* service to contact */
-                                      busObjectPath,         /* object path */
-                                      busInterfaceName,      /* interface name */
-                                      "SystemState",         /* property name */
-                                      NULL,                  /* object to return error in */
-                                      &ctx->systemState);
-   if (r < 0)
-      goto busfailure;
+   if (!ctx->subscribed) {
+      r = sym_sd_bus_match_signal_async(ctx->bus,
+                                        NULL,                         /* floating slot, owned by the bus */
+                                        busServiceName,               /* sender */
+                                        busObjectPath,                /* object path */
+                                        busPropertiesInterfaceName,   /* interface name */
+                                        "PropertiesChanged",          /* signal name */
+                                        SystemdMeter_onPropertiesChanged,
+                                        NULL,                         /* default handling of a failed subscription */
+                                        ctx);
+      if (r < 0)
+         goto busfailure;
 
-   r = sym_sd_bus_get_property_trivial(ctx->bus,
-                                       busServiceName,       /* service to contact */
-                                       busObjectPath,        /* object path */
-                                       busInterfaceName,     /* interface name */
-                                       "NFailedUnits",       /* property name */
-                                       NULL,                 /* object to return error in */
-                                       'u',                  /* property type */
-                                       &ctx->nFailedUnits);
-   if (r < 0)
-      goto busfailure;
+      ctx->subscribed = true;
+   }
 
-   r = sym_sd_bus_get_property_trivial(ctx->bus,
-                                       busServiceName,       /* service to contact */
-                                       busObjectPath,        /* object path */
-                                       busInterfaceName,     /* interface name */
-                                       "NInstalledJobs",     /* property name */
-                                       NULL,                 /* object to return error in */
-                                       'u',                  /* property type */
-                                       &ctx->nInstalledJobs);
-   if (r < 0)
-      goto busfailure;
+   if (!ctx->callPending && (ctx->refreshRequested || !ctx->lastCallMs || ctx->nowMs >= ctx->lastCallMs + SYSTEMD_REFRESH_INTERVAL)) {
+      r = sym_sd_bus_call_method_async(ctx->bus,
+                                       NULL,                          /* floating slot, owned by the bus */
+                                       busServiceName,                /* service to contact */
+                                       busObjectPath,                 /* object path */
+                                       busPropertiesInterfaceName,    /* interface name */
+                                       "GetAll",                      /* method name */
+                                       SystemdMeter_onProperties,
+                                       ctx,
+                                       "s",                           /* argument types */
+                                       busInterfaceName);
+      if (r < 0)
+         goto busfailure;
 
-   r = sym_sd_bus_get_property_trivial(ctx->bus,
-                                       busServiceName,       /* service to contact */
-                                       busObjectPath,        /* object path */
-                                       busInterfaceName,     /* interface name */
-                                       "NNames",             /* property name */
-                                       NULL,                 /* object to return error in */
-                                       'u',                  /* property type */
-                                       &ctx->nNames);
-   if (r < 0)
-      goto busfailure;
+      ctx->callPending = true;
+      ctx->refreshRequested = false;
+      ctx->lastCallMs = ctx->nowMs;
+   }
 
-   r = sym_sd_bus_get_property_trivial(ctx->bus,
-                                       busServiceName,       /* service to contact */
-                                       busObjectPath,        /* object path */
-                                       busInterfaceName,     /* interface name */
-                                       "NJobs",              /* property name */
-                                       NULL,                 /* object to return error in */
-                                       'u',                  /* property type */
-                                       &ctx->nJobs);
-   if (r < 0)
+   /* Dispatch whatever has arrived, never wait for more */
+   do {
+      r = sym_sd_bus_process(ctx->bus, NULL);
+   } while (r > 0);
+
+   if (r < 0 || ctx->busFailed)
       goto busfailure;
 
    /* success */
    return 0;
 
 busfailure:
-   sym_sd_bus_unref(ctx->bus);
+   if (ctx->bus)
+      sym_sd_bus_unref(ctx->bus);
    ctx->bus = NULL;
+   ctx->lastCallMs = 0;
+   ctx->busRetryMs = ctx->nowMs + SYSTEMD_REFRESH_INTERVAL;
    return -2;
 
 #ifndef BUILD_STATIC
@@ -211,12 +343,82 @@ dlfailure:
 }
 #endif /* !BUILD_STATIC || HAVE_LIBSYSTEMD */
 
+static void SystemdMeter_parseShowLine(SystemdMeterContext_t* ctx, const char* line) {
+   if (String_startsWith(line, "SystemState=")) {
+      free_and_xStrdup(&ctx->systemState, line + strlen("SystemState="));
+   } else if (String_startsWith(line, "NFailedUnits=")) {
+      ctx->nFailedUnits = strtoul(line + strlen("NFailedUnits="), NULL, 10);
+   } else if (String_startsWith(line, "NNames=")) {
+      ctx->nNames = strtoul(line + strlen("NNames="), NULL, 10);
+   } else if (String_startsWith(line, "NJobs=")) {
+      ctx->nJobs = strtoul(line + strlen("NJobs="), NULL, 10);
+   } else if (String_startsWith(line, "NInstalledJobs=")) {
+      ctx->nInstalledJobs = strtoul(line + strlen("NInstalledJobs="), NULL, 10);
+   }
+}
+
+/* Collects the output of a running systemctl, without waiting for it */
+static void SystemdMeter_collectExec(SystemdMeterContext_t* ctx) {
+   while (ctx->execFd >= 0) {
+      char buffer[256];
+      ssize_t len = read(ctx->execFd, buffer, sizeof(buffer));
+      if (len < 0) {
+         if (errno == EINTR)
+            continue;
+         if (errno == EAGAIN || errno == EWOULDBLOCK)
+            return;
+      }
+      if (len <= 0) {
+         close(ctx->execFd);
+         ctx->execFd = -1;
+         break;
+      }
+
+      /* The few properties requested never come close to this */
+      if (ctx->execOutputLen + (size_t)len > 4096) {
+         SystemdMeter_stopExec(ctx);
+         return;
+      }
+
+      ctx->execOutput = xRealloc(ctx->execOutput, ctx->execOutputLen + (size_t)len + 1);
+      memcpy(ctx->execOutput + ctx->execOutputLen, buffer, (size_t)len);
+      ctx->execOutputLen += (size_t)len;
+      ctx->execOutput[ctx->execOutputLen] = '\0';
+   }
+
+   int wstatus;
+   pid_t r = waitpid(ctx->execChild, &wstatus, WNOHANG);
+   if (r == 0)
+      return;
+
+   if (r == ctx->execChild && WIFEXITED(wstatus) && WEXITSTATUS(wstatus) == 0 && ctx->execOutput) {
+      char* saveptr;
+      for (const char* line = strtok_r(ctx->execOutput, "\n", &saveptr); line; line = strtok_r(NULL, "\n", &saveptr))
+         SystemdMeter_parseShowLine(ctx, line);
+
+      ctx->updatedMs = ctx->nowMs;
+   }
+
+   ctx->execChild = 0;
+   SystemdMeter_stopExec(ctx);
+}
+
 static void updateViaExec(bool user) {
    SystemdMeterContext_t* ctx = user ? &ctx_user : &ctx_system;
 
+   if (ctx->execChild > 0) {
+      SystemdMeter_collectExec(ctx);
+      return;
+   }
+
    if (Settings_isReadonly())
       return;
 
+   if (ctx->lastExecMs && ctx->nowMs < ctx->lastExecMs + SYSTEMD_EXEC_INTERVAL)
+      return;
+
+   ctx->lastExecMs = ctx->nowMs;
+
    int fdpair[2];
    if (pipe(fdpair) < 0)
       return;
@@ -254,47 +456,19 @@ static void updateViaExec(bool user) {
    }
    close(fdpair[1]);
 
-   int wstatus;
-   if (waitpid(child, &wstatus, 0) < 0 || !WIFEXITED(wstatus) || WEXITSTATUS(wstatus) != 0) {
-      close(fdpair[0]);
-      return;
-   }
-
-   FILE* commandOutput = fdopen(fdpair[0], "r");
-   if (!commandOutput) {
-      close(fdpair[0]);
-      return;
-   }
-
-   char lineBuffer[128];
-   while (fgets(lineBuffer, sizeof(lineBuffer), commandOutput)) {
-      if (String_startsWith(lineBuffer, "SystemState=")) {
-         char* newline = strchr(lineBuffer + strlen("SystemState="), '\n');
-         if (newline) {
-            *newline = '\0';
-         }
-         free_and_xStrdup(&ctx->systemState, lineBuffer + strlen("SystemState="));
-      } else if (String_startsWith(lineBuffer, "NFailedUnits=")) {
-         ctx->nFailedUnits = strtoul(lineBuffer + strlen("NFailedUnits="), NULL, 10);
-      } else if (String_startsWith(lineBuffer, "NNames=")) {
-         ctx->nNames = strtoul(lineBuffer + strlen("NNames="), NULL, 10);
-      } else if (String_startsWith(lineBuffer, "NJobs=")) {
-         ctx->nJobs = strtoul(lineBuffer + strlen("NJobs="), NULL, 10);
-      } else if (String_startsWith(lineBuffer, "NInstalledJobs=")) {
-         ctx->nInstalledJobs = strtoul(lineBuffer + strlen("NInstalledJobs="), NULL, 10);
-      }
-   }
-
-   fclose(commandOutput);
+   (void) fcntl(fdpair[0], F_SETFL, O_NONBLOCK);
+   (void) fcntl(fdpair[0], F_SETFD, FD_CLOEXEC);
+   ctx->execChild = child;
+   ctx->execFd = fdpair[0];
+   SystemdMeter_collectExec(ctx);
 }
 
 static void SystemdMeter_updateValues(Meter* this) {
    bool user = String_eq(Meter_name(this), "SystemdUser");
    SystemdMeterContext_t* ctx = user ? &ctx_user : &ctx_system;
 
-   free(ctx->systemState);
-   ctx->systemState = NULL;
-   ctx->nFailedUnits = ctx->nInstalledJobs = ctx->nNames = ctx->nJobs = INVALID_VALUE;
+   /* Values are kept until replaced, a wedged manager only makes them age */
+   ctx->nowMs = this->host->monotonicMs;
 
 #if !defined(BUILD_STATIC) || defined(HAVE_LIBSYSTEMD)
    if (updateViaLib(user) < 0)
@@ -330,7 +504,7 @@ static int valueDigitColor(unsigned int value) {
 
 
 static void _SystemdMeter_display(ATTR_UNUSED const Object* cast, RichString* out, SystemdMeterContext_t* ctx) {
-   char buffer[16];
+   char buffer[24];
    int len;
    int color = METER_VALUE_ERROR;
 
@@ -385,6 +559,17 @@ static void _SystemdMeter_display(ATTR_UNUSED const Object* cast, RichString* ou
    RichString_appendnAscii(out, valueDigitColor(ctx->nInstalledJobs), buffer, len);
 
    RichString_appendAscii(out, CRT_colors[METER_TEXT], " jobs)");
+
+   /* Last known values of an unresponsive manager */
+   if (ctx->updatedMs && ctx->nowMs >= ctx->updatedMs + SYSTEMD_STALE_AGE) {
+      uint64_t age = (ctx->nowMs - ctx->updatedMs) / 1000;
+      if (age < 120) {
+         len = xSnprintf(buffer, sizeof(buffer), " [%us ago]", (unsigned int)age);
+      } else {
+         len = xSnprintf(buffer, sizeof(buffer), " [%um ago]", (unsigned int)MINIMUM(age / 60, 99999));
+      }
+      RichString_appendnAscii(out, CRT_colors[METER_VALUE_WARN], buffer, len);
+   }
 }
 
 static void SystemdMeter_display(ATTR_UNUSED const Object* cast, RichString* out) {
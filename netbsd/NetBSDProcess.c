@@ -229,6 +229,12 @@ void Process_delete(Object* cast) {
 }
 
 static void NetBSDProcess_rowWriteField(const Row* super, RichString* str, ProcessField field) {
+   /* Groups only sum up the fields common to all platforms */
+   if (Row_isGroup(super)) {
+      Process_writeField((const Process*) super, str, field);
+      return;
+   }
+
    const NetBSDProcess* np = (const NetBSDProcess*) super;
 
    char buffer[256]; buffer[255] = '\0';
@@ -259,6 +265,10 @@ static int NetBSDProcess_compareByKey(const Process* v1, const Process* v2, Proc
    }
 }
 
+static Row* NetBSDProcess_rowNewGroup(const Row* member, const char* key) {
+   return Process_newGroup(member, key, NetBSDProcess_new);
+}
+
 const ProcessClass NetBSDProcess_class = {
    .super = {
       .super = {
@@ -272,7 +282,11 @@ const ProcessClass NetBSDProcess_class = {
       .matchesFilter = Process_rowMatchesFilter,
       .compareByParent = Process_compareByParent,
       .sortKeyString = Process_rowGetSortKey,
-      .writeField = NetBSDProcess_rowWriteField
+      .writeField = NetBSDProcess_rowWriteField,
+      .groupKey = Process_rowGroupKey,
+      .newGroup = NetBSDProcess_rowNewGroup,
+      .accumulate = Process_rowAccumulate,
+      .resetGroup = Process_rowResetGroup
    },
    .compareByKey = NetBSDProcess_compareByKey
 };
@@ -162,6 +162,7 @@ void ProcessTable_goThroughEntries(ProcessTable* super) {
 
    for (int i = 0; i < count; i++) {
       const struct kinfo_proc2* kproc = &kprocs[i];
+      Machine_yield(host);
 
       bool preExisting = false;
       Process* proc = ProcessTable_getProcess(super, kproc->p_pid, &preExisting, NetBSDProcess_new);
@@ -204,7 +205,7 @@ void ProcessTable_goThroughEntries(ProcessTable* super) {
          NetBSDProcessTable_updateCwd(kproc, proc);
       }
 
-      if (proc->st_uid != kproc->p_uid) {
+      if (proc->st_uid != kproc->p_uid || !proc->user) {
          proc->st_uid = kproc->p_uid;
          proc->user = UsersTable_getRef(host->usersTable, proc->st_uid);
       }
@@ -47,6 +47,8 @@ in the source distribution for its full text.
 #include "MemoryMeter.h"
 #include "MemorySwapMeter.h"
 #include "Meter.h"
+#include "ProfileMeter.h"
+#include "SelfMeter.h"
 #include "Settings.h"
 #include "SignalsPanel.h"
 #include "SwapMeter.h"
@@ -164,6 +166,10 @@ const MeterClass* const Platform_meterTypes[] = {
    &MemorySwapMeter_class,
    &TasksMeter_class,
    &UptimeMeter_class,
+   &SelfMeter_class,
+#ifdef BUILD_WITH_PROFILING
+   &ProfileMeter_class,
+#endif
    &BatteryMeter_class,
    &HostnameMeter_class,
    &SysArchMeter_class,
@@ -179,6 +185,7 @@ const MeterClass* const Platform_meterTypes[] = {
    &RightCPUs4Meter_class,
    &LeftCPUs8Meter_class,
    &RightCPUs8Meter_class,
+   &CPUHeatmapMeter_class,
    &BlankMeter_class,
    &DiskIOMeter_class,
    &NetworkIOMeter_class,
@@ -348,6 +355,34 @@ FileLocks_ProcessData* Platform_getProcessLocks(pid_t pid) {
    return NULL;
 }
 
+int Platform_getOpenFiles(pid_t pid, OpenFiles_EntryCallback callback, void* context) {
+   (void)pid;
+   (void)callback;
+   (void)context;
+   return -1;
+}
+
+int Platform_newSyscallSampler(pid_t pid, SyscallSampler** sampler) {
+   (void)pid;
+   *sampler = NULL;
+   return -1;
+}
+
+void Platform_deleteSyscallSampler(SyscallSampler* sampler) {
+   (void)sampler;
+}
+
+int Platform_sampleSyscalls(SyscallSampler* sampler) {
+   (void)sampler;
+   return 0;
+}
+
+SyscallSampler_Entry** Platform_getSyscallSamples(SyscallSampler* sampler, size_t* count) {
+   (void)sampler;
+   *count = 0;
+   return NULL;
+}
+
 void Platform_getFileDescriptors(double* used, double* max) {
    Generic_getFileDescriptors_sysctl(used, max);
 }
@@ -221,6 +221,12 @@ void Process_delete(Object* cast) {
 }
 
 static void OpenBSDProcess_rowWriteField(const Row* super, RichString* str, ProcessField field) {
+   /* Groups only sum up the fields common to all platforms */
+   if (Row_isGroup(super)) {
+      Process_writeField((const Process*) super, str, field);
+      return;
+   }
+
    const OpenBSDProcess* op = (const OpenBSDProcess*) super;
 
    char buffer[256]; buffer[255] = '\0';
@@ -251,6 +257,10 @@ static int OpenBSDProcess_compareByKey(const Process* v1, const Process* v2, Pro
    }
 }
 
+static Row* OpenBSDProcess_rowNewGroup(const Row* member, const char* key) {
+   return Process_newGroup(member, key, OpenBSDProcess_new);
+}
+
 const ProcessClass OpenBSDProcess_class = {
    .super = {
       .super = {
@@ -264,7 +274,11 @@ const ProcessClass OpenBSDProcess_class = {
       .matchesFilter = Process_rowMatchesFilter,
       .compareByParent = Process_compareByParent,
       .sortKeyString = Process_rowGetSortKey,
-      .writeField = OpenBSDProcess_rowWriteField
+      .writeField = OpenBSDProcess_rowWriteField,
+      .groupKey = Process_rowGroupKey,
+      .newGroup = OpenBSDProcess_rowNewGroup,
+      .accumulate = Process_rowAccumulate,
+      .resetGroup = Process_rowResetGroup
    },
    .compareByKey = OpenBSDProcess_compareByKey
 };
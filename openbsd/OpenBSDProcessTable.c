@@ -141,6 +141,7 @@ static void OpenBSDProcessTable_scanProcs(OpenBSDProcessTable* this) {
 
    for (int i = 0; i < count; i++) {
       const struct kinfo_proc* kproc = &kprocs[i];
+      Machine_yield(host);
 
       /* Ignore main threads */
       if (kproc->p_tid != -1) {
@@ -205,7 +206,7 @@ static void OpenBSDProcessTable_scanProcs(OpenBSDProcessTable* this) {
       proc->majflt = kproc->p_uru_majflt;
       proc->nlwp = 1;
 
-      if (proc->st_uid != kproc->p_uid) {
+      if (proc->st_uid != kproc->p_uid || !proc->user) {
          proc->st_uid = kproc->p_uid;
          proc->user = UsersTable_getRef(host->usersTable, proc->st_uid);
       }
@@ -12,9 +12,13 @@ in the source distribution for its full text.
 
 #include <ctype.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 
+#include "Hashtable.h"
+#include "Macros.h"
 #include "XUtils.h"
 
 #include "pcp/Platform.h"
@@ -22,6 +26,110 @@ in the source distribution for its full text.
 
 extern Platform* pcp;
 
+/* Value sets up to this size are searched, larger ones get indexed */
+#define METRIC_INDEX_MIN_VALUES 16
+
+struct MetricIndex_ {
+   Hashtable* offsets;          /* instance -> offset + 1 in vset->vlist */
+   const pmValueSet* vset;      /* the value set the index was built from */
+};
+
+static MetricIndex* MetricIndex_new(const pmValueSet* vset) {
+   MetricIndex* this = xMalloc(sizeof(MetricIndex));
+   this->offsets = Hashtable_new(vset->numval, false);
+   this->vset = vset;
+   for (int i = 0; i < vset->numval; i++)
+      Hashtable_put(this->offsets, (ht_key_t)vset->vlist[i].inst, (void*)(uintptr_t)(i + 1));
+   return this;
+}
+
+static void MetricIndex_delete(MetricIndex* this) {
+   Hashtable_delete(this->offsets);
+   free(this);
+}
+
+static int MetricIndex_lookup(const MetricIndex* this, int inst) {
+   uintptr_t entry = (uintptr_t)Hashtable_get(this->offsets, (ht_key_t)inst);
+   return (int)entry - 1;
+}
+
+static void Metric_deleteIndex(ATTR_UNUSED ht_key_t key, void* value, ATTR_UNUSED void* data) {
+   MetricIndex_delete((MetricIndex*) value);
+}
+
+/* The indexes point into pcp->result, so they go with every fetch */
+static void Metric_clearIndexes(void) {
+   if (pcp->indexes) {
+      Hashtable_foreach(pcp->indexes, Metric_deleteIndex, NULL);
+      Hashtable_clear(pcp->indexes);
+   }
+
+   if (pcp->metricIndexes) {
+      for (size_t i = 0; i < pcp->totalMetrics; i++) {
+         if (pcp->metricIndexes[i]) {
+            MetricIndex_delete(pcp->metricIndexes[i]);
+            pcp->metricIndexes[i] = NULL;
+         }
+      }
+   }
+}
+
+void Metric_freeIndexes(void) {
+   Metric_clearIndexes();
+   if (pcp->indexes)
+      Hashtable_delete(pcp->indexes);
+   pcp->indexes = NULL;
+   free(pcp->metricIndexes);
+   pcp->metricIndexes = NULL;
+}
+
+/*
+ * Finds the offset of an instance in the value set of a metric, or -1.
+ * Metrics of one instance domain usually list their instances in the
+ * same order, so a single index per domain serves all of them - e.g.
+ * every proc.* metric for every process.  A metric whose values differ
+ * from that order gets an index of its own, built once per fetch, which
+ * keeps a lookup constant time even while processes come and go.
+ */
+static int Metric_findOffset(Metric metric, const pmValueSet* vset, int inst) {
+   pmInDom indom = pcp->descs[metric].indom;
+
+   if (indom == PM_INDOM_NULL || vset->numval < METRIC_INDEX_MIN_VALUES) {
+      for (int i = 0; i < vset->numval; i++) {
+         if (inst == vset->vlist[i].inst)
+            return i;
+      }
+      return -1;
+   }
+
+   if (!pcp->metricIndexes)
+      pcp->metricIndexes = xCalloc(pcp->totalMetrics, sizeof(MetricIndex*));
+
+   MetricIndex* index = pcp->metricIndexes[metric];
+   if (!index) {
+      if (!pcp->indexes)
+         pcp->indexes = Hashtable_new(16, false);
+
+      index = Hashtable_get(pcp->indexes, (ht_key_t)indom);
+      if (!index) {
+         index = MetricIndex_new(vset);
+         Hashtable_put(pcp->indexes, (ht_key_t)indom, index);
+      }
+   }
+
+   int offset = MetricIndex_lookup(index, inst);
+   if (offset >= 0 && offset < vset->numval && inst == vset->vlist[offset].inst)
+      return offset;
+
+   /* built from these very values, so the instance is not there */
+   if (index->vset == vset)
+      return -1;
+
+   index = MetricIndex_new(vset);
+   pcp->metricIndexes[metric] = index;
+   return MetricIndex_lookup(index, inst);
+}
+
 const pmDesc* Metric_desc(Metric metric) {
    return &pcp->descs[metric];
 }
@@ -67,12 +175,9 @@ int Metric_instanceOffset(Metric metric, int inst) {
    if (!vset || vset->numval <= 0)
       return 0;
 
-   /* search for optimal offset for subsequent inst lookups to begin */
-   for (int i = 0; i < vset->numval; i++) {
-      if (inst == vset->vlist[i].inst)
-         return i;
-   }
-   return 0;
+   /* optimal offset for subsequent inst lookups to begin */
+   int offset = Metric_findOffset(metric, vset, inst);
+   return offset >= 0 ? offset : 0;
 }
 
 static pmAtomValue* Metric_extract(Metric metric, int inst, int offset, pmValueSet* vset, pmAtomValue* atom, int type) {
@@ -100,12 +205,11 @@ pmAtomValue* Metric_instance(Metric metric, int inst, int offset, pmAtomValue* a
    if (offset >= 0 && offset < vset->numval && inst == vset->vlist[offset].inst)
       return Metric_extract(metric, inst, offset, vset, atom, type);
 
-   /* slow-path using a linear search for the requested instance */
-   for (int i = 0; i < vset->numval; i++) {
-      if (inst == vset->vlist[i].inst)
-         return Metric_extract(metric, inst, i, vset, atom, type);
-   }
-   return NULL;
+   /* slow-path using the instance index of this fetch */
+   offset = Metric_findOffset(metric, vset, inst);
+   if (offset < 0)
+      return NULL;
+   return Metric_extract(metric, inst, offset, vset, atom, type);
 }
 
 /*
@@ -161,6 +265,7 @@ void Metric_enableThreads(void) {
 }
 
 bool Metric_fetch(struct timeval* timestamp) {
+   Metric_clearIndexes();
    if (pcp->result) {
       pmFreeResult(pcp->result);
       pcp->result = NULL;
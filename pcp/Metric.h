@@ -161,6 +161,9 @@ typedef enum Metric_ {
    PCP_METRIC_COUNT             /* total metric count */
 } Metric;
 
+/* Instance identifier to offset mapping for the value set of one fetch */
+typedef struct MetricIndex_ MetricIndex;
+
 void Metric_enable(Metric metric, bool enable);
 
 bool Metric_enabled(Metric metric);
@@ -169,6 +172,8 @@ void Metric_enableThreads(void);
 
 bool Metric_fetch(struct timeval* timestamp);
 
+void Metric_freeIndexes(void);
+
 bool Metric_iterate(Metric metric, int* instp, int* offsetp);
 
 pmAtomValue* Metric_values(Metric metric, pmAtomValue* atom, int count, int type);
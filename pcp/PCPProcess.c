@@ -131,6 +131,12 @@ static double PCPProcess_totalIORate(const PCPProcess* pp) {
 }
 
 static void PCPProcess_rowWriteField(const Row* super, RichString* str, ProcessField field) {
+   /* Groups only sum up the fields common to all platforms */
+   if (Row_isGroup(super)) {
+      Process_writeField((const Process*) super, str, field);
+      return;
+   }
+
    const PCPProcess* pp = (const PCPProcess*) super;
 
    bool coloring = super->host->settings->highlightMegabytes;
@@ -291,6 +297,10 @@ static int PCPProcess_compareByKey(const Process* v1, const Process* v2, Process
    }
 }
 
+static Row* PCPProcess_rowNewGroup(const Row* member, const char* key) {
+   return Process_newGroup(member, key, PCPProcess_new);
+}
+
 const ProcessClass PCPProcess_class = {
    .super = {
       .super = {
@@ -305,6 +315,10 @@ const ProcessClass PCPProcess_class = {
       .compareByParent = Process_compareByParent,
       .sortKeyString = Process_rowGetSortKey,
       .writeField = PCPProcess_rowWriteField,
+      .groupKey = Process_rowGroupKey,
+      .newGroup = PCPProcess_rowNewGroup,
+      .accumulate = Process_rowAccumulate,
+      .resetGroup = Process_rowResetGroup,
    },
    .compareByKey = PCPProcess_compareByKey,
 };
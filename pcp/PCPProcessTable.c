@@ -365,6 +365,7 @@ static bool PCPProcessTable_updateProcesses(PCPProcessTable* this) {
 
    /* for every process ... */
    while (Metric_iterate(PCP_PROC_PID, &pid, &offset)) {
+      Machine_yield(host);
 
       bool preExisting;
       Process* proc = ProcessTable_getProcess(pt, pid, &preExisting, PCPProcess_new);
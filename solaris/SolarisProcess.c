@@ -75,6 +75,12 @@ void Process_delete(Object* cast) {
 }
 
 static void SolarisProcess_rowWriteField(const Row* super, RichString* str, ProcessField field) {
+   /* Groups only sum up the fields common to all platforms */
+   if (Row_isGroup(super)) {
+      Process_writeField((const Process*) super, str, field);
+      return;
+   }
+
    const SolarisProcess* sp = (const SolarisProcess*) super;
 
    char buffer[256]; buffer[255] = '\0';
@@ -129,6 +135,10 @@ static int SolarisProcess_compareByKey(const Process* v1, const Process* v2, Pro
    }
 }
 
+static Row* SolarisProcess_rowNewGroup(const Row* member, const char* key) {
+   return Process_newGroup(member, key, SolarisProcess_new);
+}
+
 const ProcessClass SolarisProcess_class = {
    .super = {
       .super = {
@@ -142,7 +152,11 @@ const ProcessClass SolarisProcess_class = {
       .matchesFilter = Process_rowMatchesFilter,
       .compareByParent = Process_compareByParent,
       .sortKeyString = Process_rowGetSortKey,
-      .writeField = SolarisProcess_rowWriteField
+      .writeField = SolarisProcess_rowWriteField,
+      .groupKey = Process_rowGroupKey,
+      .newGroup = SolarisProcess_rowNewGroup,
+      .accumulate = Process_rowAccumulate,
+      .resetGroup = Process_rowResetGroup
    },
    .compareByKey = SolarisProcess_compareByKey
 };
@@ -116,6 +116,8 @@ static int SolarisProcessTable_walkproc(psinfo_t* _psinfo, lwpsinfo_t* _lwpsinfo
    const Machine* host = pt->super.host;
    const SolarisMachine* shost = (const SolarisMachine*) host;
 
+   Machine_yield(host);
+
    id_t lwpid_real = _lwpsinfo->pr_lwpid;
    if (lwpid_real > 1023) {
       return 0;
@@ -163,7 +165,7 @@ static int SolarisProcessTable_walkproc(psinfo_t* _psinfo, lwpsinfo_t* _lwpsinfo
    proc->m_resident         = _psinfo->pr_rssize;  // KB
    proc->m_virt             = _psinfo->pr_size;    // KB
 
-   if (proc->st_uid != _psinfo->pr_euid) {
+   if (proc->st_uid != _psinfo->pr_euid || !proc->user) {
       proc->st_uid          = _psinfo->pr_euid;
       proc->user            = UsersTable_getRef(host->usersTable, proc->st_uid);
    }
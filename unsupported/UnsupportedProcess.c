@@ -59,6 +59,12 @@ void Process_delete(Object* cast) {
 }
 
 static void UnsupportedProcess_rowWriteField(const Row* super, RichString* str, ProcessField field) {
+   /* Groups only sum up the fields common to all platforms */
+   if (Row_isGroup(super)) {
+      Process_writeField((const Process*) super, str, field);
+      return;
+   }
+
    const UnsupportedProcess* up = (const UnsupportedProcess*) super;
 
    bool coloring = super->host->settings->highlightMegabytes;
@@ -93,6 +99,10 @@ static int UnsupportedProcess_compareByKey(const Process* v1, const Process* v2,
    }
 }
 
+static Row* UnsupportedProcess_rowNewGroup(const Row* member, const char* key) {
+   return Process_newGroup(member, key, UnsupportedProcess_new);
+}
+
 const ProcessClass UnsupportedProcess_class = {
    .super = {
       .super = {
@@ -106,7 +116,11 @@ const ProcessClass UnsupportedProcess_class = {
       .matchesFilter = Process_rowMatchesFilter,
       .compareByParent = Process_compareByParent,
       .sortKeyString = Process_rowGetSortKey,
-      .writeField = UnsupportedProcess_rowWriteField
+      .writeField = UnsupportedProcess_rowWriteField,
+      .groupKey = Process_rowGroupKey,
+      .newGroup = UnsupportedProcess_rowNewGroup,
+      .accumulate = Process_rowAccumulate,
+      .resetGroup = Process_rowResetGroup
    },
    .compareByKey = UnsupportedProcess_compareByKey
 };